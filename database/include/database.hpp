@@ -39,6 +39,7 @@ struct Fixup {
   Pointer<ResourceClass> classes;
   uint8 platform;
   uint16 numItems;
+  Array<int32> seeds;
 };
 
 struct Extension {
@@ -71,6 +72,19 @@ auto operator<=>(const revil::TitleSupport &t, const revil::TitleSupport &o) {
   return orders[idx];
 }
 
+// Minimal perfect hash tables (hash and displace)
+// Keys are distributed into seeds.numItems buckets, each bucket stores
+// a seed for the secondary hash, or a direct slot (-slot - 1)
+struct ClassMap {
+  Array<int32> seeds;
+  Array<Pointer<ResourceClass>> classes;
+};
+
+struct ExtensionMap {
+  Array<int32> seeds;
+  Array<ExtensionN> extensions;
+};
+
 struct Title {
   Pointer<Pointer<revil::TitleSupport>> support;
   SmallArray<Fixup> fixups;
@@ -90,8 +104,44 @@ struct Header {
   Array<Extension> extensions[2];
   Array<Extension4> extensions4[2];
   Array<ExtensionN> extensionsN;
+  ClassMap classMaps[NUM_PLATFORMS];
+  ExtensionMap extensionMaps[2];
 };
 
+inline uint32 PerfectHashMix(uint32 key, uint32 seed) {
+  key ^= seed * 0x9E3779B9;
+  key ^= key >> 16;
+  key *= 0x85EBCA6B;
+  key ^= key >> 13;
+  key *= 0xC2B2AE35;
+  key ^= key >> 16;
+  return key;
+}
+
+// numItems must be non zero
+inline uint32 PerfectHashSlot(uint32 key, const Array<int32> &seeds,
+                              uint32 numItems) {
+  const int32 seed =
+      seeds.begin()[PerfectHashMix(key, 0) % seeds.numItems];
+
+  if (seed < 0) {
+    return -seed - 1;
+  }
+
+  return PerfectHashMix(key, seed) % numItems;
+}
+
+// FNV-1a, used as perfect hash key for strings
+inline uint32 PerfectHashKey(std::string_view str) {
+  uint32 key = 0x811C9DC5;
+
+  for (char c : str) {
+    key = (key ^ uint8(c)) * 0x01000193;
+  }
+
+  return key;
+}
+
 inline bool operator<(const StringEntry &e, std::string_view sv) {
   if (e.size == sv.size()) {
     return std::string_view(e) < sv;
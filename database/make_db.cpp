@@ -287,6 +287,100 @@ void LoadDb() {
   }
 }
 
+struct PerfectHashTable {
+  std::vector<int32> seeds;
+  // key index for every slot
+  std::vector<uint32> slots;
+};
+
+PerfectHashTable BuildPerfectHash(const std::vector<uint32> &keys) {
+  const size_t numKeys = keys.size();
+  PerfectHashTable table;
+
+  if (numKeys == 0) {
+    return table;
+  }
+
+  const size_t numBuckets = (numKeys + 3) / 4;
+  std::vector<std::vector<uint32>> buckets(numBuckets);
+
+  for (uint32 k = 0; k < numKeys; k++) {
+    buckets[PerfectHashMix(keys[k], 0) % numBuckets].emplace_back(k);
+  }
+
+  std::vector<uint32> order(numBuckets);
+
+  for (uint32 b = 0; b < numBuckets; b++) {
+    order[b] = b;
+  }
+
+  std::stable_sort(order.begin(), order.end(), [&](uint32 b1, uint32 b2) {
+    return buckets[b1].size() > buckets[b2].size();
+  });
+
+  table.seeds.resize(numBuckets);
+  table.slots.resize(numKeys, uint32(-1));
+  size_t freeSlot = 0;
+
+  for (uint32 b : order) {
+    auto &bucket = buckets[b];
+
+    if (bucket.empty()) {
+      break;
+    }
+
+    if (bucket.size() == 1) {
+      while (table.slots[freeSlot] != uint32(-1)) {
+        freeSlot++;
+      }
+
+      table.slots[freeSlot] = bucket.front();
+      table.seeds[b] = -int32(freeSlot) - 1;
+      continue;
+    }
+
+    std::vector<uint32> bucketSlots;
+
+    for (int32 seed = 1;; seed++) {
+      if (seed == 0x1000000) {
+        throw es::RuntimeError("Cannot build perfect hash, duplicate keys?");
+      }
+
+      bucketSlots.clear();
+
+      for (uint32 k : bucket) {
+        const uint32 slot = PerfectHashMix(keys[k], seed) % numKeys;
+
+        if (table.slots[slot] != uint32(-1) ||
+            std::find(bucketSlots.begin(), bucketSlots.end(), slot) !=
+                bucketSlots.end()) {
+          break;
+        }
+
+        bucketSlots.emplace_back(slot);
+      }
+
+      if (bucketSlots.size() == bucket.size()) {
+        for (size_t i = 0; i < bucket.size(); i++) {
+          table.slots[bucketSlots[i]] = bucket[i];
+        }
+
+        table.seeds[b] = seed;
+        break;
+      }
+    }
+  }
+
+  return table;
+}
+
+void WriteSeeds(BinWritterRef wr, Array<int32> &seeds, size_t fieldOffset,
+                const PerfectHashTable &table) {
+  seeds.numItems = table.seeds.size();
+  seeds.data.varPtr = (seeds.numItems > 0) * int32(wr.Tell() - fieldOffset);
+  wr.WriteContainer(table.seeds);
+}
+
 using CompareString = decltype([](auto &i1, auto &i2) {
   if (i1.size() == i2.size()) {
     return i1 < i2;
@@ -710,9 +804,103 @@ Header DoClasses(BinWritterRef wr,
     keys++;
   }
 
+  for (uint32 v = 0; v < 2; v++) {
+    std::vector<std::string_view> extensions;
+    std::vector<uint32> keys;
+    std::vector<SmallArray<uint32>> hashes;
+
+    for (auto &[ext, cls] : sortedExtensions) {
+      SmallArray<uint32> curItem{
+          .size = 0,
+          .offset = int32(wr.Tell()),
+      };
+
+      for (auto &c : cls) {
+        if (sortedClasses.at(c).version21[v]) {
+          wr.Write(v ? MTHashV1(c) : MTHashV2(c));
+          curItem.size++;
+        }
+      }
+
+      if (curItem.size == 0) {
+        continue;
+      }
+
+      extensions.emplace_back(ext);
+      keys.emplace_back(PerfectHashKey(ext));
+      hashes.emplace_back(curItem);
+    }
+
+    auto table = BuildPerfectHash(keys);
+    auto &map = hdr.extensionMaps[v];
+    const size_t mapOffset =
+        offsetof(Header, extensionMaps[0]) + sizeof(ExtensionMap) * v;
+    WriteSeeds(wr, map.seeds, mapOffset + offsetof(ExtensionMap, seeds.data),
+               table);
+
+    map.extensions.numItems = table.slots.size();
+    map.extensions.data.varPtr =
+        wr.Tell() - (mapOffset + offsetof(ExtensionMap, extensions.data));
+
+    for (uint32 k : table.slots) {
+      std::string_view ext = extensions.at(k);
+      ExtensionN item{
+          .extension{{
+              .size = uint32(ext.size()),
+              .offset = int32(sliderOffsets.at(ext) - wr.Tell()),
+          }},
+          .hashes = hashes.at(k),
+      };
+      item.hashes.offset -= wr.Tell() + offsetof(ExtensionN, hashes);
+      wr.Write(item);
+    }
+  }
+
   return hdr;
 }
 
+void DoClassMaps(BinWritterRef wr, Header &hdr, const Header *shdr) {
+  const char *base = reinterpret_cast<const char *>(shdr);
+
+  for (uint32 p = 0; p < NUM_PLATFORMS; p++) {
+    // platform classes override common ones
+    std::map<uint32, size_t> classes;
+
+    for (auto &c : shdr->resourceClasses[0]) {
+      classes[c.hash] = reinterpret_cast<const char *>(&c) - base;
+    }
+
+    if (p > 0) {
+      for (auto &c : shdr->resourceClasses[p]) {
+        classes[c.hash] = reinterpret_cast<const char *>(&c) - base;
+      }
+    }
+
+    std::vector<uint32> keys;
+    std::vector<size_t> offsets;
+
+    for (auto &[hash, offset] : classes) {
+      keys.emplace_back(hash);
+      offsets.emplace_back(offset);
+    }
+
+    auto table = BuildPerfectHash(keys);
+    auto &map = hdr.classMaps[p];
+    const size_t mapOffset =
+        offsetof(Header, classMaps[0]) + sizeof(ClassMap) * p;
+    WriteSeeds(wr, map.seeds, mapOffset + offsetof(ClassMap, seeds.data),
+               table);
+
+    map.classes.numItems = table.slots.size();
+    map.classes.data.varPtr =
+        wr.Tell() - (mapOffset + offsetof(ClassMap, classes.data));
+
+    for (uint32 k : table.slots) {
+      wr.Write(Pointer<ResourceClass>{int32(offsets.at(k) - wr.Tell())});
+    }
+  }
+}
+
 size_t DoSupport(BinWritterRef wr,
                  const std::map<std::string_view, uint32> &sliderOffsets) {
   std::map<TitleSupport, uint32> supportPalette;
@@ -860,15 +1048,22 @@ DoTitleFixups(BinWritterRef wr, size_t indicesBegin, const Header *hdr,
     std::vector<Fixup> platformFixups;
 
     for (auto &[plt, fix] : fixups) {
-      std::sort(fix.begin(), fix.end(),
-                [](auto &c1, auto &c2) { return c1.hash < c2.hash; });
+      std::vector<uint32> keys;
+
+      for (auto &c : fix) {
+        keys.emplace_back(c.hash);
+      }
+
+      auto table = BuildPerfectHash(keys);
       platformFixups.emplace_back(Fixup{
           .classes{.varPtr = int32(wr.Tell())},
           .platform = uint8(plt),
           .numItems = uint16(fix.size()),
+          .seeds{},
       });
 
-      for (auto &c : fix) {
+      for (uint32 k : table.slots) {
+        ResourceClass c = fix.at(k);
         const int32 namePtrOffset = offsetof(ResourceClass, name) + wr.Tell();
         c.name.offset -= namePtrOffset;
         const int32 extPtrOffset =
@@ -877,12 +1072,15 @@ DoTitleFixups(BinWritterRef wr, size_t indicesBegin, const Header *hdr,
 
         wr.Write(c);
       }
+
+      WriteSeeds(wr, platformFixups.back().seeds, 0, table);
     }
 
     const int32 fixupsBegin = wr.Tell();
 
     for (auto &f : platformFixups) {
       f.classes.varPtr -= wr.Tell();
+      f.seeds.data.varPtr -= wr.Tell() + offsetof(Fixup, seeds.data);
       wr.Write(f);
     }
 
@@ -988,21 +1186,15 @@ void ValidateDb(const Header *shdr) {
 
           for (auto &f : title.fixups) {
             if (f.platform == p) {
-              [&] {
-                const ResourceClass *fClasses = f.classes.operator->();
-
-                for (size_t i = 0; i < f.numItems; i++) {
-                  if (fClasses[i].hash == hash) {
-                    if (std::string_view(fClasses[i].extension) !=
-                        c.extension) {
-                      throw es::RuntimeError("Validation error");
-                    }
-                    found = true;
-                    return;
-                  }
+              const ResourceClass &fClass = f.classes.operator->()
+                  [PerfectHashSlot(hash, f.seeds, f.numItems)];
+
+              if (fClass.hash == hash) {
+                if (std::string_view(fClass.extension) != c.extension) {
+                  throw es::RuntimeError("Validation error");
                 }
-                return;
-              }();
+                found = true;
+              }
             }
           }
 
@@ -1025,6 +1217,13 @@ void ValidateDb(const Header *shdr) {
             throw es::RuntimeError("Validation error");
           }
 
+          if (auto &map = shdr->classMaps[p];
+              map.classes.begin()[PerfectHashSlot(hash, map.seeds,
+                                                  map.classes.numItems)]
+                  ->hash != hash) {
+            throw es::RuntimeError("Validation error");
+          }
+
           [&] {
             for (auto cf :
                  ClassesFromExtension(*shdr, c.extension, d.version1)) {
@@ -1035,6 +1234,23 @@ void ValidateDb(const Header *shdr) {
 
             throw es::RuntimeError("Validation error");
           }();
+
+          [&] {
+            auto &map = shdr->extensionMaps[d.version1];
+            const ExtensionN &ext = map.extensions.begin()[PerfectHashSlot(
+                PerfectHashKey(c.extension), map.seeds,
+                map.extensions.numItems)];
+
+            if (std::string_view(ext.extension) == c.extension) {
+              for (auto cf : ext.hashes) {
+                if (cf == hash) {
+                  return;
+                }
+              }
+            }
+
+            throw es::RuntimeError("Validation error");
+          }();
         }
       }
     }
@@ -1067,10 +1283,13 @@ int main() {
   wr.Write(hdr);
   wr.Pop();
 
-  auto titleOffsets = DoTitleFixups(
-      wr, indicesBegin,
-      reinterpret_cast<const Header *>(str.rdbuf()->view().data()),
-      sliderOffsets);
+  // writer might reallocate stream buffer, lookup from a copy
+  const std::string classesSnapshot(str.rdbuf()->view());
+  const Header *shdr =
+      reinterpret_cast<const Header *>(classesSnapshot.data());
+  DoClassMaps(wr, hdr, shdr);
+
+  auto titleOffsets = DoTitleFixups(wr, indicesBegin, shdr, sliderOffsets);
 
   std::map<std::string_view, size_t, CompareString> titles;
 
@@ -23,6 +23,7 @@
 #include "spike/io/bincore_fwd.hpp"
 #include <functional>
 #include <set>
+#include <span>
 
 namespace revil {
 struct ArcExtractContext : AppExtractContext {
@@ -44,4 +45,7 @@ EnumerateArchive(BinReaderRef_e rd, Platform platform, std::string_view title,
                  std::function<AppExtractContext *()> demandContext,
                  const std::set<uint32> &classFilter);
 size_t RE_EXTERN CompressZlib(std::string_view inBuffer, std::string &outBuffer, int windowSize, int level);
+// Returns number of inflated bytes
+size_t RE_EXTERN DecompressZlib(std::string_view inBuffer,
+                                std::span<char> outBuffer);
 } // namespace revil
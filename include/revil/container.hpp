@@ -0,0 +1,69 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "settings.hpp"
+#include "spike/app_context.hpp"
+#include "spike/io/stat.hpp"
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace revil {
+enum class ContainerCodec : uint8 {
+  Stored,
+  LZX,
+  Zlib,
+};
+
+struct ContainerEntry {
+  std::string path;
+  size_t offset = 0;
+  size_t size = 0;
+  // Used only by compressed entries
+  size_t uncompressedSize = 0;
+  ContainerCodec codec = ContainerCodec::Stored;
+  uint8 lzxWindowBits = 17;
+  // Checked against CRC32Update(0xFFFFFFFF, uncompressed data)
+  bool verifyCrc = false;
+  uint32 crc = 0;
+};
+
+// Input file of context, mapped when it's a plain file
+// Packed inputs are read into memory
+struct RE_EXTERN ContainerSource {
+  es::MappedFile mapped;
+  std::string buffer;
+  std::string_view data;
+
+  explicit ContainerSource(AppContext *ctx);
+  // Takes ownership of already decoded data
+  explicit ContainerSource(std::string &&decoded);
+  // Data view points into instance
+  ContainerSource(const ContainerSource &) = delete;
+};
+
+// Sends entries to extract context in table order, generates folders
+// Stored entries are sent directly from data, compressed entries are
+// decompressed and checksums verified in parallel batches
+// Throws if any entry is out of data bounds or its uncompressed size exceeds
+// maximal compression ratio, CRC mismatches are reported
+// Returns number of entries that failed CRC check
+size_t RE_EXTERN ExtractContainer(std::string_view data,
+                                  std::span<const ContainerEntry> entries,
+                                  AppExtractContext *ectx);
+} // namespace revil
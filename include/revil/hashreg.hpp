@@ -36,9 +36,38 @@ std::string_view RE_EXTERN GetClassName(uint32 hash);
 std::span<const uint32> RE_EXTERN GetHash(std::string_view extension,
                                           std::string_view title,
                                           Platform platform = Platform::Win32);
+struct Fixup;
+
+// Title and platform resolved once for repeated lookups
+class TitleHandle {
+public:
+  const TitleSupport *support = nullptr;
+  Platform platform = Platform::Win32;
+
+private:
+  friend struct TitleHandleAccess;
+  const Fixup *fixup = nullptr;
+};
+
+// Empty title yields handle with common registry only
+TitleHandle RE_EXTERN ResolveTitle(std::string_view title,
+                                   Platform platform = Platform::Win32);
+std::string_view RE_EXTERN GetExtension(uint32 hash, const TitleHandle &title);
+std::span<const uint32> RE_EXTERN GetHash(std::string_view extension,
+                                          const TitleHandle &title);
+
 using TitleCallback = std::function<void(std::string_view)>;
 void RE_EXTERN GetTitles(TitleCallback cb);
 
 uint32 RE_EXTERN MTHashV1(std::string_view text);
+// Hashes min(texts.size(), hashes.size()) items
+void RE_EXTERN MTHashV1(std::span<const std::string_view> texts,
+                        std::span<uint32> hashes);
 uint32 RE_EXTERN MTHashV2(std::string_view text);
+// Hashes min(texts.size(), hashes.size()) items
+void RE_EXTERN MTHashV2(std::span<const std::string_view> texts,
+                        std::span<uint32> hashes);
+// CRC32 (0xEDB88320) register update without pre and post inversion
+// CRC32Update(0xFFFFFFFF, data) == ~crc32b(0, data)
+uint32 RE_EXTERN CRC32Update(uint32 crc, std::string_view data);
 }; // namespace revil
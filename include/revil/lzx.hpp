@@ -0,0 +1,29 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "settings.hpp"
+#include "spike/util/supercore.hpp"
+#include <span>
+#include <string_view>
+
+namespace revil {
+// Decompresses XMemCompress (framed LZX) stream, fills whole output
+// Decoder states are pooled, function can be called from multiple threads
+void RE_EXTERN DecompressLZX(std::string_view input, std::span<char> output,
+                             uint32 windowBits = 17);
+} // namespace revil
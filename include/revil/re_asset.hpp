@@ -18,7 +18,9 @@
 #pragma once
 #include "spike/io/bincore_fwd.hpp"
 #include "settings.hpp"
+#include "spike/uni/motion.hpp"
 #include <memory>
+#include <span>
 #include <string>
 
 namespace revil {
@@ -44,4 +46,22 @@ public:
 private:
   std::unique_ptr<REAssetImpl> i;
 };
+
+struct REMotionExportSettings {
+  // Maximal absolute error of every encoded component
+  float positionTolerance = 0.0001f;
+  float rotationTolerance = 0.00005f;
+  float scaleTolerance = 0.0001f;
+};
+
+// Writes mot.78, tracks are resampled at motion's frame rate
+// Every curve uses smallest codec within tolerance
+void RE_EXTERN SaveREMotion(BinWritterRef wr, const uni::Motion &motion,
+                            const REMotionExportSettings &settings = {});
+
+// Writes motlist.99 with embedded mot.78 motions
+void RE_EXTERN SaveREMotionList(BinWritterRef wr,
+                                std::span<const uni::Motion *const> motions,
+                                std::string_view name,
+                                const REMotionExportSettings &settings = {});
 } // namespace revil
@@ -18,8 +18,10 @@
 #pragma once
 #include "spike/io/bincore_fwd.hpp"
 #include "spike/util/pugi_fwd.hpp"
+#include "platform.hpp"
 #include "settings.hpp"
 #include <memory>
+#include <string_view>
 
 namespace revil {
 class SDLImpl;
@@ -27,6 +29,12 @@ class SDLImpl;
 class RE_EXTERN SDL {
 public:
   void Load(BinReaderRef_e rd);
+  // Zero copy, read-only load for little endian schedulers
+  // data must outlive SDL instance, pointers are resolved on access
+  void LoadView(std::string_view data);
+  // Auto will write original scheduler data
+  // Otherwise scheduler is directly converted into platform's layout
+  void Save(BinWritterRef wr, Platform platform = Platform::Auto) const;
   void ToXML(pugi::xml_node node) const;
 
   SDL();
@@ -0,0 +1,48 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "settings.hpp"
+#include "spike/io/bincore_fwd.hpp"
+#include "spike/util/supercore.hpp"
+#include <span>
+#include <string_view>
+
+namespace revil {
+// DD:Online SNGW (obfuscated Ogg) cipher
+// Key repeats every 4 bytes, offset is position of input within file,
+// so files can be processed in arbitrary blocks
+// Output must hold input.size() bytes, can be the same as input
+void RE_EXTERN EncryptSNGW(std::string_view input, char *output,
+                           size_t offset = 0);
+void RE_EXTERN DecryptSNGW(std::string_view input, char *output,
+                           size_t offset = 0);
+
+// Checks header of whole file, encrypted header decrypts to zero
+bool RE_EXTERN IsSNGWFile(std::string_view data, bool encrypted);
+
+// Whole file helpers, handle OggS header, in place
+// Returns false if data are not decryptable SNGW
+bool RE_EXTERN DecryptSNGWFile(std::span<char> data);
+void RE_EXTERN EncryptSNGWFile(std::span<char> data);
+
+// Whole file helpers, handle OggS header, input is left untouched
+// Blocks are processed in parallel batches, batches are streamed to output
+// Header must be checked by caller, see IsSNGWFile
+void RE_EXTERN DecryptSNGWFile(std::string_view input, BinWritterRef output);
+void RE_EXTERN EncryptSNGWFile(std::string_view input, BinWritterRef output);
+} // namespace revil
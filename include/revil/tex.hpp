@@ -21,7 +21,9 @@
 #include "spike/app_context.hpp"
 #include "platform.hpp"
 #include "settings.hpp"
+#include <span>
 #include <string>
+#include <string_view>
 
 namespace revil {
 struct RE_EXTERN TEX {
@@ -30,7 +32,34 @@ struct RE_EXTERN TEX {
   std::string buffer;
   std::vector<uint32> offsets;
   float harmonics[27];
+  // Position and size of texel data within loaded stream, offsets are
+  // relative to dataOffset
+  uint32 dataOffset = 0;
+  uint32 dataSize = 0;
 
   void Load(BinReaderRef_e rd, Platform platform = Platform::Auto);
+  // Loads header and offsets only, buffer is left empty
+  // (except for HFS wrapped textures)
+  // Use ReadMip or MipView to fetch individual mipmaps afterwards
+  void LoadHeader(BinReaderRef_e rd, Platform platform = Platform::Auto);
+  size_t MipSize(uint32 face, uint32 mip) const;
+  // Reads mipmap from the same stream the header was loaded from
+  void ReadMip(BinReaderRef_e rd, uint32 face, uint32 mip,
+               std::span<char> out) const;
+  // Returns mipmap range within mapped or in memory file
+  std::string_view MipView(std::string_view file, uint32 face,
+                           uint32 mip) const;
+  // Supported versions: 0x97 - 0x9D, 0xA0, 0xA3, 0xA5, 0xA6
+  // buffer holds linear texel data for every face and mip (face major),
+  // offsets can be left empty for tightly packed data
+  // Data are tiled for given platform, unless ctx.baseFormat.tile is set
+  void Save(BinWritterRef_e wr, uint16 version,
+            Platform platform = Platform::Win32) const;
+  // Generates mipmaps from top level of every face
+  // Only linear 8bit uncompressed formats are supported, 0 for full chain
+  void GenerateMipmaps(uint8 numMips = 0);
+  // Computes L2 spherical harmonics (RGB per coefficient) from top level
+  // Only linear RGBA8 cubemaps are supported
+  void ComputeHarmonics();
 };
 } // namespace revil
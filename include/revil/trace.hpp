@@ -0,0 +1,58 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "settings.hpp"
+#include "spike/util/supercore.hpp"
+#include <iosfwd>
+
+namespace revil {
+#ifdef REVIL_TRACING
+// Records wall time of enclosing scope under given stage name
+// Stage must be string literal, only pointer is stored
+class RE_EXTERN TraceZone {
+public:
+  explicit TraceZone(const char *stage, size_t bytes = 0);
+  ~TraceZone();
+  TraceZone(const TraceZone &) = delete;
+  TraceZone &operator=(const TraceZone &) = delete;
+
+  void Bytes(size_t bytes_) { bytes = bytes_; }
+
+private:
+  const char *stage;
+  size_t bytes;
+  uint64 begin;
+};
+#else
+class TraceZone {
+public:
+  explicit constexpr TraceZone(const char *, size_t = 0) {}
+  constexpr void Bytes(size_t) {}
+};
+#endif
+
+// Recording is enabled at startup when REVIL_TRACE=<path> is set,
+// Chrome trace is written into path and summary into stderr at exit
+void RE_EXTERN TraceEnable(bool enable);
+bool RE_EXTERN TraceEnabled();
+// chrome://tracing or ui.perfetto.dev compatible JSON
+void RE_EXTERN TraceWriteChrome(std::ostream &str);
+// Per stage table of calls, total time and throughput
+void RE_EXTERN TraceWriteSummary(std::ostream &str);
+void RE_EXTERN TraceClear();
+} // namespace revil
@@ -17,112 +17,19 @@
 
 #include "revil/arc.hpp"
 #include "arc.hpp"
+#include "compression.hpp"
 #include "hfs.hpp"
 #include "revil/hashreg.hpp"
+#include "revil/lzx.hpp"
+#include "revil/trace.hpp"
 #include "spike/crypto/blowfish.h"
 #include "spike/io/fileinfo.hpp"
 #include "spike/master_printer.hpp"
+#include <algorithm>
 #include <set>
 
-#include "lzx.h"
-#include "mspack.h"
 #include "zlib.h"
 
-#pragma region XMemDecompress
-
-struct mspack_file {
-  uint8 *buffer;
-  uint32 bufferSize;
-  uint32 position;
-  uint32 rest;
-};
-
-// https://github.com/gildor2/UEViewer/blob/master/Unreal/UnCoreCompression.cpp#L90
-static int mspack_read(mspack_file *file, void *buffer, int bytes) {
-  if (!file->rest) {
-    // read block header
-    if (file->buffer[file->position] == 0xFF) {
-      // [0]   = FF
-      // [1,2] = uncompressed block size
-      // [3,4] = compressed block size
-      file->rest = (file->buffer[file->position + 3] << 8) |
-                   file->buffer[file->position + 4];
-      file->position += 5;
-    } else {
-      // [0,1] = compressed size
-      file->rest = (file->buffer[file->position + 0] << 8) |
-                   file->buffer[file->position + 1];
-      file->position += 2;
-    }
-
-    if (file->rest > file->bufferSize - file->position) {
-      file->rest = file->bufferSize - file->position;
-    }
-  }
-
-  if (bytes > file->rest) {
-    bytes = file->rest;
-  }
-
-  if (bytes <= 0) {
-    return 0;
-  }
-
-  memcpy(buffer, file->buffer + file->position, bytes);
-  file->position += bytes;
-  file->rest -= bytes;
-
-  return bytes;
-}
-
-static int mspack_write(mspack_file *file, void *buffer, int bytes) {
-  if (bytes <= 0) {
-    return 0;
-  }
-
-  memcpy(file->buffer + file->position, buffer, bytes);
-  file->position += bytes;
-  return bytes;
-}
-
-static mspack_system mspackSystem{
-    nullptr,                                                     // open
-    nullptr,                                                     // close
-    mspack_read,                                                 // read
-    mspack_write,                                                // write
-    nullptr,                                                     // seek
-    nullptr,                                                     // tell
-    nullptr,                                                     // message
-    [](mspack_system *, size_t bytes) { return malloc(bytes); }, // alloc
-    free,                                                        // free
-    [](void *src, void *dst, size_t bytes) { memcpy(dst, src, bytes); }, // copy
-};
-
-static void DecompressLZX(char *inBuffer, uint32 compressedSize,
-                          char *outBuffer, uint32 uncompressedSize,
-                          uint32 wBits) {
-  mspack_file inStream{};
-  mspack_file outStream{};
-  inStream.buffer = reinterpret_cast<uint8 *>(inBuffer);
-  inStream.bufferSize = compressedSize;
-  outStream.buffer = reinterpret_cast<uint8 *>(outBuffer);
-  outStream.bufferSize = uncompressedSize;
-
-  lzxd_stream *lzxd = lzxd_init(&mspackSystem, &inStream, &outStream, wBits, 0,
-                                1 << wBits, uncompressedSize, false);
-
-  int retVal = lzxd_decompress(lzxd, uncompressedSize);
-
-  if (retVal != MSPACK_ERR_OK) {
-    throw std::runtime_error("LZX decompression error " +
-                             std::to_string(retVal));
-  }
-
-  lzxd_free(lzxd);
-}
-
-#pragma endregion
-
 auto ReadARCC(BinReaderRef_e rd, BlowfishEncoder &enc) {
   ARC hdr;
   rd.Read(hdr);
@@ -147,6 +54,7 @@ void revil::EnumerateArchive(BinReaderRef_e rd, Platform platform,
                              std::string_view title,
                              std::function<AppExtractContext *()> demandContext,
                              const std::set<uint32> &classFilter) {
+  TraceZone zone("arc.enumerate");
   uint32 id;
   rd.Push();
   rd.Read(id);
@@ -175,6 +83,7 @@ void revil::EnumerateArchive(BinReaderRef_e rd, Platform platform,
   }
 
   BlowfishEncoder enc;
+  const revil::TitleHandle titleHandle = revil::ResolveTitle(title, platform);
 
   auto WriteFiles = [&](auto &files) {
     auto ectx = demandContext();
@@ -194,11 +103,27 @@ void revil::EnumerateArchive(BinReaderRef_e rd, Platform platform,
 
     std::string inBuffer;
     std::string outBuffer;
-    [&inBuffer, &outBuffer, &files] {
+    size_t readBytes = 0;
+    [&inBuffer, &outBuffer, &files, streamSize = rd.GetSize()] {
       size_t maxSize = 0;
       size_t maxSizeUnc = 0;
 
+      // Buffers are sized from table, so entries must be backed by stream
       for (auto &f : files) {
+        if (!f.compressedSize) {
+          continue;
+        }
+
+        if (f.offset > streamSize ||
+            f.compressedSize > streamSize - f.offset) {
+          throw es::RuntimeError("ARC entry out of file bounds");
+        }
+
+        if (size_t(f.uncompressedSize) / MAX_COMPRESSION_RATIO >
+            f.compressedSize) {
+          throw es::RuntimeError("ARC entry size out of bounds");
+        }
+
         if (f.uncompressedSize > maxSizeUnc) {
           maxSizeUnc = f.uncompressedSize;
         }
@@ -216,7 +141,24 @@ void revil::EnumerateArchive(BinReaderRef_e rd, Platform platform,
       outBuffer.resize(maxSizeUnc);
     }();
 
+    // Entries can share payload, walking them by offset puts such entries
+    // next to each other, so shared data is decompressed only once
+    using FileType = typename std::decay_t<decltype(files)>::value_type;
+    std::vector<const FileType *> sortedFiles;
+    sortedFiles.reserve(files.size());
+
     for (auto &f : files) {
+      sortedFiles.push_back(&f);
+    }
+
+    std::stable_sort(sortedFiles.begin(), sortedFiles.end(),
+                     [](auto *a, auto *b) { return a->offset < b->offset; });
+
+    const FileType *lastFile = nullptr;
+
+    for (auto *fp : sortedFiles) {
+      auto &f = *fp;
+
       if (!f.compressedSize) {
         continue;
       }
@@ -225,44 +167,54 @@ void revil::EnumerateArchive(BinReaderRef_e rd, Platform platform,
         continue;
       }
 
-      rd.Seek(f.offset);
+      const bool sharedPayload =
+          lastFile && lastFile->offset == f.offset &&
+          lastFile->compressedSize == f.compressedSize &&
+          uint32(lastFile->uncompressedSize) == uint32(f.uncompressedSize);
+
+      if (!sharedPayload) {
+        rd.Seek(f.offset);
+        zone.Bytes(readBytes += f.compressedSize);
+        lastFile = &f;
+      }
 
-      if (platform == Platform::PS3 && f.compressedSize == f.uncompressedSize) {
-        rd.ReadBuffer(&outBuffer[0], f.compressedSize);
+      if (sharedPayload) {
+        // outBuffer still holds payload of lastFile
+      } else if (platform == Platform::PS3 &&
+                 f.compressedSize == f.uncompressedSize) {
+        {
+          TraceZone readZone("arc.read", f.compressedSize);
+          rd.ReadBuffer(&outBuffer[0], f.compressedSize);
+        }
 
         if (id == ARCCID) {
+          TraceZone decryptZone("arc.decrypt", f.compressedSize);
           enc.Decode(&outBuffer[0], f.compressedSize);
         }
       } else {
-        rd.ReadBuffer(&inBuffer[0], f.compressedSize);
+        {
+          TraceZone readZone("arc.read", f.compressedSize);
+          rd.ReadBuffer(&inBuffer[0], f.compressedSize);
+        }
 
         if (id == ARCCID) {
+          TraceZone decryptZone("arc.decrypt", f.compressedSize);
           enc.Decode(&inBuffer[0], f.compressedSize);
         }
 
         if (hdr.IsLZX()) {
-          DecompressLZX(&inBuffer[0], f.compressedSize, &outBuffer[0],
-                        f.uncompressedSize, id == ARCID ? 17 : 15);
+          TraceZone lzxZone("arc.lzx", f.uncompressedSize);
+          revil::DecompressLZX({inBuffer.data(), f.compressedSize},
+                               {outBuffer.data(), f.uncompressedSize},
+                               id == ARCID ? 17 : 15);
         } else {
-          z_stream infstream;
-          infstream.zalloc = Z_NULL;
-          infstream.zfree = Z_NULL;
-          infstream.opaque = Z_NULL;
-          infstream.avail_in = f.compressedSize;
-          infstream.next_in = reinterpret_cast<Bytef *>(&inBuffer[0]);
-          infstream.avail_out = outBuffer.size();
-          infstream.next_out = reinterpret_cast<Bytef *>(&outBuffer[0]);
-          inflateInit(&infstream);
-          int state = inflate(&infstream, Z_FINISH);
-          inflateEnd(&infstream);
-
-          if (state < 0) {
-            throw std::runtime_error(infstream.msg);
-          }
+          TraceZone inflateZone("arc.inflate", f.uncompressedSize);
+          revil::DecompressZlib({inBuffer.data(), f.compressedSize},
+                                outBuffer);
         }
       }
 
-      auto ext = revil::GetExtension(f.typeHash, title, platform);
+      auto ext = revil::GetExtension(f.typeHash, titleHandle);
       std::string filePath = f.fileName;
       filePath.push_back('.');
 
@@ -274,6 +226,7 @@ void revil::EnumerateArchive(BinReaderRef_e rd, Platform platform,
         filePath.append(ext);
       }
 
+      TraceZone sendZone("arc.send", f.uncompressedSize);
       ectx->NewFile(filePath);
       ectx->SendData({outBuffer.data(), f.uncompressedSize});
     }
@@ -326,3 +279,25 @@ size_t revil::CompressZlib(std::string_view inBuffer, std::string &outBuffer,
 
   return infstream.total_out;
 }
+
+size_t revil::DecompressZlib(std::string_view inBuffer,
+                             std::span<char> outBuffer) {
+  z_stream infstream;
+  infstream.zalloc = Z_NULL;
+  infstream.zfree = Z_NULL;
+  infstream.opaque = Z_NULL;
+  infstream.avail_in = inBuffer.size();
+  infstream.next_in =
+      const_cast<Bytef *>(reinterpret_cast<const Bytef *>(inBuffer.data()));
+  infstream.avail_out = outBuffer.size();
+  infstream.next_out = reinterpret_cast<Bytef *>(outBuffer.data());
+  inflateInit(&infstream);
+  int state = inflate(&infstream, Z_FINISH);
+  inflateEnd(&infstream);
+
+  if (state < 0) {
+    throw std::runtime_error(infstream.msg ? infstream.msg : "inflate error");
+  }
+
+  return infstream.total_out;
+}
@@ -104,7 +104,7 @@ struct ARC : ARCBase {
 using ARCFiles = std::vector<ARCFile>;
 using ARCExtendedFiles = std::vector<ARCExtendedFile>;
 
-auto ReadARC(BinReaderRef_e rd) {
+inline auto ReadARC(BinReaderRef_e rd) {
   ARC hdr;
   rd.Read(hdr);
 
@@ -131,7 +131,7 @@ auto ReadARC(BinReaderRef_e rd) {
   return std::make_tuple(hdr, files);
 }
 
-auto ReadExtendedARC(BinReaderRef_e rd) {
+inline auto ReadExtendedARC(BinReaderRef_e rd) {
   ARC hdr;
   rd.Read(hdr);
 
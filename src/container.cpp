@@ -0,0 +1,146 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "revil/container.hpp"
+#include "compression.hpp"
+#include "parallel.hpp"
+#include "revil/arc.hpp"
+#include "revil/hashreg.hpp"
+#include "revil/lzx.hpp"
+#include "spike/except.hpp"
+#include "spike/io/fileinfo.hpp"
+#include "spike/master_printer.hpp"
+#include <thread>
+#include <vector>
+
+namespace revil {
+ContainerSource::ContainerSource(AppContext *ctx) {
+  try {
+    mapped = es::MappedFile(std::string(ctx->workingFile.GetFullPath()));
+    data = {static_cast<const char *>(mapped.data), mapped.fileSize};
+  } catch (const std::exception &) {
+    buffer = ctx->GetBuffer();
+    data = buffer;
+  }
+}
+
+ContainerSource::ContainerSource(std::string &&decoded)
+    : buffer(std::move(decoded)), data(buffer) {}
+
+static void Decompress(const ContainerEntry &entry, std::string_view input,
+                       std::string &output) {
+  output.resize(entry.uncompressedSize);
+
+  if (entry.codec == ContainerCodec::LZX) {
+    DecompressLZX(input, output, entry.lzxWindowBits);
+    return;
+  }
+
+  size_t inflated = 0;
+
+  try {
+    inflated = DecompressZlib(input, output);
+  } catch (const std::exception &e) {
+    throw es::RuntimeError("Cannot inflate " + entry.path + ": " + e.what());
+  }
+
+  if (inflated != entry.uncompressedSize) {
+    throw es::RuntimeError("Cannot inflate " + entry.path +
+                           ": size mismatch");
+  }
+}
+
+size_t ExtractContainer(std::string_view data,
+                        std::span<const ContainerEntry> entries,
+                        AppExtractContext *ectx) {
+  for (auto &e : entries) {
+    if (e.offset > data.size() || e.size > data.size() - e.offset) {
+      throw es::RuntimeError("Entry is out of container bounds: " + e.path);
+    }
+
+    if (e.codec != ContainerCodec::Stored &&
+        e.uncompressedSize / MAX_COMPRESSION_RATIO > e.size) {
+      throw es::RuntimeError("Entry size is out of bounds: " + e.path);
+    }
+  }
+
+  if (ectx->RequiresFolders()) {
+    for (auto &e : entries) {
+      AFileInfo finf(e.path);
+      ectx->AddFolderPath(std::string(finf.GetFolder()));
+    }
+
+    ectx->GenerateFolders();
+  }
+
+  // Entries of batch are decoded and verified together, buffers are reused
+  const size_t batchSize =
+      std::max(1U, std::thread::hardware_concurrency()) * 4;
+  std::vector<std::string> decoded(std::min(batchSize, entries.size()));
+  std::vector<uint8> crcFailed(decoded.size());
+  std::vector<size_t> work;
+  size_t numFailed = 0;
+
+  auto EntryData = [&](size_t index, size_t begin) -> std::string_view {
+    auto &e = entries[index];
+
+    if (e.codec == ContainerCodec::Stored) {
+      return data.substr(e.offset, e.size);
+    }
+
+    return decoded[index - begin];
+  };
+
+  for (size_t begin = 0; begin < entries.size(); begin += batchSize) {
+    const size_t end = std::min(begin + batchSize, entries.size());
+    work.clear();
+
+    for (size_t i = begin; i < end; i++) {
+      if (entries[i].codec != ContainerCodec::Stored || entries[i].verifyCrc) {
+        work.emplace_back(i);
+      }
+    }
+
+    ParallelFor(work.size(), [&](size_t w) {
+      const size_t index = work[w];
+      auto &e = entries[index];
+
+      if (e.codec != ContainerCodec::Stored) {
+        Decompress(e, data.substr(e.offset, e.size), decoded[index - begin]);
+      }
+
+      crcFailed[index - begin] =
+          e.verifyCrc &&
+          CRC32Update(0xFFFFFFFF, EntryData(index, begin)) != e.crc;
+    });
+
+    for (size_t i = begin; i < end; i++) {
+      auto &e = entries[i];
+
+      if (e.verifyCrc && crcFailed[i - begin]) {
+        printwarning("CRC mismatch: " << e.path);
+        numFailed++;
+      }
+
+      ectx->NewFile(e.path);
+      ectx->SendData(EntryData(i, begin));
+    }
+  }
+
+  return numFailed;
+}
+} // namespace revil
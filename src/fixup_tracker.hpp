@@ -0,0 +1,327 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "spike/except.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace revil {
+class SharedFixupTracker;
+
+// Set of pointer fields that were already fixed up during asset loading
+// Flat open addressing table, keyed by address of pointer field
+// When constructed with extent, every fixed pointer field, its target and
+// checked ranges must be inside of it, otherwise es::RuntimeError is thrown
+class FixupTracker {
+public:
+  FixupTracker() = default;
+  explicit FixupTracker(std::string_view extent_) : extent(extent_) {}
+
+  std::string_view Extent() const { return extent; }
+
+  // Throws if [data, data + size) is outside of extent
+  void CheckRange(const void *data, size_t size) const {
+    if (extent.empty() || !size) {
+      return;
+    }
+
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(extent.data());
+    const uintptr_t item = reinterpret_cast<uintptr_t>(data);
+
+    if (item < begin || item - begin > extent.size() ||
+        size > extent.size() - (item - begin)) {
+      throw es::RuntimeError("Data out of file bounds");
+    }
+  }
+
+  template <class C> void CheckArray(const C *data, size_t count) const {
+    if (!extent.empty() && count > extent.size() / sizeof(C)) {
+      throw es::RuntimeError("Array count out of file bounds");
+    }
+
+    CheckRange(data, count * sizeof(C));
+  }
+
+  // Bulk check of extent relative offset table
+  // Branchless max reduction, so compiler can vectorize it
+  template <class C> void CheckOffsets(const C *offsets, size_t count) const {
+    CheckArray(offsets, count);
+
+    if (extent.empty()) {
+      return;
+    }
+
+    C maxOffset = 0;
+
+    for (size_t i = 0; i < count; i++) {
+      maxOffset = std::max(maxOffset, offsets[i]);
+    }
+
+    if (maxOffset >= extent.size()) {
+      throw es::RuntimeError("Offset out of file bounds");
+    }
+  }
+
+  // Validates pointer field and its raw offset before fixup
+  template <class Ptr>
+  void CheckPointer(const Ptr &ptr, const char *base) const {
+    if (extent.empty()) {
+      return;
+    }
+
+    const void *key = Key(ptr);
+    size_t width = sizeof(Ptr);
+
+    if constexpr (requires { ptr.lookup; }) {
+      width = ptr.lookup.x64 ? 8 : 4;
+    } else {
+      static_assert(sizeof(Ptr) == 4 || sizeof(Ptr) == 8);
+    }
+
+    CheckRange(key, width);
+    uint64_t offset = 0;
+
+    if (width == 8) {
+      memcpy(&offset, key, 8);
+    } else {
+      uint32_t offset32;
+      memcpy(&offset32, key, 4);
+      offset = offset32;
+    }
+
+    if (!offset) {
+      return;
+    }
+
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(extent.data());
+    const uintptr_t baseOffset = reinterpret_cast<uintptr_t>(base) - begin;
+
+    if (baseOffset > extent.size() || offset >= extent.size() - baseOffset) {
+      throw es::RuntimeError("Pointer out of file bounds");
+    }
+  }
+
+  // Returns false if address is already tracked
+  bool Insert(const void *address);
+  bool Contains(const void *address) const;
+
+  void Merge(const FixupTracker &other) {
+    for (uintptr_t key : other.slots) {
+      if (key) {
+        Insert(reinterpret_cast<const void *>(key));
+      }
+    }
+  }
+
+  size_t Size() const { return numItems; }
+
+  // Equivalent of Pointer::Check(ptrStore)
+  template <class Ptr> bool Check(const Ptr &ptr) const {
+    return Contains(Key(ptr));
+  }
+
+  // Equivalent of Pointer::Fixup(base, ptrStore)
+  // Returns false if pointer was already fixed
+  template <class Ptr> bool Fixup(Ptr &&ptr, char *base) {
+    if (!Insert(Key(ptr))) {
+      return false;
+    }
+
+    CheckPointer(ptr, base);
+
+    // Deduplication is done by tracker, pointer only sees empty store
+    thread_local std::vector<void *> scratch;
+    scratch.clear();
+    ptr.Fixup(base, scratch);
+
+    return true;
+  }
+
+  // Equivalent of es::FixupPointers
+  // Returns false if any of pointers was already fixed
+  template <class... Ptr> bool FixupPointers(char *base, Ptr &...ptrs) {
+    bool retVal = true;
+    ((retVal &= Fixup(ptrs, base)), ...);
+    return retVal;
+  }
+
+private:
+  friend class SharedFixupTracker;
+  std::vector<uintptr_t> slots;
+  size_t numItems = 0;
+  std::string_view extent;
+  // Worker view, inserts and lookups go to shared tracker
+  SharedFixupTracker *shared = nullptr;
+
+  bool InsertLocal(uintptr_t key) {
+    if ((numItems + 1) * 2 > slots.size()) {
+      Grow();
+    }
+
+    return InsertKey(key);
+  }
+
+  bool ContainsLocal(uintptr_t key) const {
+    if (slots.empty()) {
+      return false;
+    }
+
+    const size_t mask = slots.size() - 1;
+
+    for (size_t s = Slot(key);; s = (s + 1) & mask) {
+      if (slots[s] == key) {
+        return true;
+      } else if (!slots[s]) {
+        return false;
+      }
+    }
+  }
+
+  // classgen pointers are views, they hold address of pointer field
+  template <class Ptr> static const void *Key(const Ptr &ptr) {
+    if constexpr (requires { ptr.lookup; }) {
+      return ptr.data;
+    } else {
+      return &ptr;
+    }
+  }
+
+  size_t Slot(uintptr_t key) const {
+    // Pointer fields are at least 4 byte aligned
+    const uint64_t hash = uint64_t(key >> 2) * 0x9E3779B97F4A7C15ULL;
+    return size_t(hash >> 32) & (slots.size() - 1);
+  }
+
+  bool InsertKey(uintptr_t key) {
+    const size_t mask = slots.size() - 1;
+
+    for (size_t s = Slot(key);; s = (s + 1) & mask) {
+      if (slots[s] == key) {
+        return false;
+      } else if (!slots[s]) {
+        slots[s] = key;
+        numItems++;
+        return true;
+      }
+    }
+  }
+
+  void Grow() {
+    std::vector<uintptr_t> oldSlots(std::max<size_t>(slots.size() * 2, 64));
+    std::swap(slots, oldSlots);
+    numItems = 0;
+
+    for (uintptr_t key : oldSlots) {
+      if (key) {
+        InsertKey(key);
+      }
+    }
+  }
+};
+// Pointer set for fixups done from multiple worker threads
+// Every pointer field is fixed exactly once, even if workers walk overlapping
+// data. Keys are spread over independently locked shards, keys of parent
+// tracker count as tracked and parent must not change until Merge
+class SharedFixupTracker {
+public:
+  explicit SharedFixupTracker(FixupTracker &parent_) : parent(parent_) {}
+
+  // Tracker for a single worker thread
+  FixupTracker Worker() {
+    FixupTracker retVal(parent.Extent());
+    retVal.shared = this;
+    return retVal;
+  }
+
+  bool Insert(uintptr_t key) {
+    if (parent.ContainsLocal(key)) {
+      return false;
+    }
+
+    Shard &shard = shards[ShardIndex(key)];
+    std::lock_guard<std::mutex> lg(shard.mtx);
+    return shard.keys.InsertLocal(key);
+  }
+
+  bool Contains(uintptr_t key) {
+    if (parent.ContainsLocal(key)) {
+      return true;
+    }
+
+    Shard &shard = shards[ShardIndex(key)];
+    std::lock_guard<std::mutex> lg(shard.mtx);
+    return shard.keys.ContainsLocal(key);
+  }
+
+  // Moves keys of workers into parent, call after all workers are done
+  void Merge() {
+    for (auto &s : shards) {
+      parent.Merge(s.keys);
+      s.keys = FixupTracker{};
+    }
+  }
+
+private:
+  static constexpr size_t NUM_SHARDS = 64;
+
+  struct Shard {
+    std::mutex mtx;
+    FixupTracker keys;
+  };
+
+  FixupTracker &parent;
+  Shard shards[NUM_SHARDS];
+
+  static size_t ShardIndex(uintptr_t key) {
+    return size_t((uint64_t(key >> 2) * 0x9E3779B97F4A7C15ULL) >> 58);
+  }
+};
+
+inline bool FixupTracker::Insert(const void *address) {
+  const uintptr_t key = reinterpret_cast<uintptr_t>(address);
+
+  if (!key) {
+    return false;
+  }
+
+  if (shared) {
+    return shared->Insert(key);
+  }
+
+  return InsertLocal(key);
+}
+
+inline bool FixupTracker::Contains(const void *address) const {
+  const uintptr_t key = reinterpret_cast<uintptr_t>(address);
+
+  if (!key) {
+    return false;
+  }
+
+  if (shared) {
+    return shared->Contains(key);
+  }
+
+  return ContainsLocal(key);
+}
+} // namespace revil
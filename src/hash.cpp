@@ -1,43 +1,118 @@
 #include "revil/hashreg.hpp"
+#include <algorithm>
 #include <cstring>
+#include <memory>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+// MT state is seeded with LCG x = 0x10DCD * x + 1
+// k steps of it are an affine function: x_k = mul[k] * x_0 + add[k]
+struct LCGJump {
+  uint32 mul;
+  uint32 add;
+};
+
+constexpr LCGJump MakeLCGJump(size_t numSteps) {
+  LCGJump retVal{1, 0};
+
+  for (size_t i = 0; i < numSteps; i++) {
+    retVal.mul *= 0x10DCD;
+    retVal.add = retVal.add * 0x10DCD + 1;
+  }
+
+  return retVal;
+}
+
+constexpr uint32 LCGStep(LCGJump jump, uint32 seed) {
+  return jump.mul * seed + jump.add;
+}
+
+// Every mtData[i] word is made from LCG steps 2 * i and 2 * i + 1
+constexpr uint32 MTWord(LCGJump hi, LCGJump lo, uint32 seed) {
+  return (LCGStep(hi, seed) & 0xFFFF0000) | (LCGStep(lo, seed) >> 16);
+}
+
+// Only mtData[0], mtData[1] and mtData[397] contribute to the hash
+constexpr LCGJump MT_STEP1 = MakeLCGJump(1);
+constexpr LCGJump MT_STEP2 = MakeLCGJump(2);
+constexpr LCGJump MT_STEP3 = MakeLCGJump(3);
+constexpr LCGJump MT_STEP794 = MakeLCGJump(794);
+constexpr LCGJump MT_STEP795 = MakeLCGJump(795);
+
+constexpr uint32 MTHashV1Pair(char cur, char next) {
+  const uint32 seed = (next - 32) | ((cur - 32) << 6);
+  const uint32 mt0 = (seed & 0xFFFF0000) | (LCGStep(MT_STEP1, seed) >> 16);
+  const uint32 mt1 = MTWord(MT_STEP2, MT_STEP3, seed);
+  const uint32 mt397 = MTWord(MT_STEP794, MT_STEP795, seed);
+
+  uint32 tmp0 = mt0 ^ ((mt0 ^ mt1) & 0x7FFFFFFF);
+  uint32 tmp1 = mt397 ^ (0x9908B0DF * (tmp0 & 1)) ^ (tmp0 >> 1);
+  tmp1 ^= tmp1 >> 11;
+  tmp1 ^= (tmp1 & 0xFF3A58AD) << 7;
+  tmp1 ^= (tmp1 & 0xFFFFDF8C) << 15;
+
+  return tmp1 ^ (tmp1 >> 18);
+}
+
+// Hash contribution of every (char, next char) pair, 256KiB
+// Built on first batched call
+const uint32 *MTHashV1Pairs() {
+  static const std::unique_ptr<uint32[]> pairs = [] {
+    std::unique_ptr<uint32[]> retVal(new uint32[0x10000]);
+
+    for (uint32 i = 0; i < 0x10000; i++) {
+      retVal[i] = MTHashV1Pair(char(i >> 8), char(i));
+    }
+
+    return retVal;
+  }();
+
+  return pairs.get();
+}
+} // namespace
 
 // Basically butchered Mersenne Twister
 uint32 revil::MTHashV1(std::string_view text) {
   uint32 retVal = 0;
-  uint32 mtData[624];
-
-  auto makeSeed = [&](uint32 seed) {
-    mtData[0] = seed & 0xFFFF0000;
-    seed = 0x10DCD * seed + 1;
-    mtData[0] |= seed >> 16;
-
-    for (size_t i = 1; i < 624; i++) {
-      seed = 0x10DCD * seed + 1;
-      mtData[i] = seed & 0xFFFF0000;
-      seed = 0x10DCD * seed + 1;
-      mtData[i] |= seed >> 16;
-    }
-  };
-
-  makeSeed(2004);
 
   for (size_t i = 0; i < text.size(); i++) {
-    auto nextChar = i + 1 == text.size() ? 0 : text[i + 1];
-    makeSeed((nextChar - 32) | ((text[i] - 32) << 6));
-    uint32 tmp0 = mtData[0] ^ ((mtData[0] ^ mtData[1]) & 0x7FFFFFFF);
-    uint32 tmp1 = mtData[397] ^ (0x9908B0DF * (tmp0 & 1)) ^ (tmp0 >> 1);
-    tmp1 ^= tmp1 >> 11;
-
-    retVal ^= (((((tmp1 & 0xFF3A58AD) << 7) ^ tmp1) & 0xFFFFDF8C) << 15) ^
-              ((tmp1 & 0xFF3A58AD) << 7) ^ tmp1 ^
-              (((((((tmp1 & 0xFF3A58AD) << 7) ^ tmp1) & 0xFFFFDF8C) << 15) ^
-                ((tmp1 & 0xFF3A58AD) << 7) ^ tmp1) >>
-               18);
+    const char nextChar = i + 1 == text.size() ? 0 : text[i + 1];
+    retVal ^= MTHashV1Pair(text[i], nextChar);
   }
 
   return retVal & 0x7FFFFFFF;
 }
 
+void revil::MTHashV1(std::span<const std::string_view> texts,
+                     std::span<uint32> hashes) {
+  const uint32 *pairs = MTHashV1Pairs();
+  const size_t numItems = std::min(texts.size(), hashes.size());
+
+  for (size_t t = 0; t < numItems; t++) {
+    std::string_view text = texts[t];
+    uint32 retVal = 0;
+
+    if (text.size() > 0) {
+      const uint8 *data = reinterpret_cast<const uint8 *>(text.data());
+      const size_t last = text.size() - 1;
+
+      for (size_t i = 0; i < last; i++) {
+        retVal ^= pairs[(data[i] << 8) | data[i + 1]];
+      }
+
+      retVal ^= pairs[data[last] << 8];
+    }
+
+    hashes[t] = retVal & 0x7FFFFFFF;
+  }
+}
+
 static const uint32 crc32bBoxes[][0x100] = {
     {
         0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
@@ -401,37 +476,181 @@ static const uint32 crc32bBoxes[][0x100] = {
     },
 };
 
+namespace {
+union CRCChunk {
+  uint64 registry;
+  uint32 lowerPart;
+  uint8 nibbles[8];
+};
+
+uint32 CRCFold8(uint32 retval, const char *data) {
+  CRCChunk main;
+  memcpy(&main, data, 8);
+  main.lowerPart ^= retval;
+  retval = 0;
+
+  for (size_t n = 0; n < 8; n++) {
+    retval ^= crc32bBoxes[7 - n][main.nibbles[n]];
+  }
+
+  return retval;
+}
+
+uint32 CRCTable(uint32 retval, const char *data, size_t size) {
+  const size_t numChunks = size / 8;
+  const size_t numRest = size % 8;
+
+  for (size_t i = 0; i < numChunks; i++) {
+    retval = CRCFold8(retval, data + i * 8);
+  }
+
+  for (size_t n = 0; n < numRest; n++) {
+    retval = (retval >> 8) ^
+             crc32bBoxes[0][(retval & 0xFF) ^ uint8(data[numChunks * 8 + n])];
+  }
+
+  return retval;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define REVIL_CRC_CLMUL
+
+#if defined(__GNUC__)
+#define CLMUL_TARGET __attribute__((target("pclmul,sse4.1")))
+#else
+#define CLMUL_TARGET
+#endif
+
+bool CPUHasCLMUL() {
+#if defined(_MSC_VER)
+  int regs[4];
+  __cpuid(regs, 1);
+  // PCLMULQDQ: bit 1, SSE4.1: bit 19
+  return (regs[2] & 0x80002) == 0x80002;
+#else
+  return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+CLMUL_TARGET __m128i CRCFoldBlock(__m128i x, __m128i k, __m128i next) {
+  const __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+  const __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(lo, hi), next);
+}
+
+// Carry-less multiplication folding of 0xEDB88320 polynomial
+// Consumes 16 byte blocks, size must be at least 64
+CLMUL_TARGET uint32 CRCFoldCLMUL(uint32 crc, const char *&data, size_t &size) {
+  alignas(16) static const uint64 k1k2[]{0x0154442BD4, 0x01C6E41596};
+  alignas(16) static const uint64 k3k4[]{0x01751997D0, 0x00CCAA009E};
+  alignas(16) static const uint64 k5k0[]{0x0163CD6124, 0x0000000000};
+  alignas(16) static const uint64 poly[]{0x01DB710641, 0x01F7011641};
+
+  auto Load = [&](size_t offset) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + offset));
+  };
+
+  __m128i x1 = _mm_xor_si128(Load(0), _mm_cvtsi32_si128(crc));
+  __m128i x2 = Load(16);
+  __m128i x3 = Load(32);
+  __m128i x4 = Load(48);
+  __m128i k = _mm_load_si128(reinterpret_cast<const __m128i *>(k1k2));
+  data += 64;
+  size -= 64;
+
+  for (; size >= 64; data += 64, size -= 64) {
+    x1 = CRCFoldBlock(x1, k, Load(0));
+    x2 = CRCFoldBlock(x2, k, Load(16));
+    x3 = CRCFoldBlock(x3, k, Load(32));
+    x4 = CRCFoldBlock(x4, k, Load(48));
+  }
+
+  k = _mm_load_si128(reinterpret_cast<const __m128i *>(k3k4));
+  x1 = CRCFoldBlock(x1, k, x2);
+  x1 = CRCFoldBlock(x1, k, x3);
+  x1 = CRCFoldBlock(x1, k, x4);
+
+  for (; size >= 16; data += 16, size -= 16) {
+    x1 = CRCFoldBlock(x1, k, Load(0));
+  }
+
+  // 128 -> 64 bits
+  const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+  k = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(k5k0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits
+  k = _mm_load_si128(reinterpret_cast<const __m128i *>(poly));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return _mm_extract_epi32(x1, 1);
+}
+#endif
+
+uint32 CRCUpdate(uint32 retval, const char *data, size_t size) {
+#ifdef REVIL_CRC_CLMUL
+  static const bool hasCLMUL = CPUHasCLMUL();
+
+  if (size >= 64 && hasCLMUL) {
+    retval = CRCFoldCLMUL(retval, data, size);
+  }
+#endif
+
+  return CRCTable(retval, data, size);
+}
+} // namespace
+
+uint32 revil::CRC32Update(uint32 crc, std::string_view data) {
+  return CRCUpdate(crc, data.data(), data.size());
+}
+
 // Basically CRC32B with small adjustments
 uint32 revil::MTHashV2(std::string_view data) {
-  uint32 retval = 0xFFFFFFFF;
-  const size_t numChunks = data.size() / 8;
-  const size_t numRest = data.size() % 8;
-  union Chunk {
-    uint64 registry;
-    uint32 lowerPart;
-    uint8 nibbles[8];
-  };
+  return CRCUpdate(0xFFFFFFFF, data.data(), data.size()) & 0x7FFFFFFF;
+}
 
-  for (size_t i = 0; i < numChunks; i++) {
-    Chunk main;
-    memcpy(&main, data.data() + i * 8, 8);
-    main.lowerPart ^= retval;
-    retval = 0;
+void revil::MTHashV2(std::span<const std::string_view> texts,
+                     std::span<uint32> hashes) {
+  // Interleave independent table lookups of multiple short strings
+  static constexpr size_t NUM_LANES = 4;
+  const size_t numItems = std::min(texts.size(), hashes.size());
+  size_t t = 0;
 
-    for (size_t n = 0; n < 8; n++) {
-      retval ^= crc32bBoxes[7 - n][main.nibbles[n]];
+  for (; t + NUM_LANES <= numItems; t += NUM_LANES) {
+    uint32 lanes[NUM_LANES];
+    size_t commonSize = texts[t].size();
+
+    for (size_t l = 0; l < NUM_LANES; l++) {
+      lanes[l] = 0xFFFFFFFF;
+      commonSize = std::min(commonSize, texts[t + l].size());
     }
-  }
 
-  if (numRest) {
-    Chunk main;
-    memcpy(&main, data.data() + numChunks * 8, numRest);
+    // Long inputs are left for folding
+    commonSize = std::min<size_t>(commonSize, 64) & ~size_t(7);
 
-    for (size_t n = 0; n < numRest; n++) {
-      retval =
-          (retval >> 8) ^ crc32bBoxes[0][(retval & 0xFF) ^ main.nibbles[n]];
+    for (size_t c = 0; c < commonSize; c += 8) {
+      for (size_t l = 0; l < NUM_LANES; l++) {
+        lanes[l] = CRCFold8(lanes[l], texts[t + l].data() + c);
+      }
+    }
+
+    for (size_t l = 0; l < NUM_LANES; l++) {
+      std::string_view text = texts[t + l];
+      hashes[t + l] =
+          CRCUpdate(lanes[l], text.data() + commonSize,
+                    text.size() - commonSize) &
+          0x7FFFFFFF;
     }
   }
 
-  return retval & 0x7FFFFFFF;
+  for (; t < numItems; t++) {
+    hashes[t] = MTHashV2(texts[t]);
+  }
 }
@@ -15,44 +15,77 @@ REFLECT(ENUMERATION(Platform), ENUM_MEMBER(Auto), ENUM_MEMBER(Win32),
 
 namespace revil {
 
-std::string_view GetExtension(uint32 hash, std::string_view title,
-                              Platform platform_) {
-  const uint8 platform = uint8(platform_) & PLATFORM_MASK;
+static const Title *FindTitle(std::string_view title) {
+  if (title.empty()) {
+    return nullptr;
+  }
 
-  if (!title.empty()) {
-    auto oKey = LowerBound(title, REDB.titles);
+  auto oKey = LowerBound(title, REDB.titles);
 
-    if (oKey != REDB.titles.end() && std::string_view(oKey->name) == title) {
-      for (auto &fx : oKey->data->fixups) {
-        if (fx.platform == platform) {
-          const ResourceClass *fClasses = fx.classes.operator->();
+  if (oKey != REDB.titles.end() && std::string_view(oKey->name) == title) {
+    return oKey->data.operator->();
+  }
 
-          for (size_t i = 0; i < fx.numItems; i++) {
-            if (fClasses[i].hash == hash) {
-              return fClasses[i].extension;
-            }
-          }
-        }
+  return nullptr;
+}
+
+static const Fixup *FindFixup(const Title *title, uint8 platform) {
+  if (title) {
+    for (auto &fx : title->fixups) {
+      if (fx.platform == platform) {
+        return &fx;
       }
     }
   }
 
-  auto foundClass = LowerBound(hash, REDB.resourceClasses[platform]);
+  return nullptr;
+}
+
+static std::string_view FindExtension(uint32 hash, const Fixup *fixup,
+                                      uint8 platform) {
+  if (fixup && fixup->numItems > 0) {
+    const ResourceClass &cls = fixup->classes.operator->()[PerfectHashSlot(
+        hash, fixup->seeds, fixup->numItems)];
 
-  if (foundClass != REDB.resourceClasses[platform].end() &&
-      foundClass->hash == hash) {
-    return foundClass->extension;
+    if (cls.hash == hash) {
+      return cls.extension;
+    }
   }
 
-  foundClass = LowerBound(hash, REDB.resourceClasses[0]);
+  auto &map = REDB.classMaps[platform];
 
-  if (foundClass != REDB.resourceClasses[0].end() && foundClass->hash == hash) {
-    return foundClass->extension;
+  if (map.classes.numItems == 0) {
+    return {};
+  }
+
+  const ResourceClass &cls = map.classes.begin()[PerfectHashSlot(
+      hash, map.seeds, map.classes.numItems)];
+
+  if (cls.hash == hash) {
+    return cls.extension;
   }
 
   return {};
 }
 
+std::string_view GetExtension(uint32 hash, std::string_view title,
+                              Platform platform_) {
+  const uint8 platform = uint8(platform_) & PLATFORM_MASK;
+  return FindExtension(hash, FindFixup(FindTitle(title), platform), platform);
+}
+
+struct TitleHandleAccess {
+  static const Fixup *Get(const TitleHandle &handle) { return handle.fixup; }
+  static void Set(TitleHandle &handle, const Fixup *fixup) {
+    handle.fixup = fixup;
+  }
+};
+
+std::string_view GetExtension(uint32 hash, const TitleHandle &title) {
+  return FindExtension(hash, TitleHandleAccess::Get(title),
+                       uint8(title.platform) & PLATFORM_MASK);
+}
+
 std::string_view GetClassName(uint32 hash) {
   auto foundResClass = LowerBound(hash, REDB.resourceClasses[0]);
 
@@ -76,19 +109,19 @@ void GetTitles(TitleCallback cb) {
   }
 }
 
-/* Lookup order:
-  extCommon map
-  if platform not auto lookup class from ext<platform> map
-*/
 std::span<const uint32> GetHash(std::string_view extension,
-                                std::string_view title, Platform platform) {
-  auto supp = GetTitleSupport(title, platform);
+                                const TitleHandle &title) {
+  const bool version1 =
+      title.support && (title.support->arc.flags & DbArc_Version1);
+  auto &map = REDB.extensionMaps[version1];
 
-  auto hashes =
-      ClassesFromExtension(REDB, extension, supp->arc.flags & DbArc_Version1);
+  if (map.extensions.numItems > 0) {
+    const ExtensionN &found = map.extensions.begin()[PerfectHashSlot(
+        PerfectHashKey(extension), map.seeds, map.extensions.numItems)];
 
-  if (hashes.size() > 0) {
-    return hashes;
+    if (std::string_view(found.extension) == extension) {
+      return {found.hashes.begin(), found.hashes.size};
+    }
   }
 
   // for backward compatibility, some extensions might have numerical (hashed)
@@ -100,13 +133,18 @@ std::span<const uint32> GetHash(std::string_view extension,
     return {};
   }
 
-  auto extTranslated = GetExtension(cvted, title, platform);
+  auto extTranslated = GetExtension(cvted, title);
 
   if (extTranslated.empty()) {
     return {};
   }
 
-  return GetHash(extTranslated, title, platform);
+  return GetHash(extTranslated, title);
+}
+
+std::span<const uint32> GetHash(std::string_view extension,
+                                std::string_view title, Platform platform) {
+  return GetHash(extension, ResolveTitle(title, platform));
 }
 
 Platforms GetPlatformSupport(std::string_view title) {
@@ -130,18 +168,13 @@ Platforms GetPlatformSupport(std::string_view title) {
   return flags;
 }
 
-const TitleSupport *GetTitleSupport(std::string_view title, Platform platform) {
-  auto found = LowerBound(title, REDB.titles);
-
-  if (found == REDB.titles.end() || found->name != title) {
-    throw es::RuntimeError("Coundn't find title.");
-  }
-
+static const TitleSupport *FindTitleSupport(const Title &title,
+                                            Platform platform) {
   if (platform == Platform::Auto) {
     platform = Platform::Win32;
   }
 
-  auto platforms = found->data->support.operator->();
+  auto platforms = title.support.operator->();
 
   auto foundSec = platforms[(uint8(platform) & PLATFORM_MASK) - 1].operator->();
 
@@ -174,4 +207,35 @@ const TitleSupport *GetTitleSupport(std::string_view title, Platform platform) {
   return foundSec;
 }
 
+const TitleSupport *GetTitleSupport(std::string_view title, Platform platform) {
+  const Title *found = FindTitle(title);
+
+  if (!found) {
+    throw es::RuntimeError("Coundn't find title.");
+  }
+
+  return FindTitleSupport(*found, platform);
+}
+
+TitleHandle ResolveTitle(std::string_view title, Platform platform) {
+  TitleHandle handle;
+  handle.platform = platform;
+
+  if (title.empty()) {
+    return handle;
+  }
+
+  const Title *found = FindTitle(title);
+
+  if (!found) {
+    throw es::RuntimeError("Coundn't find title.");
+  }
+
+  handle.support = FindTitleSupport(*found, platform);
+  TitleHandleAccess::Set(handle,
+                         FindFixup(found, uint8(platform) & PLATFORM_MASK));
+
+  return handle;
+}
+
 } // namespace revil
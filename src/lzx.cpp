@@ -0,0 +1,214 @@
+/*  Revil Format Library
+    Copyright(C) 2020-2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "revil/lzx.hpp"
+#include "spike/except.hpp"
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "lzx.h"
+#include "mspack.h"
+
+struct mspack_file {
+  uint8 *buffer;
+  uint32 bufferSize;
+  uint32 position;
+  uint32 rest;
+};
+
+// https://github.com/gildor2/UEViewer/blob/master/Unreal/UnCoreCompression.cpp#L90
+static int mspack_read(mspack_file *file, void *buffer, int bytes) {
+  if (!file->rest) {
+    if (file->position + 2 > file->bufferSize) {
+      return 0;
+    }
+
+    // read block header
+    if (file->buffer[file->position] == 0xFF) {
+      if (file->position + 5 > file->bufferSize) {
+        return 0;
+      }
+
+      // [0]   = FF
+      // [1,2] = uncompressed block size
+      // [3,4] = compressed block size
+      file->rest = (file->buffer[file->position + 3] << 8) |
+                   file->buffer[file->position + 4];
+      file->position += 5;
+    } else {
+      // [0,1] = compressed size
+      file->rest = (file->buffer[file->position + 0] << 8) |
+                   file->buffer[file->position + 1];
+      file->position += 2;
+    }
+
+    if (file->rest > file->bufferSize - file->position) {
+      file->rest = file->bufferSize - file->position;
+    }
+  }
+
+  if (bytes > int(file->rest)) {
+    bytes = file->rest;
+  }
+
+  if (bytes <= 0) {
+    return 0;
+  }
+
+  memcpy(buffer, file->buffer + file->position, bytes);
+  file->position += bytes;
+  file->rest -= bytes;
+
+  return bytes;
+}
+
+static int mspack_write(mspack_file *file, void *buffer, int bytes) {
+  if (bytes <= 0) {
+    return 0;
+  }
+
+  if (uint32(bytes) > file->bufferSize - file->position) {
+    return -1;
+  }
+
+  memcpy(file->buffer + file->position, buffer, bytes);
+  file->position += bytes;
+  return bytes;
+}
+
+static mspack_system mspackSystem{
+    nullptr,                                                     // open
+    nullptr,                                                     // close
+    mspack_read,                                                 // read
+    mspack_write,                                                // write
+    nullptr,                                                     // seek
+    nullptr,                                                     // tell
+    nullptr,                                                     // message
+    [](mspack_system *, size_t bytes) { return malloc(bytes); }, // alloc
+    free,                                                        // free
+    [](void *src, void *dst, size_t bytes) { memcpy(dst, src, bytes); }, // copy
+};
+
+namespace {
+struct LZXDeleter {
+  void operator()(lzxd_stream *lzxd) const { lzxd_free(lzxd); }
+};
+
+using LZXState = std::unique_ptr<lzxd_stream, LZXDeleter>;
+
+// Decoder states hold window and input buffer (up to 4MB), reuse them
+struct LZXPool {
+  std::mutex mutex;
+  std::vector<LZXState> states[22];
+
+  LZXState Acquire(uint32 windowBits, mspack_file *input, mspack_file *output,
+                   uint32 outputSize) {
+    LZXState state;
+
+    {
+      std::lock_guard<std::mutex> lg(mutex);
+      auto &free = states[windowBits];
+
+      if (!free.empty()) {
+        state = std::move(free.back());
+        free.pop_back();
+      }
+    }
+
+    if (!state) {
+      state.reset(lzxd_init(&mspackSystem, input, output, windowBits, 0,
+                            1 << windowBits, outputSize, false));
+
+      if (!state) {
+        throw es::RuntimeError("Cannot initialize LZX decoder");
+      }
+
+      return state;
+    }
+
+    // Same as lzxd_init, minus allocations
+    lzxd_stream *lzx = state.get();
+    lzx->input = input;
+    lzx->output = output;
+    lzx->offset = 0;
+    lzx->length = outputSize;
+    lzx->window_posn = 0;
+    lzx->frame_posn = 0;
+    lzx->frame = 0;
+    lzx->intel_filesize = 0;
+    lzx->intel_curpos = 0;
+    lzx->intel_started = 0;
+    lzx->error = MSPACK_ERR_OK;
+    lzx->o_ptr = lzx->o_end = &lzx->e8_buf[0];
+    lzx->R0 = lzx->R1 = lzx->R2 = 1;
+    lzx->header_read = 0;
+    lzx->block_remaining = 0;
+    lzx->block_type = LZX_BLOCKTYPE_INVALID;
+    memset(lzx->MAINTREE_len, 0, LZX_MAINTREE_MAXSYMBOLS);
+    memset(lzx->LENGTH_len, 0, LZX_LENGTH_MAXSYMBOLS);
+    lzx->i_ptr = lzx->i_end = &lzx->inbuf[0];
+    lzx->bit_buffer = 0;
+    lzx->bits_left = 0;
+    lzx->input_end = 0;
+
+    return state;
+  }
+
+  void Release(uint32 windowBits, LZXState &&state) {
+    std::lock_guard<std::mutex> lg(mutex);
+    states[windowBits].emplace_back(std::move(state));
+  }
+};
+
+LZXPool &Pool() {
+  static LZXPool pool;
+  return pool;
+}
+} // namespace
+
+namespace revil {
+void DecompressLZX(std::string_view input, std::span<char> output,
+                   uint32 windowBits) {
+  if (windowBits < 15 || windowBits > 21) {
+    throw es::RuntimeError("Invalid LZX window size: " +
+                           std::to_string(windowBits));
+  }
+
+  mspack_file inStream{};
+  mspack_file outStream{};
+  inStream.buffer =
+      reinterpret_cast<uint8 *>(const_cast<char *>(input.data()));
+  inStream.bufferSize = input.size();
+  outStream.buffer = reinterpret_cast<uint8 *>(output.data());
+  outStream.bufferSize = output.size();
+
+  LZXState lzxd =
+      Pool().Acquire(windowBits, &inStream, &outStream, output.size());
+  int retVal = lzxd_decompress(lzxd.get(), output.size());
+
+  if (retVal != MSPACK_ERR_OK) {
+    // State of failed decoder is undefined, it is not returned to pool
+    throw std::runtime_error("LZX decompression error " +
+                             std::to_string(retVal));
+  }
+
+  Pool().Release(windowBits, std::move(lzxd));
+}
+} // namespace revil
@@ -127,19 +127,22 @@ void ProcessClass(LMTAnimationMidInterface &item,
                   LMTConstructorProperties flags) {
   size_t trackStride = 0;
 
-  if (item.interface.TracksPtr().Check(flags.ptrStore)) {
+  if (flags.ptrStore.Check(item.interface.TracksPtr())) {
     return;
   }
 
+  flags.ptrStore.CheckRange(item.interface.data,
+                            item.interface.layout->totalSize);
+
   if (flags.swapEndian) {
     clgen::EndianSwap(item.interface);
   }
 
-  item.interface.TracksPtr().Fixup(flags.base, flags.ptrStore);
+  flags.ptrStore.Fixup(item.interface.TracksPtr(), flags.base);
 
   if (item.interface.LayoutVersion() >= LMT66) {
-    item.interface.EventsPtr().Fixup(flags.base, flags.ptrStore);
-    item.interface.FloatsPtr().Fixup(flags.base, flags.ptrStore);
+    flags.ptrStore.Fixup(item.interface.EventsPtr(), flags.base);
+    flags.ptrStore.Fixup(item.interface.FloatsPtr(), flags.base);
     auto events = item.interface.EventsLMT66();
     if (events.data) {
       flags.dataStart = events.data;
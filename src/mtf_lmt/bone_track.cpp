@@ -257,17 +257,24 @@ struct LMTTrackMidInterface : LMTTrackInterface {
 
 template <>
 void ProcessClass(LMTTrackMidInterface &item, LMTConstructorProperties flags) {
-  if (!item.interface.BufferPtr().Check(flags.ptrStore)) {
+  if (!flags.ptrStore.Check(item.interface.BufferPtr())) {
+    flags.ptrStore.CheckRange(item.interface.data,
+                              item.interface.layout->totalSize);
+
     if (flags.swapEndian) {
       clgen::EndianSwap(item.interface);
     }
 
-    item.interface.BufferPtr().Fixup(flags.base, flags.ptrStore);
+    flags.ptrStore.Fixup(item.interface.BufferPtr(), flags.base);
+    flags.ptrStore.CheckRange(item.interface.Buffer(),
+                              item.interface.BufferSize());
 
     if (item.interface.LayoutVersion() >= LMT56) {
-      item.interface.ExtremesPtr().Fixup(flags.base, flags.ptrStore);
+      flags.ptrStore.Fixup(item.interface.ExtremesPtr(), flags.base);
 
       if (auto extr = item.interface.Extremes(); extr) {
+        flags.ptrStore.CheckArray(extr, 1);
+
         if (flags.swapEndian) {
           FByteswapper(*extr);
         }
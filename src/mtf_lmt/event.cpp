@@ -64,7 +64,7 @@ void FByteswapper(AnimEventsHeaderV2 &item) {
 
 template <>
 void ProcessClass(AnimEventV2 &item, LMTConstructorProperties flags) {
-  if (item.frames.Check(flags.ptrStore)) {
+  if (flags.ptrStore.Check(item.frames)) {
     return;
   }
 
@@ -72,9 +72,10 @@ void ProcessClass(AnimEventV2 &item, LMTConstructorProperties flags) {
     FByteswapper(item);
   }
 
-  item.frames.Fixup(flags.base, flags.ptrStore);
+  flags.ptrStore.Fixup(item.frames, flags.base);
 
   AnimEventFrameV2 *frames_ = item.frames;
+  flags.ptrStore.CheckArray(frames_, item.numFrames);
 
   for (size_t e = 0; e < item.numFrames; e++) {
     FByteswapper(frames_[e]);
@@ -83,7 +84,7 @@ void ProcessClass(AnimEventV2 &item, LMTConstructorProperties flags) {
 
 template <>
 void ProcessClass(AnimEventGroupV2 &item, LMTConstructorProperties flags) {
-  if (item.events.Check(flags.ptrStore)) {
+  if (flags.ptrStore.Check(item.events)) {
     return;
   }
 
@@ -91,9 +92,10 @@ void ProcessClass(AnimEventGroupV2 &item, LMTConstructorProperties flags) {
     FByteswapper(item);
   }
 
-  item.events.Fixup(flags.base, flags.ptrStore);
+  flags.ptrStore.Fixup(item.events, flags.base);
 
   AnimEventV2 *events_ = item.events;
+  flags.ptrStore.CheckArray(events_, item.numEvents);
 
   for (size_t e = 0; e < item.numEvents; e++) {
     ProcessClass(events_[e], flags);
@@ -102,7 +104,7 @@ void ProcessClass(AnimEventGroupV2 &item, LMTConstructorProperties flags) {
 
 template <>
 void ProcessClass(AnimEventsHeaderV2 &item, LMTConstructorProperties flags) {
-  if (item.eventGroups.Check(flags.ptrStore)) {
+  if (flags.ptrStore.Check(item.eventGroups)) {
     return;
   }
 
@@ -110,9 +112,10 @@ void ProcessClass(AnimEventsHeaderV2 &item, LMTConstructorProperties flags) {
     FByteswapper(item);
   }
 
-  item.eventGroups.Fixup(flags.base, flags.ptrStore);
+  flags.ptrStore.Fixup(item.eventGroups, flags.base);
 
   AnimEventGroupV2 *groups = item.eventGroups;
+  flags.ptrStore.CheckArray(groups, item.numGroups);
 
   for (size_t e = 0; e < item.numGroups; e++) {
     ProcessClass(groups[e], flags);
@@ -219,7 +222,7 @@ void ProcessClass(LMTAnimationEventMidInterface &item,
   if (item.interface.LayoutVersion() >= LMT92) {
     auto ptr = item.interface.GroupsPtr();
 
-    if (ptr.Check(flags.ptrStore)) {
+    if (flags.ptrStore.Check(ptr)) {
       return;
     }
 
@@ -227,12 +230,15 @@ void ProcessClass(LMTAnimationEventMidInterface &item,
       clgen::EndianSwap(item.interface);
     }
 
-    ptr.Fixup(flags.base, flags.ptrStore);
+    flags.ptrStore.Fixup(ptr, flags.base);
+    flags.ptrStore.CheckArray(item.interface.GroupsLMT92(), 1);
     ProcessClass(**ptr, flags);
     item.v2.emplace(*ptr);
     return;
   }
 
+  flags.ptrStore.CheckRange(item.interface.data,
+                            item.interface.layout->totalSize);
   auto groupSpan = item.interface.Groups();
 
   if (item.interface.LayoutVersion() >= LMT56) {
@@ -240,7 +246,7 @@ void ProcessClass(LMTAnimationEventMidInterface &item,
   }
 
   for (size_t gindex = 0; auto g : groupSpan) {
-    if (g.EventsPtr().Check(flags.ptrStore)) {
+    if (flags.ptrStore.Check(g.EventsPtr())) {
       return;
     }
 
@@ -248,7 +254,8 @@ void ProcessClass(LMTAnimationEventMidInterface &item,
       clgen::EndianSwap(g);
     }
 
-    g.EventsPtr().Fixup(flags.base, flags.ptrStore);
+    flags.ptrStore.Fixup(g.EventsPtr(), flags.base);
+    flags.ptrStore.CheckArray(g.Events(), g.NumEvents());
 
     if (flags.swapEndian) {
       for (auto &a : item.GetFrames(gindex++)) {
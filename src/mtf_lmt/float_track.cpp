@@ -39,9 +39,9 @@ public:
   } {
   }
 
-  void Fixup(char *root, bool swapEndian, std::vector<void *> &ptrStore) {
+  void Fixup(char *root, bool swapEndian, FixupTracker &ptrStore) {
     for (auto g : interface.Groups()) {
-      if (g.FramesPtr().Check(ptrStore)) {
+      if (ptrStore.Check(g.FramesPtr())) {
         return;
       }
 
@@ -49,7 +49,7 @@ public:
         clgen::EndianSwap(interface);
       }
 
-      g.FramesPtr().Fixup(root, ptrStore);
+      ptrStore.Fixup(g.FramesPtr(), root);
 
       if (swapEndian) {
         auto frames = g.Frames();
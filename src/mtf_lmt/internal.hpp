@@ -16,6 +16,7 @@
 */
 
 #pragma once
+#include "../fixup_tracker.hpp"
 #include "revil/lmt.hpp"
 #include "spike/type/pointer.hpp"
 #include "spike/type/vectors_simd.hpp"
@@ -87,10 +88,10 @@ struct LMTConstructorProperties : LMTConstructorPropertiesBase {
   bool swapEndian = false; // optional, assign only
   void *dataStart = nullptr;
   char *base = nullptr;
-  std::vector<void *> &ptrStore;
+  FixupTracker &ptrStore;
 
   LMTConstructorProperties(const LMTConstructorPropertiesBase &base,
-                           std::vector<void *> &store)
+                           FixupTracker &store)
       : ptrStore(store) {
     operator=(base);
   }
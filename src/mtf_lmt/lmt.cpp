@@ -28,7 +28,7 @@ LMT::~LMT() = default;
 LMTVersion LMT::Version() const { return pi->props.version; }
 LMTArchType LMT::Architecture() const { return pi->props.arch; }
 auto LMT::CreateAnimation() const {
-  std::vector<void *> ptrStore;
+  FixupTracker ptrStore;
   LMTConstructorProperties cProps(pi->props, ptrStore);
   return LMTAnimation::Create(cProps);
 }
@@ -20,6 +20,7 @@
 #include "event.hpp"
 #include "fixup_storage.hpp"
 #include "float_track.hpp"
+#include "revil/trace.hpp"
 #include "spike/except.hpp"
 #include "spike/io/binreader.hpp"
 #include "spike/io/binwritter.hpp"
@@ -79,7 +80,7 @@ LMTAnimationInterface::Load(BinReaderRef_e rd,
   rd.Seek(0);
   rd.ReadContainer(*buff, bufferSize);
 
-  std::vector<void *> ptrStore;
+  FixupTracker ptrStore(*buff);
   LMTConstructorProperties cProps(props, ptrStore);
 
   cProps.base = buff.get()->data();
@@ -94,6 +95,7 @@ LMTAnimationInterface::Load(BinReaderRef_e rd,
 }
 
 void LMT::Load(BinReaderRef_e rd) {
+  TraceZone zone("lmt.load");
   uint32 magic;
   rd.Read(magic);
 
@@ -153,29 +155,51 @@ void LMT::Load(BinReaderRef_e rd) {
 
   Version(version, isX64 ? LMTArchType::X64 : LMTArchType::X86);
 
-  rd.ReadContainer(pi->masterBuffer, fleSize);
+  zone.Bytes(fleSize);
+
+  {
+    TraceZone readZone("lmt.read", fleSize);
+    rd.ReadContainer(pi->masterBuffer, fleSize);
+  }
+
   char *buffer = &pi->masterBuffer[0];
 
   uint32 *lookupTable = reinterpret_cast<uint32 *>(buffer + lookupTableOffset);
 
   pi->storage.resize(numBlocks);
-  std::vector<void *> ptrStore;
+  FixupTracker ptrStore(pi->masterBuffer);
 
   LMTConstructorProperties cProps(pi->props, ptrStore);
   cProps.base = buffer;
   cProps.swapEndian = rd.SwappedEndian();
+  TraceZone fixupZone("lmt.fixup", fleSize);
 
-  for (uint32 a = 0; a < numBlocks; a++) {
-    uint32 &cOffset = *(lookupTable + (a * multiplier));
+  if (isX64) {
+    uint64 *lookupTable64 = reinterpret_cast<uint64 *>(lookupTable);
+    ptrStore.CheckArray(lookupTable64, numBlocks);
 
     if (rd.SwappedEndian()) {
-      if (isX64) {
-        FByteswapper(reinterpret_cast<int64 &>(cOffset));
-      } else {
-        FByteswapper(cOffset);
+      for (uint32 a = 0; a < numBlocks; a++) {
+        FByteswapper(lookupTable64[a]);
       }
     }
 
+    ptrStore.CheckOffsets(lookupTable64, numBlocks);
+  } else {
+    ptrStore.CheckArray(lookupTable, numBlocks);
+
+    if (rd.SwappedEndian()) {
+      for (uint32 a = 0; a < numBlocks; a++) {
+        FByteswapper(lookupTable[a]);
+      }
+    }
+
+    ptrStore.CheckOffsets(lookupTable, numBlocks);
+  }
+
+  for (uint32 a = 0; a < numBlocks; a++) {
+    const uint32 cOffset = *(lookupTable + (a * multiplier));
+
     if (!cOffset) {
       continue;
     }
@@ -17,10 +17,12 @@
 
 #include "header.hpp"
 #include "pugixml.hpp"
+#include "revil/trace.hpp"
 #include "revil/xfs.hpp"
 #include "spike/io/binreader.hpp"
 #include "spike/io/binwritter.hpp"
 #include "spike/util/endian.hpp"
+#include "stream_extent.hpp"
 #include "traits.hpp"
 #include <map>
 
@@ -582,25 +584,29 @@ MODImpl::ptr LoadMODX70(BinReaderRef_e rd) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
   }
 
   rd.Seek(header.textures);
+  CheckTable(rd, header.numTextures, sizeof(MODPath<Traits::pathSize>));
   rd.ReadContainerLambda(main.paths, header.numTextures,
                          [](BinReaderRef_e rd, std::string &p) {
                            MODPath<Traits::pathSize> path;
                            rd.Read(path);
                            p = path.path;
                          });
+  CheckTable(rd, header.numMaterials, sizeof(main.materials[0].main));
   rd.ReadContainer(main.materials, header.numMaterials);
 
   rd.Seek(header.meshes);
-  rd.ReadContainer(main.meshes, header.numMeshes);
+  ReadTable(rd, main.meshes, header.numMeshes);
 
   main.unkBufferSize = header.unkBufferSize;
 
+  CheckExtent(rd.GetSize(), header.vertexBuffer, header.vertexBufferSize, 1);
+  CheckExtent(rd.GetSize(), header.unkBuffer, header.unkBufferSize, 1);
   main.vertexBuffer.resize(header.vertexBufferSize + main.unkBufferSize);
 
   rd.Seek(header.vertexBuffer);
@@ -613,7 +619,7 @@ MODImpl::ptr LoadMODX70(BinReaderRef_e rd) {
   }
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -628,35 +634,37 @@ MODImpl::ptr LoadMODXC5(BinReaderRef_e rd) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
     rd.Read(main.remaps);
   }
 
   if (header.numGroups) {
     rd.Seek(header.groups);
-    rd.ReadContainer(main.groups, header.numGroups);
+    ReadTable(rd, main.groups, header.numGroups);
   }
 
   rd.Seek(header.textures);
+  CheckTable(rd, header.numTextures, sizeof(MODPath<MODTraitsXC5::pathSize>));
   rd.ReadContainerLambda(main.paths, header.numTextures,
                          [](BinReaderRef_e rd, std::string &p) {
                            MODPath<MODTraitsXC5::pathSize> path;
                            rd.Read(path);
                            p = path.path;
                          });
+  CheckTable(rd, header.numMaterials, sizeof(main.materials[0].main));
   rd.ReadContainer(main.materials, header.numMaterials);
 
   rd.Seek(header.meshes);
-  rd.ReadContainer(main.meshes, header.numMeshes);
-  rd.ReadContainer(main.envelopes);
+  ReadTable(rd, main.meshes, header.numMeshes);
+  ReadTable(rd, main.envelopes);
 
   rd.Seek(header.vertexBuffer);
-  rd.ReadContainer(main.vertexBuffer, header.vertexBufferSize);
+  ReadTable(rd, main.vertexBuffer, header.vertexBufferSize);
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -671,39 +679,42 @@ MODImpl::ptr LoadMODXC3(BinReaderRef_e rd) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
     rd.Read(main.remaps);
   }
 
   if (header.numGroups) {
     rd.Seek(header.groups);
-    rd.ReadContainer(main.groups, header.numGroups);
+    ReadTable(rd, main.groups, header.numGroups);
   }
 
   rd.Seek(header.textures);
+  CheckTable(rd, header.numTextures, sizeof(MODPath<MODTraitsXC5::pathSize>));
   rd.ReadContainerLambda(main.paths, header.numTextures,
                          [](BinReaderRef_e rd, std::string &p) {
                            MODPath<MODTraitsXC5::pathSize> path;
                            rd.Read(path);
                            p = path.path;
                          });
+  CheckTable(rd, header.numMaterials, sizeof(main.materials[0].main));
   rd.ReadContainer(main.materials, header.numMaterials);
 
   rd.Seek(header.meshes);
+  CheckTable(rd, header.numMeshes, sizeof(main.meshes[0]) + 8);
   rd.ReadContainerLambda(main.meshes, header.numMeshes,
                          [](BinReaderRef_e rd, auto &m) {
                            rd.Read(m);
                            rd.Skip(8);
                          });
-  rd.ReadContainer(main.envelopes);
+  ReadTable(rd, main.envelopes);
 
   rd.Seek(header.vertexBuffer);
-  rd.ReadContainer(main.vertexBuffer, header.vertexBufferSize);
+  ReadTable(rd, main.vertexBuffer, header.vertexBufferSize);
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -719,33 +730,37 @@ template <class Traits> MODImpl::ptr LoadMODX99(BinReaderRef_e rd) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
     rd.Read(main.remaps);
-    rd.ReadContainer(main.skinRemaps, header.numBoneMaps);
+    ReadTable(rd, main.skinRemaps, header.numBoneMaps);
   }
 
   if (header.numGroups) {
     rd.Seek(header.groups);
-    rd.ReadContainer(main.groups, header.numGroups);
+    ReadTable(rd, main.groups, header.numGroups);
   }
 
   rd.Seek(header.textures);
+  CheckTable(rd, header.numTextures, sizeof(MODPath<Traits::pathSize>));
   rd.ReadContainerLambda(main.paths, header.numTextures,
                          [](BinReaderRef_e rd, std::string &p) {
                            MODPath<Traits::pathSize> path;
                            rd.Read(path);
                            p = path.path;
                          });
+  CheckTable(rd, header.numMaterials, sizeof(main.materials[0].main));
   rd.ReadContainer(main.materials, header.numMaterials);
 
   rd.Seek(header.meshes);
-  rd.ReadContainer(main.meshes, header.numMeshes);
-  rd.ReadContainer(main.envelopes);
+  ReadTable(rd, main.meshes, header.numMeshes);
+  ReadTable(rd, main.envelopes);
 
   main.unkBufferSize = header.unkBufferSize;
 
+  CheckExtent(rd.GetSize(), header.vertexBuffer, header.vertexBufferSize, 1);
+  CheckExtent(rd.GetSize(), header.unkBuffer, header.unkBufferSize, 1);
   main.vertexBuffer.resize(header.vertexBufferSize + main.unkBufferSize);
 
   rd.Seek(header.vertexBuffer);
@@ -758,7 +773,7 @@ template <class Traits> MODImpl::ptr LoadMODX99(BinReaderRef_e rd) {
   }
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -778,20 +793,22 @@ template <class Traits> MODImpl::ptr LoadMODXD2x32(BinReaderRef_e rd) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
     rd.Read(main.remaps);
   }
 
   if (header.numGroups) {
     rd.Seek(header.groups);
-    rd.ReadContainer(main.groups, header.numGroups);
+    ReadTable(rd, main.groups, header.numGroups);
   }
 
+  CheckTable(rd, header.numMaterials, sizeof(main.materials[0].main));
   rd.ReadContainer(main.materials, header.numMaterials);
 
   rd.Seek(header.meshes);
+  CheckTable(rd, header.numMeshes, sizeof(main.meshes[0]) + 8);
   rd.ReadContainerLambda(main.meshes, header.numMeshes,
                          [](BinReaderRef_e rd, auto &m) {
                            rd.Read(m);
@@ -799,16 +816,16 @@ template <class Traits> MODImpl::ptr LoadMODXD2x32(BinReaderRef_e rd) {
                          });
 
   if constexpr (std::is_same_v<MODMetaDataV2, typename Traits::metadata>) {
-    rd.ReadContainer(main.envelopes, main.metadata.numEnvelopes);
+    ReadTable(rd, main.envelopes, main.metadata.numEnvelopes);
   } else {
-    rd.ReadContainer(main.envelopes);
+    ReadTable(rd, main.envelopes);
   }
 
   rd.Seek(header.vertexBuffer);
-  rd.ReadContainer(main.vertexBuffer, header.vertexBufferSize);
+  ReadTable(rd, main.vertexBuffer, header.vertexBufferSize);
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -824,33 +841,34 @@ template <class Traits> MODImpl::ptr LoadMODXDxLEx32(BinReaderRef_e rdn) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
     rd.Read(main.remaps);
   }
 
   if (header.numGroups) {
     rd.Seek(header.groups);
-    rd.ReadContainer(main.groups, header.numGroups);
+    ReadTable(rd, main.groups, header.numGroups);
   }
 
+  CheckTable(rdn, header.numMaterials, sizeof(main.materials[0].main));
   rdn.ReadContainer(main.materials, header.numMaterials);
 
   rd.Seek(header.meshes);
-  rd.ReadContainer(main.meshes, header.numMeshes);
+  ReadTable(rd, main.meshes, header.numMeshes);
 
   if constexpr (std::is_same_v<MODMetaDataV2, typename Traits::metadata>) {
-    rd.ReadContainer(main.envelopes, main.metadata.numEnvelopes);
+    ReadTable(rd, main.envelopes, main.metadata.numEnvelopes);
   } else {
-    rd.ReadContainer(main.envelopes);
+    ReadTable(rd, main.envelopes);
   }
 
   rd.Seek(header.vertexBuffer);
-  rd.ReadContainer(main.vertexBuffer, header.vertexBufferSize);
+  ReadTable(rd, main.vertexBuffer, header.vertexBufferSize);
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -879,32 +897,34 @@ MODImpl::ptr LoadMODXDxLE(BinReaderRef_e rdn) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
     rd.Read(main.remaps);
   }
 
   if (header.numGroups) {
     rd.Seek(header.groups);
-    rd.ReadContainer(main.groups, header.numGroups);
+    ReadTable(rd, main.groups, header.numGroups);
   }
 
+  CheckTable(rdn, header.numMaterials, sizeof(main.materials[0].main));
   rdn.ReadContainer(main.materials, header.numMaterials);
 
   rd.Seek(header.meshes);
+  CheckTable(rdn, header.numMeshes, sizeof(main.meshes[0]) + 8);
   rdn.ReadContainerLambda(main.meshes, header.numMeshes,
                           [](BinReaderRef_e rd, auto &m) {
                             rd.Read(m);
                             rd.Skip(8);
                           });
-  rd.ReadContainer(main.envelopes, main.metadata.numEnvelopes);
+  ReadTable(rd, main.envelopes, main.metadata.numEnvelopes);
 
   rd.Seek(header.vertexBuffer);
-  rd.ReadContainer(main.vertexBuffer, header.vertexBufferSize);
+  ReadTable(rd, main.vertexBuffer, header.vertexBufferSize);
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -921,33 +941,35 @@ MODImpl::ptr LoadMODX06(BinReaderRef_e rdn) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
     rd.Read(main.remaps);
-    rd.ReadContainer(main.skinRemaps, header.numSkins);
+    ReadTable(rd, main.skinRemaps, header.numSkins);
   }
 
   if (header.numGroups) {
     rd.Seek(header.groups);
-    rd.ReadContainer(main.groups, header.numGroups);
+    ReadTable(rd, main.groups, header.numGroups);
   }
 
+  CheckTable(rdn, header.numMaterials, sizeof(main.materials[0].main));
   rdn.ReadContainer(main.materials, header.numMaterials);
 
   rd.Seek(header.meshes);
+  CheckTable(rdn, header.numMeshes, sizeof(main.meshes[0]) + 8);
   rdn.ReadContainerLambda(main.meshes, header.numMeshes,
                           [](BinReaderRef_e rd, auto &m) {
                             rd.Read(m);
                             rd.Skip(8);
                           });
-  rd.ReadContainer(main.envelopes);
+  ReadTable(rd, main.envelopes);
 
   rd.Seek(header.vertexBuffer);
-  rd.ReadContainer(main.vertexBuffer, header.vertexBufferSize);
+  ReadTable(rd, main.vertexBuffer, header.vertexBufferSize);
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -963,29 +985,30 @@ MODImpl::ptr LoadMODXE5(BinReaderRef_e rd) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
     rd.Read(main.remaps);
-    rd.ReadContainer(main.skinRemaps, header.numSkins);
+    ReadTable(rd, main.skinRemaps, header.numSkins);
   }
 
   if (header.numGroups) {
     rd.Seek(header.groups);
-    rd.ReadContainer(main.groups, header.numGroups);
+    ReadTable(rd, main.groups, header.numGroups);
   }
 
+  CheckTable(rd, header.numMaterials, sizeof(main.materials[0].main));
   rd.ReadContainer(main.materials, header.numMaterials);
 
   rd.Seek(header.meshes);
-  rd.ReadContainer(main.meshes, header.numMeshes);
-  rd.ReadContainer(main.envelopes);
+  ReadTable(rd, main.meshes, header.numMeshes);
+  ReadTable(rd, main.envelopes);
 
   rd.Seek(header.vertexBuffer);
-  rd.ReadContainer(main.vertexBuffer, header.vertexBufferSize);
+  ReadTable(rd, main.vertexBuffer, header.vertexBufferSize);
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -1001,32 +1024,34 @@ MODImpl::ptr LoadMODXFF2C(BinReaderRef_e rd) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
     rd.Read(main.remaps);
   }
 
   if (header.numGroups) {
     rd.Seek(header.groups);
-    rd.ReadContainer(main.groups, header.numGroups);
+    ReadTable(rd, main.groups, header.numGroups);
   }
 
+  CheckTable(rd, header.numMaterials, sizeof(main.materials[0].main));
   rd.ReadContainer(main.materials, header.numMaterials);
 
   rd.Seek(header.meshes);
+  CheckTable(rd, header.numMeshes, sizeof(main.meshes[0]) + 8);
   rd.ReadContainerLambda(main.meshes, header.numMeshes,
                          [](BinReaderRef_e rd, auto &m) {
                            rd.Read(m);
                            rd.Skip(8);
                          });
-  rd.ReadContainer(main.envelopes);
+  ReadTable(rd, main.envelopes);
 
   rd.Seek(header.vertexBuffer);
-  rd.ReadContainer(main.vertexBuffer, header.vertexBufferSize);
+  ReadTable(rd, main.vertexBuffer, header.vertexBufferSize);
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -1061,16 +1086,16 @@ MODImpl::ptr LoadMODX21(BinReaderRef_e rd) {
 
   if (header.numBones) {
     rd.Seek(header.bones);
-    rd.ReadContainer(main.bones, header.numBones);
-    rd.ReadContainer(main.refPoses, header.numBones);
-    rd.ReadContainer(main.transforms, header.numBones);
+    ReadTable(rd, main.bones, header.numBones);
+    ReadTable(rd, main.refPoses, header.numBones);
+    ReadTable(rd, main.transforms, header.numBones);
     rd.Read(main.remaps);
     // skins??
   }
 
   if (header.numGroups) {
     rd.Seek(header.groups);
-    rd.ReadContainer(main.groups, header.numGroups);
+    ReadTable(rd, main.groups, header.numGroups);
   }
 
   rd.Seek(header.materials);
@@ -1079,14 +1104,14 @@ MODImpl::ptr LoadMODX21(BinReaderRef_e rd) {
   main.materials = XFSToMaterials(materials);
 
   rd.Seek(header.meshes);
-  rd.ReadContainer(main.meshes, header.numMeshes);
-  rd.ReadContainer(main.envelopes);
+  ReadTable(rd, main.meshes, header.numMeshes);
+  ReadTable(rd, main.envelopes);
 
   rd.Seek(header.vertexBuffer);
-  rd.ReadContainer(main.vertexBuffer, header.vertexBufferSize);
+  ReadTable(rd, main.vertexBuffer, header.vertexBufferSize);
 
   rd.Seek(header.indices);
-  rd.ReadContainer(main.indexBuffer, header.numIndices);
+  ReadTable(rd, main.indexBuffer, header.numIndices);
 
   return std::make_unique<decltype(main)>(std::move(main));
 }
@@ -1151,6 +1176,7 @@ void MOD::Load(const std::string &fileName) {
 }
 
 void MOD::Load(BinReaderRef_e rd) {
+  TraceZone zone("mod.load");
   MODHeaderCommon header;
   rd.Push();
   rd.Read(header);
@@ -1174,5 +1200,7 @@ void MOD::Load(BinReaderRef_e rd) {
   }
 
   pi = found->second(rd);
+  zone.Bytes(rd.Tell());
+  TraceZone reflectZone("mod.reflect");
   pi->Reflect(rd.SwappedEndian());
 }
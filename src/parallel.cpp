@@ -0,0 +1,154 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace revil {
+namespace {
+struct ParallelJob {
+  const std::function<void(size_t, size_t)> &fn;
+  size_t count;
+  size_t chunkSize;
+  size_t numChunks;
+  std::atomic<size_t> nextChunk{0};
+  std::atomic_bool failed{false};
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable finished;
+  size_t numFinished = 0;
+
+  ParallelJob(const std::function<void(size_t, size_t)> &fn_, size_t count_,
+              size_t maxChunks)
+      : fn(fn_), count(count_), chunkSize((count_ + maxChunks - 1) / maxChunks),
+        numChunks((count_ + chunkSize - 1) / chunkSize) {}
+
+  bool Exhausted() const { return nextChunk.load() >= numChunks; }
+
+  void Run() {
+    for (size_t c; (c = nextChunk.fetch_add(1)) < numChunks;) {
+      if (!failed) {
+        try {
+          fn(c * chunkSize, std::min(count, (c + 1) * chunkSize));
+        } catch (...) {
+          std::lock_guard<std::mutex> lg(mutex);
+
+          if (!error) {
+            error = std::current_exception();
+            failed = true;
+          }
+        }
+      }
+
+      std::lock_guard<std::mutex> lg(mutex);
+
+      if (++numFinished == numChunks) {
+        finished.notify_all();
+      }
+    }
+  }
+};
+
+class ThreadPool {
+public:
+  const size_t numThreads;
+
+  ThreadPool()
+      : numThreads(std::max(1U, std::thread::hardware_concurrency())) {
+    for (size_t t = 1; t < numThreads; t++) {
+      std::thread([this] { Work(); }).detach();
+    }
+  }
+
+  void Submit(std::shared_ptr<ParallelJob> job) {
+    {
+      std::lock_guard<std::mutex> lg(mutex);
+      jobs.emplace_back(std::move(job));
+    }
+
+    available.notify_all();
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable available;
+  // Jobs with chunks left to claim, exhausted ones are dropped by workers
+  std::deque<std::shared_ptr<ParallelJob>> jobs;
+
+  void Work() {
+    for (;;) {
+      std::shared_ptr<ParallelJob> job;
+
+      {
+        std::unique_lock<std::mutex> lk(mutex);
+        available.wait(lk, [&] {
+          while (!jobs.empty() && jobs.front()->Exhausted()) {
+            jobs.pop_front();
+          }
+
+          return !jobs.empty();
+        });
+        job = jobs.front();
+      }
+
+      job->Run();
+    }
+  }
+};
+
+// Never destroyed, workers are blocked on pool until process exits
+ThreadPool &Pool() {
+  static ThreadPool *pool = new ThreadPool;
+  return *pool;
+}
+} // namespace
+
+void ParallelChunks(size_t count,
+                    const std::function<void(size_t, size_t)> &fn) {
+  ThreadPool &pool = Pool();
+
+  if (count < 2 || pool.numThreads < 2) {
+    if (count) {
+      fn(0, count);
+    }
+
+    return;
+  }
+
+  // More chunks than threads, balances load of concurrent callers
+  auto job = std::make_shared<ParallelJob>(
+      fn, count, std::min(count, pool.numThreads * 4));
+  pool.Submit(job);
+  job->Run();
+
+  {
+    std::unique_lock<std::mutex> lk(job->mutex);
+    job->finished.wait(lk, [&] { return job->numFinished == job->numChunks; });
+  }
+
+  if (job->error) {
+    std::rethrow_exception(job->error);
+  }
+}
+} // namespace revil
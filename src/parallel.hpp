@@ -0,0 +1,39 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "revil/settings.hpp"
+#include <cstddef>
+#include <functional>
+
+namespace revil {
+// Runs fn(begin, end) for contiguous chunks of [0, count) on shared pool
+// Pool has one worker less than hardware threads, calling thread takes part,
+// so concurrent and nested calls don't multiply number of threads
+// First exception thrown by any chunk is rethrown after all chunks are done,
+// chunks not yet started are skipped
+void RE_EXTERN ParallelChunks(size_t count,
+                              const std::function<void(size_t, size_t)> &fn);
+
+template <class Fn> void ParallelFor(size_t count, Fn &&fn) {
+  ParallelChunks(count, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      fn(i);
+    }
+  });
+}
+} // namespace revil
@@ -44,7 +44,7 @@ void REAssetImpl::Load(BinReaderRef rd) {
   const size_t fleSize = rd.GetSize();
   rd.ReadContainer(internalBuffer, fleSize);
   buffer = internalBuffer.data();
-  std::vector<void *> ptrStore;
+  revil::FixupTracker ptrStore(internalBuffer);
   Fixup(ptrStore);
 }
 
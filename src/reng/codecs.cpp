@@ -18,8 +18,50 @@
 #include "motion_78.hpp"
 #include "spike/master_printer.hpp"
 #include "spike/type/vectors_simd.hpp"
+#include <algorithm>
 #include <unordered_map>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// Unpacks 3 unsigned components of numBits from every key into SoA buffer
+static void UnpackKeys(const uint64 *keys, size_t numKeys, uint32 numBits,
+                       float *out) {
+  const uint64 mask = (uint64(1) << numBits) - 1;
+  size_t i = 0;
+
+#if defined(__x86_64__) || defined(_M_X64)
+  const __m128i vMask = _mm_set1_epi64x(mask);
+
+  for (; i + 4 <= numKeys; i += 4) {
+    const __m128i lo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i + 2));
+
+    for (uint32 c = 0; c < 3; c++) {
+      const __m128i shift = _mm_cvtsi32_si128(c * numBits);
+      const __m128i cLo = _mm_and_si128(_mm_srl_epi64(lo, shift), vMask);
+      const __m128i cHi = _mm_and_si128(_mm_srl_epi64(hi, shift), vMask);
+      // Components fit into low dwords, gather 4 keys into one register
+      const __m128 packed =
+          _mm_shuffle_ps(_mm_castsi128_ps(cLo), _mm_castsi128_ps(cHi),
+                         _MM_SHUFFLE(2, 0, 2, 0));
+      _mm_storeu_ps(out + c * numKeys + i,
+                    _mm_cvtepi32_ps(_mm_castps_si128(packed)));
+    }
+  }
+#endif
+
+  for (; i < numKeys; i++) {
+    for (uint32 c = 0; c < 3; c++) {
+      out[c * numKeys + i] =
+          static_cast<float>((keys[i] >> (c * numBits)) & mask);
+    }
+  }
+}
+
 struct RETrackController_internal : RETrackController {
   enum FrameType { FrameType_short = 4, FrameType_char = 2 };
   struct {
@@ -34,17 +76,27 @@ struct RETrackController_internal : RETrackController {
   std::string dataBuffer;
 
   template <class C> void Assign_(C *data) {
-    frameType = static_cast<FrameType>((data->flags >> 20) & 0xf);
+    Assign(RETrackCurveData{
+        .flags = data->flags,
+        .numFrames = data->numFrames,
+        .frames = data->frames.operator->(),
+        .controlPoints = data->controlPoints.operator->(),
+        .minMaxBounds = data->minMaxBounds.operator->(),
+    });
+  }
+
+  void Assign(const RETrackCurveData &data) {
+    frameType = static_cast<FrameType>((data.flags >> 20) & 0xf);
 
-    if (data->minMaxBounds) {
-      minMaxBounds.max = Vector4A16(data->minMaxBounds->max);
-      minMaxBounds.min = Vector4A16(data->minMaxBounds->min);
+    if (data.minMaxBounds) {
+      minMaxBounds.max = Vector4A16(data.minMaxBounds->max);
+      minMaxBounds.min = Vector4A16(data.minMaxBounds->min);
     }
 
-    componentID = ((data->flags >> 12) & 0xf) - 1;
-    frames = data->frames.operator->();
-    numFrames = data->numFrames;
-    Assign(data->controlPoints.operator->());
+    componentID = ((data.flags >> 12) & 0xf) - 1;
+    frames = data.frames;
+    numFrames = data.numFrames;
+    Assign(data.controlPoints);
   }
 
   virtual void Assign(char *data) = 0;
@@ -80,6 +132,54 @@ struct RETrackController_internal : RETrackController {
 
     return retval;
   }
+
+  void Decode(float *out) const override {
+    for (uint32 i = 0; i < numFrames; i++) {
+      Vector4A16 value{};
+      Evaluate(i, value);
+
+      for (uint32 c = 0; c < 4; c++) {
+        out[c * numFrames + i] = value[c];
+      }
+    }
+  }
+
+  // Bulk Evaluate of bit packed 3 component codecs
+  template <class Fetch>
+  void DecodeBiLinear(float *out, uint32 numBits, Fetch &&fetch) const {
+    std::vector<uint64> keys(numFrames);
+
+    for (uint32 i = 0; i < numFrames; i++) {
+      keys[i] = fetch(i);
+    }
+
+    UnpackKeys(keys.data(), numFrames, numBits, out);
+    const float multiplier =
+        1.0f / static_cast<float>((uint64(1) << numBits) - 1);
+
+    for (uint32 c = 0; c < 3; c++) {
+      const float min = minMaxBounds.min[c];
+      const float max = minMaxBounds.max[c];
+      float *values = out + c * numFrames;
+
+      for (uint32 i = 0; i < numFrames; i++) {
+        values[i] = ((values[i] * multiplier) * min) + max;
+      }
+    }
+
+    std::fill_n(out + 3 * numFrames, numFrames,
+                ((0.f * multiplier) * minMaxBounds.min.W) +
+                    minMaxBounds.max.W);
+  }
+
+  void ComputeQuatElements(float *out) const {
+    for (uint32 i = 0; i < numFrames; i++) {
+      Vector4A16 value(out[i], out[numFrames + i], out[2 * numFrames + i],
+                       0.f);
+      value.QComputeElement();
+      out[3 * numFrames + i] = value.W;
+    }
+  }
 };
 
 struct LinearVector3Controller : RETrackController_internal {
@@ -124,6 +224,11 @@ struct BiLinearVector3_5bitController : RETrackController_internal {
     out = data & componentMask;
     out = ((out * componentMultiplier) * minMaxBounds.min) + minMaxBounds.max;
   }
+
+  void Decode(float *out) const override {
+    DecodeBiLinear(out, 5, [&](uint32 id) { return dataStorage[id]; });
+  }
+
   const char *CodecName() const override {
     return "BiLinearVector3_5bitController";
   }
@@ -153,6 +258,11 @@ struct BiLinearVector3_10bitController : RETrackController_internal {
     out = data & componentMask;
     out = ((out * componentMultiplier) * minMaxBounds.min) + minMaxBounds.max;
   }
+
+  void Decode(float *out) const override {
+    DecodeBiLinear(out, 10, [&](uint32 id) { return dataStorage[id]; });
+  }
+
   const char *CodecName() const override {
     return "BiLinearVector3_10bitController";
   }
@@ -182,6 +292,11 @@ struct BiLinearVector3_21bitController : RETrackController_internal {
     out = data & componentMask;
     out = ((out * componentMultiplier) * minMaxBounds.min) + minMaxBounds.max;
   }
+
+  void Decode(float *out) const override {
+    DecodeBiLinear(out, 21, [&](uint32 id) { return dataStorage[id]; });
+  }
+
   const char *CodecName() const override {
     return "BiLinearVector3_21bitController";
   }
@@ -216,6 +331,20 @@ struct BiLinearQuat3_13bitController : RETrackController_internal {
     out *= Vector4A16(1.f, 1.f, 1.f, 0.0f);
     out.QComputeElement();
   }
+
+  void Decode(float *out) const override {
+    DecodeBiLinear(out, 13, [&](uint32 id) {
+      uint64 retreived = 0;
+
+      for (uint8 b : dataStorage[id].data) {
+        retreived = (retreived << 8) | b;
+      }
+
+      return retreived;
+    });
+    ComputeQuatElements(out);
+  }
+
   const char *CodecName() const override {
     return "BiLinearQuat3_13bitController";
   }
@@ -240,6 +369,16 @@ struct BiLinearQuat3_16bitController : RETrackController_internal {
     out *= Vector4A16(1.f, 1.f, 1.f, 0.0f);
     out.QComputeElement();
   }
+
+  void Decode(float *out) const override {
+    DecodeBiLinear(out, 16, [&](uint32 id) {
+      const USVector &retreived = dataStorage[id];
+      return uint64(retreived.X) | (uint64(retreived.Y) << 16) |
+             (uint64(retreived.Z) << 32);
+    });
+    ComputeQuatElements(out);
+  }
+
   const char *CodecName() const override {
     return "BiLinearQuat3_16bitController";
   }
@@ -278,6 +417,20 @@ struct BiLinearQuat3_18bitController : RETrackController_internal {
     out *= Vector4A16(1.f, 1.f, 1.f, 0.0f);
     out.QComputeElement();
   }
+
+  void Decode(float *out) const override {
+    DecodeBiLinear(out, 18, [&](uint32 id) {
+      uint64 retreived = 0;
+
+      for (uint8 b : dataStorage[id].data) {
+        retreived = (retreived << 8) | b;
+      }
+
+      return retreived;
+    });
+    ComputeQuatElements(out);
+  }
+
   const char *CodecName() const override {
     return "BiLinearQuat3_18bitController";
   }
@@ -334,6 +487,12 @@ struct BiLinearQuat3_5bitController : BiLinearVector3_5bitController {
     out *= Vector4A16(1.f, 1.f, 1.f, 0.0f);
     out.QComputeElement();
   }
+
+  void Decode(float *out) const override {
+    BiLinearVector3_5bitController::Decode(out);
+    ComputeQuatElements(out);
+  }
+
   const char *CodecName() const override {
     return "BiLinearQuat3_5bitController";
   }
@@ -353,6 +512,12 @@ struct BiLinearQuat3_10bitController : BiLinearVector3_10bitController {
     out *= Vector4A16(1.f, 1.f, 1.f, 0.0f);
     out.QComputeElement();
   }
+
+  void Decode(float *out) const override {
+    BiLinearVector3_10bitController::Decode(out);
+    ComputeQuatElements(out);
+  }
+
   const char *CodecName() const override {
     return "BiLinearQuat3_10bitController";
   }
@@ -372,6 +537,12 @@ struct BiLinearQuat3_21bitController : BiLinearVector3_21bitController {
     out *= Vector4A16(1.f, 1.f, 1.f, 0.0f);
     out.QComputeElement();
   }
+
+  void Decode(float *out) const override {
+    BiLinearVector3_21bitController::Decode(out);
+    ComputeQuatElements(out);
+  }
+
   const char *CodecName() const override {
     return "BiLinearQuat3_21bitController";
   }
@@ -560,20 +731,6 @@ static const std::unordered_map<uint32, ptr_type_ (*)()> curveControllers = {
     make<BiLinearQuat3_21bitController, 1>(),
 };
 
-RETrackController::Ptr RETrackCurve65::GetController() {
-  const uint32 type = flags & 0xff0fffff;
-
-  if (curveControllers.count(type)) {
-    auto iCon = curveControllers.at(type)();
-    iCon->Assign(this);
-    return iCon;
-  } else {
-    printerror("[RETrackController]: Unhandled curve compression: " << std::hex
-                                                                    << type);
-  }
-
-  return {};
-}
 
 static const std::unordered_map<uint32, ptr_type_ (*)()> curveControllers78 = {
     make<LinearVector3Controller>(),
@@ -610,20 +767,6 @@ static const std::unordered_map<uint32, ptr_type_ (*)()> curveControllers78 = {
     make<BiLinearQuat3_21bitController, 2>(),
 };
 
-RETrackController::Ptr RETrackCurve78::GetController() {
-  const uint32 type = flags & 0xff0fffff;
-
-  if (curveControllers78.count(type)) {
-    auto iCon = curveControllers78.at(type)();
-    iCon->Assign(this);
-    return iCon;
-  } else {
-    printerror("[RETrackController]: Unhandled curve compression: " << std::hex
-                                                                    << type);
-  }
-
-  return {};
-}
 
 static const std::unordered_map<uint32, ptr_type_ (*)()> curveControllers43 = {
     make<LinearVector3Controller>(),
@@ -641,17 +784,79 @@ static const std::unordered_map<uint32, ptr_type_ (*)()> curveControllers43 = {
     make<BiLinearQuat3_21bitController, 1>(),
 };
 
-RETrackController::Ptr RETrackCurve43::GetController() {
+static const std::unordered_map<uint32, ptr_type_ (*)()> &
+CurveControllers(uint32 curveVersion) {
+  switch (curveVersion) {
+  case 43:
+    return curveControllers43;
+  case 65:
+    return curveControllers;
+  default:
+    return curveControllers78;
+  }
+}
+
+static ptr_type_ MakeController(uint32 curveVersion, uint32 flags) {
   const uint32 type = flags & 0xff0fffff;
+  auto &controllers = CurveControllers(curveVersion);
 
-  if (curveControllers43.count(type)) {
-    auto iCon = curveControllers43.at(type)();
-    iCon->Assign(this);
-    return iCon;
-  } else {
-    printerror("[RETrackController]: Unhandled curve compression: " << std::hex
-                                                                    << type);
+  if (auto found = controllers.find(type); found != controllers.end()) {
+    return found->second();
   }
 
+  printerror("[RETrackController]: Unhandled curve compression: " << std::hex
+                                                                  << type);
   return {};
 }
+
+RETrackController::Ptr RETrackCurve43::GetController() {
+  auto iCon = MakeController(43, flags);
+
+  if (iCon) {
+    iCon->Assign(this);
+  }
+
+  return iCon;
+}
+
+RETrackController::Ptr RETrackCurve65::GetController() {
+  auto iCon = MakeController(65, flags);
+
+  if (iCon) {
+    iCon->Assign(this);
+  }
+
+  return iCon;
+}
+
+RETrackController::Ptr RETrackCurve78::GetController() {
+  auto iCon = MakeController(78, flags);
+
+  if (iCon) {
+    iCon->Assign(this);
+  }
+
+  return iCon;
+}
+
+RETrackController::Ptr CreateRETrackController(uint32 curveVersion,
+                                               const RETrackCurveData &curve) {
+  auto iCon = MakeController(curveVersion, curve.flags);
+
+  if (iCon) {
+    iCon->Assign(curve);
+  }
+
+  return iCon;
+}
+
+std::vector<uint32> RETrackCurveTypes(uint32 curveVersion) {
+  std::vector<uint32> retVal;
+
+  for (auto &[type, _] : CurveControllers(curveVersion)) {
+    retVal.emplace_back(type);
+  }
+
+  std::sort(retVal.begin(), retVal.end());
+  return retVal;
+}
@@ -16,20 +16,24 @@
 */
 
 #include "motion_43.hpp"
+#include <algorithm>
 
 template <> void ProcessClass(REMotionBone &item, ProcessFlags flags) {
-  es::FixupPointers(flags.base, *flags.ptrStore, item.boneName,
-                    item.parentBoneNamePtr, item.firstChildBoneNamePtr,
-                    item.lastChildBoneNamePtr);
+  flags.ptrStore->CheckArray(&item, 1);
+  flags.ptrStore->FixupPointers(flags.base, item.boneName,
+                                item.parentBoneNamePtr,
+                                item.firstChildBoneNamePtr,
+                                item.lastChildBoneNamePtr);
 }
 
 template <> void ProcessClass(RETrackCurve43 &item, ProcessFlags flags) {
-  es::FixupPointers(flags.base, *flags.ptrStore, item.frames,
-                    item.controlPoints, item.minMaxBounds);
+  flags.ptrStore->CheckArray(&item, 1);
+  flags.ptrStore->FixupPointers(flags.base, item.frames, item.controlPoints,
+                                item.minMaxBounds);
 }
 
 template <> void ProcessClass(REMotionTrack43 &item, ProcessFlags flags) {
-  if (!es::FixupPointers(flags.base, *flags.ptrStore, item.curves)) {
+  if (!flags.ptrStore->FixupPointers(flags.base, item.curves)) {
     return;
   }
 
@@ -44,19 +48,31 @@ template <> void ProcessClass(REMotionTrack43 &item, ProcessFlags flags) {
 
 template <> void ProcessClass(REMotion43 &item, ProcessFlags flags) {
   flags.base = reinterpret_cast<char *>(&item);
-  if (!es::FixupPointers(flags.base, *flags.ptrStore, item.bones, item.tracks,
-                         item.unkOffset02, item.animationName)) {
-    return;
-  }
+  flags.ptrStore->CheckArray(&item, 1);
+
+  flags.ptrStore->FixupPointers(flags.base, item.unkOffset02,
+                                item.animationName);
+
+  // Overlapping motions can share bone header, only worker that fixed
+  // a pointer processes its data
+  if (flags.ptrStore->Fixup(item.bones, flags.base) && item.bones) {
+    flags.ptrStore->CheckArray(item.bones.operator->(), 1);
+
+    if (flags.ptrStore->Fixup(item.bones->ptr, flags.base)) {
+      flags.ptrStore->CheckArray(item.bones->ptr.operator->(), item.numBones);
 
-  if (item.bones) {
-    item.bones->ptr.Fixup(flags.base);
+      for (size_t b = 0; b < item.numBones; b++) {
+        ProcessClass(item.bones->ptr[b], flags);
+      }
+    }
   }
 
-  for (size_t b = 0; b < item.numBones; b++) {
-    ProcessClass(item.bones->ptr[b], flags);
+  if (!flags.ptrStore->Fixup(item.tracks, flags.base)) {
+    return;
   }
 
+  flags.ptrStore->CheckArray(item.tracks.operator->(), item.numTracks);
+
   for (size_t b = 0; b < item.numTracks; b++) {
     ProcessClass(item.tracks[b], flags);
   }
@@ -93,41 +109,77 @@ static Vector4A16 slerp(const Vector4A16 &v0, const Vector4A16 &_v1, float t) {
   return (v0 * s0) + (v1 * s1);
 }
 
-void REMotionTrackWorker::GetValue(Vector4A16 &output, float time) const {
-  // bugfix, some codecs will partialy apply elements, ensure we have identity
-  output = Vector4A16{};
+const RETrackCache &REMotionTrackWorker::Cache() const {
+  std::call_once(cache->decoded, [&] {
+    cache->frames.resize(numFrames);
 
-  if (!controller) {
-    return;
+    for (uint32 f = 0; f < numFrames; f++) {
+      cache->frames[f] = controller->GetFrame(f);
+    }
+
+    cache->values.resize(size_t(numFrames) * 4);
+    controller->Decode(cache->values.data());
+  });
+
+  return *cache;
+}
+
+// Same as std::lower_bound, but starts from span of previous sample
+static uint32 FindSpan(const std::vector<int32> &frames, int32 frame,
+                       uint32 hint) {
+  auto begin = frames.begin();
+  auto end = frames.end();
+  auto cur = begin + std::min<size_t>(hint, frames.size());
+
+  if (cur != end && *cur < frame) {
+    // Usually next span
+    if (++cur != end && *cur < frame) {
+      cur = std::lower_bound(cur + 1, end, frame);
+    }
+  } else if (cur != begin && *(cur - 1) >= frame) {
+    cur = std::lower_bound(begin, cur - 1, frame);
   }
 
+  return static_cast<uint32>(std::distance(begin, cur));
+}
+
+void REMotionTrackWorker::Sample(const RETrackCache &decoded, float time,
+                                 uint32 &cursor, Vector4A16 &output) const {
+  const float *values = decoded.values.data();
+  auto GetKey = [&](size_t id) {
+    return Vector4A16(values[id], values[numFrames + id],
+                      values[numFrames * 2 + id], values[numFrames * 3 + id]);
+  };
+
   if (time <= 0.0f || numFrames == 1) {
-    controller->Evaluate(0, output);
+    output = GetKey(0);
     return;
   }
 
   float frameDelta = time * 60.f;
-  auto span = controller->GetSpan(frameDelta);
+  cursor = FindSpan(decoded.frames, static_cast<int32>(frameDelta), cursor);
 
-  if (span.offset >= numFrames) {
-    controller->Evaluate(numFrames - 1, output);
+  if (cursor >= numFrames) {
+    output = GetKey(numFrames - 1);
+    return;
+  } else if (cursor == 0) {
+    output = GetKey(0);
     return;
   }
 
-  const float fFrameBegin = static_cast<float>(span.first);
-  const float fFrameEnd = static_cast<float>(span.second);
+  const float fFrameBegin = static_cast<float>(decoded.frames[cursor - 1]);
+  const float fFrameEnd = static_cast<float>(decoded.frames[cursor]);
 
-  if (span.first == span.second) {
+  if (fFrameBegin == fFrameEnd) {
     frameDelta = 0.f;
   } else {
     frameDelta = (fFrameBegin - frameDelta) / (fFrameBegin - fFrameEnd);
   }
 
-  controller->Evaluate(span.offset - 1, output);
+  output = GetKey(cursor - 1);
 
   if (frameDelta > FLT_EPSILON) {
-    Vector4A16 nextValue;
-    controller->Evaluate(span.offset, nextValue);
+    Vector4A16 nextValue = GetKey(cursor);
 
     if (cType == TrackType_e::Rotation) {
       output = slerp(output, nextValue, frameDelta);
@@ -137,6 +189,37 @@ void REMotionTrackWorker::GetValue(Vector4A16 &output, float time) const {
   }
 }
 
+void REMotionTrackWorker::GetValue(Vector4A16 &output, float time) const {
+  // bugfix, some codecs will partialy apply elements, ensure we have identity
+  output = Vector4A16{};
+
+  if (!controller || !numFrames) {
+    return;
+  }
+
+  const RETrackCache &decoded = Cache();
+  uint32 cursor = cache->cursor.load(std::memory_order_relaxed);
+  Sample(decoded, time, cursor, output);
+  cache->cursor.store(cursor, std::memory_order_relaxed);
+}
+
+void REMotionTrackWorker::GetValues(std::span<const float> times,
+                                    std::span<Vector4A16> output) const {
+  const size_t numItems = std::min(times.size(), output.size());
+
+  if (!controller || !numFrames) {
+    std::fill_n(output.begin(), numItems, Vector4A16{});
+    return;
+  }
+
+  const RETrackCache &decoded = Cache();
+  uint32 cursor = 0;
+
+  for (size_t i = 0; i < numItems; i++) {
+    Sample(decoded, times[i], cursor, output[i]);
+  }
+}
+
 void REMotion43Asset::Build() {
   const uint32 numTracks = Get().numTracks;
 
@@ -176,7 +259,7 @@ void REMotion43Asset::Build() {
   }
 }
 
-void REMotion43Asset::Fixup(std::vector<void *> &ptrStore) {
+void REMotion43Asset::Fixup(revil::FixupTracker &ptrStore) {
   ProcessFlags flags;
   flags.ptrStore = &ptrStore;
   ProcessClass(Get(), flags);
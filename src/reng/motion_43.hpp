@@ -22,6 +22,9 @@
 #include "spike/uni/list_vector.hpp"
 #include "spike/uni/motion.hpp"
 #include "spike/util/unicode.hpp"
+#include <atomic>
+#include <mutex>
+#include <span>
 
 struct RETrackCurve43;
 struct RETrackCurve65;
@@ -55,10 +58,27 @@ struct RETrackController {
   virtual uint16 GetFrame(uint32 id) const = 0;
   virtual KnotSpan GetSpan(int32 frame) const = 0;
   virtual void Evaluate(uint32 id, Vector4A16 &out) const = 0;
+  // Evaluates all keys, out is SoA: X[numFrames], Y, Z, W
+  virtual void Decode(float *out) const = 0;
   virtual ~RETrackController() = default;
   virtual const char *CodecName() const = 0;
 };
 
+// Curve fields shared by every curve version
+struct RETrackCurveData {
+  uint32 flags;
+  uint32 numFrames;
+  uint8 *frames;
+  char *controlPoints;
+  const REMimMaxBounds *minMaxBounds;
+};
+
+// Controller of 43, 65 or 78 curve, nullptr for unknown compression
+RETrackController::Ptr CreateRETrackController(uint32 curveVersion,
+                                               const RETrackCurveData &curve);
+// Compression types of curve version, without frame type bits
+std::vector<uint32> RETrackCurveTypes(uint32 curveVersion);
+
 struct RETrackCurve43 {
   uint32 flags;
   uint32 numFrames, framesPerSecond;
@@ -98,17 +118,36 @@ template <class trackType> struct REMotion_t : public REAssetBase {
   uint16 unks00[2];
 };
 
+// Track keys decoded on first sample
+struct RETrackCache {
+  std::once_flag decoded;
+  std::vector<int32> frames;
+  // SoA, see RETrackController::Decode
+  std::vector<float> values;
+  // Span of last sample, sampling is mostly monotonic
+  std::atomic<uint32> cursor{0};
+};
+
 class REMotionTrackWorker : public uni::MotionTrack {
   TrackType_e TrackType() const override { return cType; }
   void GetValue(Vector4A16 &output, float time) const override;
   size_t BoneIndex() const override { return boneHash; }
 
+  const RETrackCache &Cache() const;
+  void Sample(const RETrackCache &cache, float time, uint32 &cursor,
+              Vector4A16 &output) const;
+
 public:
   std::unique_ptr<RETrackController> controller;
+  std::unique_ptr<RETrackCache> cache = std::make_unique<RETrackCache>();
   TrackType_e cType;
   uint32 boneHash;
   uint32 numFrames;
 
+  // Samples times in order, cheapest when times are sorted
+  void GetValues(std::span<const float> times,
+                 std::span<Vector4A16> output) const;
+
   operator uni::Element<const uni::MotionTrack>() const {
     return uni::Element<const uni::MotionTrack>{this, false};
   }
@@ -148,7 +187,7 @@ public:
     return uni::Element<const uni::Motion>{this, false};
   }
 
-  void Fixup(std::vector<void *> &ptrStore) override;
+  void Fixup(revil::FixupTracker &ptrStore) override;
   void Build() override;
 
 public:
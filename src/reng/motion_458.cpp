@@ -19,11 +19,16 @@
 
 template <> void ProcessClass(REMotion458 &item, ProcessFlags flags) {
   flags.base = reinterpret_cast<char *>(&item);
-  if (!es::FixupPointers(flags.base, *flags.ptrStore, item.tracks,
-                         item.animationName)) {
+  flags.ptrStore->CheckArray(&item, 1);
+
+  flags.ptrStore->Fixup(item.animationName, flags.base);
+
+  if (!flags.ptrStore->Fixup(item.tracks, flags.base)) {
     return;
   }
 
+  flags.ptrStore->CheckArray(item.tracks.operator->(), item.numTracks);
+
   for (size_t b = 0; b < item.numTracks; b++) {
     ProcessClass(item.tracks[b], flags);
   }
@@ -68,7 +73,7 @@ void REMotion458Asset::Build() {
   }
 }
 
-void REMotion458Asset::Fixup(std::vector<void *> &ptrStore) {
+void REMotion458Asset::Fixup(revil::FixupTracker &ptrStore) {
   ProcessFlags flags;
   flags.ptrStore = &ptrStore;
   ProcessClass(Get(), flags);
@@ -48,7 +48,7 @@ public:
   uint32 FrameRate() const override { return Get().framesPerSecond; }
   float Duration() const override { return Get().intervals[0] / FrameRate(); }
 
-  void Fixup(std::vector<void *> &ptrStore) override;
+  void Fixup(revil::FixupTracker &ptrStore) override;
   void Build() override;
 
 public:
@@ -22,7 +22,7 @@ template <> void ProcessClass(RETrackCurve65 &item, ProcessFlags flags) {
 }
 
 template <> void ProcessClass(REMotionTrack65 &item, ProcessFlags flags) {
-  if (!es::FixupPointers(flags.base, *flags.ptrStore, item.curves)) {
+  if (!flags.ptrStore->FixupPointers(flags.base, item.curves)) {
     return;
   }
 
@@ -37,19 +37,31 @@ template <> void ProcessClass(REMotionTrack65 &item, ProcessFlags flags) {
 
 template <> void ProcessClass(REMotion65 &item, ProcessFlags flags) {
   flags.base = reinterpret_cast<char *>(&item);
-  if (!es::FixupPointers(flags.base, *flags.ptrStore, item.bones, item.tracks,
-                         item.unkOffset02, item.animationName)) {
-    return;
-  }
+  flags.ptrStore->CheckArray(&item, 1);
+
+  flags.ptrStore->FixupPointers(flags.base, item.unkOffset02,
+                                item.animationName);
+
+  // Overlapping motions can share bone header, only worker that fixed
+  // a pointer processes its data
+  if (flags.ptrStore->Fixup(item.bones, flags.base) && item.bones) {
+    flags.ptrStore->CheckArray(item.bones.operator->(), 1);
 
-  if (item.bones) {
-    item.bones->ptr.Fixup(flags.base);
+    if (flags.ptrStore->Fixup(item.bones->ptr, flags.base)) {
+      flags.ptrStore->CheckArray(item.bones->ptr.operator->(), item.numBones);
+
+      for (size_t b = 0; b < item.numBones; b++) {
+        ProcessClass(item.bones->ptr[b], flags);
+      }
+    }
   }
 
-  for (size_t b = 0; b < item.numBones; b++) {
-    ProcessClass(item.bones->ptr[b], flags);
+  if (!flags.ptrStore->Fixup(item.tracks, flags.base)) {
+    return;
   }
 
+  flags.ptrStore->CheckArray(item.tracks.operator->(), item.numTracks);
+
   for (size_t b = 0; b < item.numTracks; b++) {
     ProcessClass(item.tracks[b], flags);
   }
@@ -94,7 +106,7 @@ void REMotion65Asset::Build() {
   }
 }
 
-void REMotion65Asset::Fixup(std::vector<void *> &ptrStore) {
+void REMotion65Asset::Fixup(revil::FixupTracker &ptrStore) {
   ProcessFlags flags;
   flags.ptrStore = &ptrStore;
   ProcessClass(Get(), flags);
@@ -18,12 +18,13 @@
 #include "motion_78.hpp"
 
 template <> void ProcessClass(RETrackCurve78 &item, ProcessFlags flags) {
-  es::FixupPointers(flags.base, *flags.ptrStore, item.frames,
-                    item.controlPoints, item.minMaxBounds);
+  flags.ptrStore->CheckArray(&item, 1);
+  flags.ptrStore->FixupPointers(flags.base, item.frames, item.controlPoints,
+                                item.minMaxBounds);
 }
 
 template <> void ProcessClass(REMotionTrack78 &item, ProcessFlags flags) {
-  if (!es::FixupPointers(flags.base, *flags.ptrStore, item.curves)) {
+  if (!flags.ptrStore->FixupPointers(flags.base, item.curves)) {
     return;
   }
 
@@ -38,11 +39,17 @@ template <> void ProcessClass(REMotionTrack78 &item, ProcessFlags flags) {
 
 template <> void ProcessClass(REMotion78 &item, ProcessFlags flags) {
   flags.base = reinterpret_cast<char *>(&item);
-  if (!es::FixupPointers(flags.base, *flags.ptrStore, item.tracks,
-                         item.unkOffset02, item.animationName)) {
+  flags.ptrStore->CheckArray(&item, 1);
+
+  flags.ptrStore->FixupPointers(flags.base, item.unkOffset02,
+                                item.animationName);
+
+  if (!flags.ptrStore->Fixup(item.tracks, flags.base)) {
     return;
   }
 
+  flags.ptrStore->CheckArray(item.tracks.operator->(), item.numTracks);
+
   for (size_t b = 0; b < item.numTracks; b++) {
     ProcessClass(item.tracks[b], flags);
   }
@@ -87,7 +94,7 @@ void REMotion78Asset::Build() {
   }
 }
 
-void REMotion78Asset::Fixup(std::vector<void *> &ptrStore) {
+void REMotion78Asset::Fixup(revil::FixupTracker &ptrStore) {
   ProcessFlags flags;
   flags.ptrStore = &ptrStore;
   ProcessClass(Get(), flags);
@@ -47,7 +47,7 @@ class REMotlist486Asset : public REAssetImpl,
     return {static_cast<const MotionList486 *>(this), false};
   }
 
-  void Fixup(std::vector<void *> &ptrStore) override;
+  void Fixup(revil::FixupTracker &ptrStore) override;
   void Build() override;
 
 public:
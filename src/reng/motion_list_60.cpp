@@ -16,32 +16,55 @@
 */
 
 #include "motion_list_60.hpp"
+#include "../parallel.hpp"
 
 template <> void ProcessClass(REMotlist60 &item, ProcessFlags flags) {
   flags.base = reinterpret_cast<char *>(&item);
+  flags.ptrStore->CheckArray(&item, 1);
 
-  if (!es::FixupPointers(flags.base, *flags.ptrStore, item.motions,
-                         item.unkOffset00, item.fileName)) {
+  if (!flags.ptrStore->FixupPointers(flags.base, item.motions, item.unkOffset00,
+                                     item.fileName)) {
     return;
   }
 
   auto motions = item.motions.operator->();
+  flags.ptrStore->CheckArray(motions, item.numMotions);
+  std::vector<REMotion43 *> uniqueMotions;
 
   for (uint32 m = 0; m < item.numMotions; m++) {
-    motions[m].Fixup(flags.base, *flags.ptrStore);
+    flags.ptrStore->Fixup(motions[m], flags.base);
 
     REAssetBase *cMotBase = motions[m];
 
+    if (cMotBase) {
+      flags.ptrStore->CheckArray(cMotBase, 1);
+    }
+
     if (!cMotBase || cMotBase->assetID != REMotion43Asset::VERSION ||
         cMotBase->assetFourCC != REMotion43Asset::ID) {
       continue;
     }
 
+    uniqueMotions.emplace_back(motions[m]);
+  }
+
+  std::sort(uniqueMotions.begin(), uniqueMotions.end());
+  uniqueMotions.erase(std::unique(uniqueMotions.begin(), uniqueMotions.end()),
+                      uniqueMotions.end());
+
+  // Motions of malformed files can overlap, workers share one tracker so
+  // every pointer field is fixed exactly once
+  revil::SharedFixupTracker sharedStore(*flags.ptrStore);
+
+  revil::ParallelFor(uniqueMotions.size(), [&](size_t m) {
     auto nFlags = flags;
-    nFlags.base = reinterpret_cast<char *>(cMotBase);
+    nFlags.base = reinterpret_cast<char *>(uniqueMotions[m]);
+    revil::FixupTracker workerStore = sharedStore.Worker();
+    nFlags.ptrStore = &workerStore;
+    ProcessClass(*uniqueMotions[m], nFlags);
+  });
 
-    ProcessClass(*motions[m], nFlags);
-  }
+  sharedStore.Merge();
 }
 
 void REMotlist60Asset::Build() {
@@ -50,6 +73,7 @@ void REMotlist60Asset::Build() {
 
   auto &motionListStorage = static_cast<MotionList60 &>(*this).storage;
   auto motions = data.motions.operator->();
+  std::vector<REAssetBase *> validMotions;
 
   for (size_t m = 0; m < numAnims; m++) {
     REAssetBase *cMot = motions[m];
@@ -59,9 +83,17 @@ void REMotlist60Asset::Build() {
       continue;
     }
 
-    motionListStorage.emplace_back(cMot);
+    validMotions.emplace_back(cMot);
   }
 
+  // Track controllers are created per motion, in place
+  const size_t firstMotion = motionListStorage.size();
+  motionListStorage.resize(firstMotion + validMotions.size());
+
+  revil::ParallelFor(validMotions.size(), [&](size_t m) {
+    motionListStorage[firstMotion + m].Assign(validMotions[m]);
+  });
+
   auto &skeletonStorage = static_cast<SkeletonList &>(*this).storage;
 
   for (size_t m = 0; m < numAnims; m++) {
@@ -77,7 +109,7 @@ void REMotlist60Asset::Build() {
   }
 }
 
-void REMotlist60Asset::Fixup(std::vector<void *> &ptrStore) {
+void REMotlist60Asset::Fixup(revil::FixupTracker &ptrStore) {
   ProcessFlags flags;
   flags.ptrStore = &ptrStore;
   ProcessClass(Get(), flags);
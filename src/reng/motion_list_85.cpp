@@ -16,32 +16,55 @@
 */
 
 #include "motion_list_85.hpp"
+#include "../parallel.hpp"
 
 template <> void ProcessClass(REMotlist85 &item, ProcessFlags flags) {
   flags.base = reinterpret_cast<char *>(&item);
+  flags.ptrStore->CheckArray(&item, 1);
 
-  if (!es::FixupPointers(flags.base, *flags.ptrStore, item.motions,
-                         item.unkOffset00, item.fileName, item.null)) {
+  if (!flags.ptrStore->FixupPointers(flags.base, item.motions, item.unkOffset00,
+                                     item.fileName, item.null)) {
     return;
   }
 
   auto motions = item.motions.operator->();
+  flags.ptrStore->CheckArray(motions, item.numMotions);
+  std::vector<REMotion65 *> uniqueMotions;
 
   for (uint32 m = 0; m < item.numMotions; m++) {
-    motions[m].Fixup(flags.base, *flags.ptrStore);
+    flags.ptrStore->Fixup(motions[m], flags.base);
 
     REAssetBase *cMotBase = motions[m];
 
+    if (cMotBase) {
+      flags.ptrStore->CheckArray(cMotBase, 1);
+    }
+
     if (!cMotBase || cMotBase->assetID != REMotion65Asset::VERSION ||
         cMotBase->assetFourCC != REMotion65Asset::ID) {
       continue;
     }
 
+    uniqueMotions.emplace_back(motions[m]);
+  }
+
+  std::sort(uniqueMotions.begin(), uniqueMotions.end());
+  uniqueMotions.erase(std::unique(uniqueMotions.begin(), uniqueMotions.end()),
+                      uniqueMotions.end());
+
+  // Motions of malformed files can overlap, workers share one tracker so
+  // every pointer field is fixed exactly once
+  revil::SharedFixupTracker sharedStore(*flags.ptrStore);
+
+  revil::ParallelFor(uniqueMotions.size(), [&](size_t m) {
     auto nFlags = flags;
-    nFlags.base = reinterpret_cast<char *>(cMotBase);
+    nFlags.base = reinterpret_cast<char *>(uniqueMotions[m]);
+    revil::FixupTracker workerStore = sharedStore.Worker();
+    nFlags.ptrStore = &workerStore;
+    ProcessClass(*uniqueMotions[m], nFlags);
+  });
 
-    ProcessClass(*motions[m], nFlags);
-  }
+  sharedStore.Merge();
 }
 
 void REMotlist85Asset::Build() {
@@ -49,6 +72,7 @@ void REMotlist85Asset::Build() {
   const size_t numAnims = data.numMotions;
 
   auto &motionListStorage = static_cast<MotionList85 &>(*this).storage;
+  std::vector<REAssetBase *> validMotions;
 
   for (size_t m = 0; m < numAnims; m++) {
     REAssetBase *cMot = data.motions[m];
@@ -58,9 +82,17 @@ void REMotlist85Asset::Build() {
       continue;
     }
 
-    motionListStorage.emplace_back(cMot);
+    validMotions.emplace_back(cMot);
   }
 
+  // Track controllers are created per motion, in place
+  const size_t firstMotion = motionListStorage.size();
+  motionListStorage.resize(firstMotion + validMotions.size());
+
+  revil::ParallelFor(validMotions.size(), [&](size_t m) {
+    motionListStorage[firstMotion + m].Assign(validMotions[m]);
+  });
+
   auto &skeletonStorage = static_cast<SkeletonList &>(*this).storage;
 
   for (size_t m = 0; m < numAnims; m++) {
@@ -76,7 +108,7 @@ void REMotlist85Asset::Build() {
   }
 }
 
-void REMotlist85Asset::Fixup(std::vector<void *> &ptrStore) {
+void REMotlist85Asset::Fixup(revil::FixupTracker &ptrStore) {
   ProcessFlags flags;
   flags.ptrStore = &ptrStore;
   ProcessClass(Get(), flags);
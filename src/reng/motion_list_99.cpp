@@ -17,30 +17,39 @@
 
 #include "motion_list_99.hpp"
 #include "motion_78.hpp"
+#include "../parallel.hpp"
 
 template <> void ProcessClass(REMotlist99 &item, ProcessFlags flags) {
   flags.base = reinterpret_cast<char *>(&item);
+  flags.ptrStore->CheckArray(&item, 1);
 
-  if (!es::FixupPointers(flags.base, *flags.ptrStore, item.motions,
-                         item.unkOffset00, item.fileName, item.null)) {
+  if (!flags.ptrStore->FixupPointers(flags.base, item.motions, item.unkOffset00,
+                                     item.fileName, item.null)) {
     return;
   }
 
   auto motions = item.motions.operator->();
+  flags.ptrStore->CheckArray(motions, item.numMotions);
+  std::vector<REMotion78 *> uniqueMotions;
 
+  // Motion table and skeletons are small and may be shared, fixed serially
   for (uint32 m = 0; m < item.numMotions; m++) {
-    motions[m].Fixup(flags.base, *flags.ptrStore);
+    flags.ptrStore->Fixup(motions[m], flags.base);
 
     REAssetBase *cMotBase = motions[m];
 
+    if (cMotBase) {
+      flags.ptrStore->CheckArray(cMotBase, 1);
+    }
+
     if (!cMotBase || cMotBase->assetID != REMotion78Asset::VERSION ||
         cMotBase->assetFourCC != REMotion78Asset::ID) {
       continue;
     }
 
     REMotion78 *cMot = static_cast<REMotion78 *>(cMotBase);
-
-    ProcessClass(*cMot, flags);
+    flags.ptrStore->CheckArray(cMot, 1);
+    uniqueMotions.emplace_back(cMot);
 
     if (cMot->pad || !cMot->bones) {
       continue;
@@ -48,18 +57,38 @@ template <> void ProcessClass(REMotlist99 &item, ProcessFlags flags) {
 
     auto nFlags = flags;
     nFlags.base = reinterpret_cast<char *>(cMot);
-    cMot->bones.Fixup(nFlags.base, *flags.ptrStore);
-    cMot->bones->ptr.Fixup(nFlags.base, *flags.ptrStore);
+    nFlags.ptrStore->Fixup(cMot->bones, nFlags.base);
+    nFlags.ptrStore->CheckArray(cMot->bones.operator->(), 1);
+    nFlags.ptrStore->Fixup(cMot->bones->ptr, nFlags.base);
     REMotionBone *bonesPtr = cMot->bones->ptr;
 
     if (!bonesPtr) {
       continue;
     }
 
+    nFlags.ptrStore->CheckArray(bonesPtr, cMot->numBones);
+
     for (size_t b = 0; b < cMot->numBones; b++) {
       ProcessClass(bonesPtr[b], nFlags);
     }
   }
+
+  std::sort(uniqueMotions.begin(), uniqueMotions.end());
+  uniqueMotions.erase(std::unique(uniqueMotions.begin(), uniqueMotions.end()),
+                      uniqueMotions.end());
+
+  // Motions of malformed files can overlap, workers share one tracker so
+  // every pointer field is fixed exactly once
+  revil::SharedFixupTracker sharedStore(*flags.ptrStore);
+
+  revil::ParallelFor(uniqueMotions.size(), [&](size_t m) {
+    auto nFlags = flags;
+    revil::FixupTracker workerStore = sharedStore.Worker();
+    nFlags.ptrStore = &workerStore;
+    ProcessClass(*uniqueMotions[m], nFlags);
+  });
+
+  sharedStore.Merge();
 }
 
 void REMotlist99Asset::Build() {
@@ -68,6 +97,7 @@ void REMotlist99Asset::Build() {
 
   auto &motionListStorage = static_cast<MotionList99 &>(*this).storage;
   auto &skeletonStorage = static_cast<SkeletonList &>(*this).storage;
+  std::vector<REAssetBase *> validMotions;
 
   for (size_t m = 0; m < numAnims; m++) {
     auto cMot = data.motions[m];
@@ -77,7 +107,7 @@ void REMotlist99Asset::Build() {
       continue;
     }
 
-    motionListStorage.emplace_back<REAssetBase *>(cMot);
+    validMotions.emplace_back(cMot);
 
     if (cMot->pad || !cMot->bones || !cMot->bones->ptr) {
       continue;
@@ -86,9 +116,17 @@ void REMotlist99Asset::Build() {
     skeletonStorage.emplace_back();
     skeletonStorage.back().Assign(cMot->bones->ptr, cMot->numBones);
   }
+
+  // Track controllers are created per motion, in place
+  const size_t firstMotion = motionListStorage.size();
+  motionListStorage.resize(firstMotion + validMotions.size());
+
+  revil::ParallelFor(validMotions.size(), [&](size_t m) {
+    motionListStorage[firstMotion + m].Assign(validMotions[m]);
+  });
 }
 
-void REMotlist99Asset::Fixup(std::vector<void *> &ptrStore) {
+void REMotlist99Asset::Fixup(revil::FixupTracker &ptrStore) {
   ProcessFlags flags;
   flags.ptrStore = &ptrStore;
   ProcessClass(Get(), flags);
@@ -0,0 +1,545 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "../parallel.hpp"
+#include "motion_list_99.hpp"
+#include "spike/except.hpp"
+#include "spike/io/binwritter_stream.hpp"
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <map>
+
+// Raw layouts of written classes, pointers are offsets from motion start
+struct MotionHeaderRaw {
+  uint32 assetID, assetFourCC;
+  uint64 pad;
+  uint64 bones;
+  uint64 tracks;
+  uint64 null[5];
+  uint64 unkOffset02;
+  uint64 animationName;
+  float intervals[4];
+  uint16 numBones;
+  uint16 numTracks;
+  uint16 numUNK00;
+  uint16 framesPerSecond;
+  uint16 unks00[2];
+};
+
+struct TrackRaw {
+  uint16 unk;
+  uint16 usedCurves;
+  uint32 boneHash;
+  uint32 curves;
+};
+
+struct CurveRaw {
+  uint32 flags;
+  uint32 numFrames;
+  uint32 frames;
+  uint32 controlPoints;
+  uint32 minMaxBounds;
+};
+
+struct MotionListHeaderRaw {
+  uint32 assetID, assetFourCC;
+  uint64 pad;
+  uint64 motions;
+  uint64 unkOffset00;
+  uint64 fileName;
+  uint64 null;
+  uint32 numMotions;
+};
+
+static_assert(sizeof(MotionHeaderRaw) == sizeof(REMotion78));
+static_assert(sizeof(TrackRaw) == sizeof(REMotionTrack78));
+static_assert(sizeof(CurveRaw) == sizeof(RETrackCurve78));
+static_assert(sizeof(MotionListHeaderRaw) == sizeof(REMotlist99));
+
+namespace {
+enum FrameType : uint32 { FrameType_char = 2, FrameType_short = 4 };
+
+struct Codec {
+  uint32 id;
+  uint32 numBits;
+  uint32 keySize;
+};
+
+// Sorted by key size, see codecs.cpp for decoders
+static constexpr Codec VECTOR_CODECS[]{
+    {0x200F2, 5, 2},
+    {0x400F2, 10, 4},
+    {0x800F2, 21, 8},
+};
+
+static constexpr Codec QUAT_CODECS[]{
+    {0x20112, 5, 2},  {0x30112, 8, 3},  {0x40112, 10, 4}, {0x50112, 13, 5},
+    {0x60112, 16, 6}, {0x70112, 18, 7}, {0x80112, 21, 8},
+};
+
+static constexpr uint32 LINEAR_VECTOR = 0xF2;
+static constexpr uint32 LINEAR_QUAT = 0xC0112;
+static constexpr uint32 RE_FRAMERATE = 60;
+
+struct EncodedCurve {
+  uint32 flags = 0;
+  std::vector<uint16> frames;
+  std::string controlPoints;
+  bool hasBounds = false;
+  REMimMaxBounds bounds{};
+};
+
+struct CurveJob {
+  const uni::MotionTrack *track;
+  std::span<const float> times;
+  float tolerance;
+  EncodedCurve result;
+};
+
+float QuatElement(float x, float y, float z) {
+  return std::sqrt(std::max(0.f, 1.f - (x * x + y * y + z * z)));
+}
+
+template <class C> void Append(std::string &out, const C &value) {
+  out.append(reinterpret_cast<const char *>(&value), sizeof(C));
+}
+
+void Align(std::string &out, size_t alignment) {
+  out.resize((out.size() + alignment - 1) & ~(alignment - 1));
+}
+
+void PackKey(std::string &out, const Codec &codec, const uint32 *q) {
+  const uint64 key = q[0] | (uint64(q[1]) << codec.numBits) |
+                     (uint64(q[2]) << (codec.numBits * 2));
+
+  switch (codec.keySize) {
+  case 2:
+    Append(out, uint16(key));
+    break;
+  case 4:
+    Append(out, uint32(key));
+    break;
+  case 8:
+    Append(out, key);
+    break;
+  case 3: // UCVector
+    for (uint32 c = 0; c < 3; c++) {
+      out.push_back(char(q[c]));
+    }
+    break;
+  case 6: // USVector
+    for (uint32 c = 0; c < 3; c++) {
+      Append(out, uint16(q[c]));
+    }
+    break;
+  default: // big endian bytes
+    for (uint32 b = codec.keySize; b-- > 0;) {
+      out.push_back(char(key >> (b * 8)));
+    }
+    break;
+  }
+}
+
+// Quantizes keys with codec, fails when any component is out of tolerance
+bool TryCodec(const std::vector<Vector4A16> &values, const Codec &codec,
+              bool isQuat, float tolerance, EncodedCurve &result) {
+  const uint32 mask = (1U << codec.numBits) - 1;
+  const float multiplier = 1.0f / static_cast<float>(mask);
+  float offset[3]{FLT_MAX, FLT_MAX, FLT_MAX};
+  float range[3]{};
+
+  for (auto &v : values) {
+    for (uint32 c = 0; c < 3; c++) {
+      offset[c] = std::min(offset[c], v[c]);
+      range[c] = std::max(range[c], v[c]);
+    }
+  }
+
+  for (uint32 c = 0; c < 3; c++) {
+    range[c] -= offset[c];
+  }
+
+  std::string controlPoints;
+  controlPoints.reserve(values.size() * codec.keySize);
+
+  for (auto &v : values) {
+    uint32 q[3]{};
+    float decoded[3];
+
+    for (uint32 c = 0; c < 3; c++) {
+      if (range[c] > 0.f) {
+        const float norm = (v[c] - offset[c]) / range[c];
+        q[c] = std::min(mask, uint32(std::lround(std::max(0.f, norm) * mask)));
+      }
+
+      decoded[c] = ((static_cast<float>(q[c]) * multiplier) * range[c]) +
+                   offset[c];
+
+      if (std::abs(decoded[c] - v[c]) > tolerance) {
+        return false;
+      }
+    }
+
+    if (isQuat &&
+        std::abs(QuatElement(decoded[0], decoded[1], decoded[2]) - v.W) >
+            tolerance) {
+      return false;
+    }
+
+    PackKey(controlPoints, codec, q);
+  }
+
+  result.flags = codec.id;
+  result.controlPoints = std::move(controlPoints);
+  result.hasBounds = true;
+
+  if (isQuat) {
+    result.bounds.min = Vector4(range[0], range[1], range[2], 0.f);
+    result.bounds.max = Vector4(offset[0], offset[1], offset[2], 0.f);
+  } else {
+    // Vector codecs store offset shifted, see BiLinearVector3 Assign
+    result.bounds.min = Vector4(range[0], range[1], range[2], offset[0]);
+    result.bounds.max = Vector4(offset[1], offset[2], 0.f, 0.f);
+  }
+
+  return true;
+}
+
+void EncodeCurve(CurveJob &job) {
+  const bool isQuat = job.track->TrackType() == uni::MotionTrack::Rotation;
+  std::vector<Vector4A16> values(job.times.size());
+
+  for (size_t k = 0; k < values.size(); k++) {
+    job.track->GetValue(values[k], job.times[k]);
+
+    if (isQuat && values[k].W < 0.f) {
+      values[k] *= -1.f;
+    }
+  }
+
+  EncodedCurve &result = job.result;
+  bool isStatic = true;
+
+  for (auto &v : values) {
+    for (uint32 c = 0; c < 4 && isStatic; c++) {
+      isStatic = std::abs(v[c] - values.front()[c]) <= job.tolerance;
+    }
+  }
+
+  if (isStatic) {
+    values.resize(1);
+  }
+
+  // Times are sampled at every RE frame, see CollectCurves
+  if (values.size() > 0x10000) {
+    throw es::RuntimeError("Motion is too long for RE frame range");
+  }
+
+  for (size_t k = 0; k < values.size(); k++) {
+    result.frames.emplace_back(static_cast<uint16>(k));
+  }
+
+  bool encoded = false;
+
+  for (auto &codec : isQuat ? std::span<const Codec>(QUAT_CODECS)
+                            : std::span<const Codec>(VECTOR_CODECS)) {
+    if (TryCodec(values, codec, isQuat, job.tolerance, result)) {
+      encoded = true;
+      break;
+    }
+  }
+
+  if (!encoded) {
+    result.flags = isQuat ? LINEAR_QUAT : LINEAR_VECTOR;
+
+    for (auto &v : values) {
+      Append(result.controlPoints, Vector(v.X, v.Y, v.Z));
+    }
+  }
+
+  const uint32 frameType =
+      result.frames.back() > 0xff ? FrameType_short : FrameType_char;
+  result.flags |= frameType << 20;
+}
+
+std::u16string ToUTF16(std::string_view str) {
+  std::u16string retVal;
+
+  for (size_t i = 0; i < str.size();) {
+    const uint8 lead = str[i];
+    const uint32 numTrail = lead < 0x80   ? 0
+                            : lead < 0xE0 ? 1
+                            : lead < 0xF0 ? 2
+                                          : 3;
+    uint32 codePoint = numTrail ? lead & (0x3F >> numTrail) : lead;
+
+    for (uint32 t = 1; t <= numTrail && i + t < str.size(); t++) {
+      codePoint = (codePoint << 6) | (uint8(str[i + t]) & 0x3F);
+    }
+
+    i += numTrail + 1;
+
+    if (codePoint > 0xFFFF) {
+      codePoint -= 0x10000;
+      retVal.push_back(char16_t(0xD800 | (codePoint >> 10)));
+      retVal.push_back(char16_t(0xDC00 | (codePoint & 0x3FF)));
+    } else {
+      retVal.push_back(char16_t(codePoint));
+    }
+  }
+
+  return retVal;
+}
+
+void AppendString(std::string &out, std::string_view str) {
+  for (char16_t c : ToUTF16(str)) {
+    Append(out, c);
+  }
+
+  Append(out, char16_t(0));
+}
+
+using TrackElement =
+    std::decay_t<decltype(*std::declval<const uni::Motion &>().begin())>;
+
+struct MotionJob {
+  const uni::Motion *motion;
+  std::vector<float> times;
+  // Keeps track instances alive for encoding
+  std::vector<TrackElement> tracks;
+  // Curve job indices of bone, in Position, Rotation, Scale order
+  std::map<uint32, std::vector<size_t>> bones;
+  std::vector<uint32> boneOrder;
+};
+
+void CollectCurves(MotionJob &job, std::vector<CurveJob> &curves,
+                   const REMotionExportSettings &settings) {
+  const uni::Motion &motion = *job.motion;
+  const float duration = motion.Duration();
+
+  if (!std::isfinite(duration) || duration < 0.f) {
+    throw es::RuntimeError("Motion has invalid duration");
+  }
+
+  // Keys are stored as RE_FRAMERATE frame indices, loader samples them that
+  // way regardless of motion frame rate, so motion is resampled onto that grid
+  const size_t numKeys =
+      static_cast<size_t>(std::ceil(duration * RE_FRAMERATE - 0.001f)) + 1;
+
+  for (size_t k = 0; k < numKeys; k++) {
+    job.times.emplace_back(
+        std::min(duration, static_cast<float>(k) / RE_FRAMERATE));
+  }
+
+  struct BoneCurves {
+    const uni::MotionTrack *tracks[3]{};
+  };
+
+  std::map<uint32, BoneCurves> boneCurves;
+
+  for (auto t : motion) {
+    const uint32 boneHash = t->BoneIndex();
+
+    if (!boneCurves.contains(boneHash)) {
+      job.boneOrder.emplace_back(boneHash);
+    }
+
+    auto &bone = boneCurves[boneHash];
+
+    switch (t->TrackType()) {
+    case uni::MotionTrack::Position:
+      bone.tracks[REMotionTrack43::TrackType_Position] = t.get();
+      break;
+    case uni::MotionTrack::Rotation:
+      bone.tracks[REMotionTrack43::TrackType_Rotation] = t.get();
+      break;
+    case uni::MotionTrack::Scale:
+      bone.tracks[REMotionTrack43::TrackType_Scale] = t.get();
+      break;
+    default:
+      break;
+    }
+
+    job.tracks.emplace_back(std::move(t));
+  }
+
+  const float tolerances[]{settings.positionTolerance,
+                           settings.rotationTolerance,
+                           settings.scaleTolerance};
+
+  for (uint32 boneHash : job.boneOrder) {
+    auto &indices = job.bones[boneHash];
+    indices.assign(3, SIZE_MAX);
+
+    for (uint32 c = 0; c < 3; c++) {
+      if (auto track = boneCurves.at(boneHash).tracks[c]; track) {
+        indices[c] = curves.size();
+        curves.emplace_back(CurveJob{track, job.times, tolerances[c], {}});
+      }
+    }
+  }
+}
+
+std::string WriteMotion(const MotionJob &job,
+                        const std::vector<CurveJob> &curves) {
+  const uni::Motion &motion = *job.motion;
+  std::string out;
+  MotionHeaderRaw hdr{};
+  hdr.assetID = REMotion78Asset::VERSION;
+  hdr.assetFourCC = REMotion78Asset::ID;
+  // Duration is computed as intervals[0] / framesPerSecond by loader
+  const uint32 frameRate = std::max(1U, motion.FrameRate());
+  hdr.intervals[0] = job.times.back() * frameRate;
+  hdr.numTracks = job.boneOrder.size();
+  hdr.framesPerSecond = frameRate;
+  Append(out, hdr);
+
+  Align(out, 8);
+  hdr.tracks = out.size();
+  const size_t tracksBegin = out.size();
+  out.resize(tracksBegin + sizeof(TrackRaw) * job.boneOrder.size());
+  const size_t curvesBegin = out.size();
+  size_t numCurves = 0;
+
+  for (auto &[_, indices] : job.bones) {
+    for (size_t index : indices) {
+      numCurves += index != SIZE_MAX;
+    }
+  }
+
+  out.resize(curvesBegin + sizeof(CurveRaw) * numCurves);
+  size_t curCurve = 0;
+
+  for (size_t t = 0; t < job.boneOrder.size(); t++) {
+    auto &indices = job.bones.at(job.boneOrder[t]);
+    TrackRaw track{};
+    track.boneHash = job.boneOrder[t];
+    track.curves = curvesBegin + curCurve * sizeof(CurveRaw);
+
+    for (uint32 c = 0; c < 3; c++) {
+      if (indices[c] == SIZE_MAX) {
+        continue;
+      }
+
+      track.usedCurves |= 1 << c;
+      const EncodedCurve &encoded = curves[indices[c]].result;
+      CurveRaw curve{};
+      curve.flags = encoded.flags;
+      curve.numFrames = encoded.frames.size();
+
+      Align(out, 2);
+      curve.frames = out.size();
+
+      for (uint16 f : encoded.frames) {
+        if (encoded.flags >> 20 == FrameType_short) {
+          Append(out, f);
+        } else {
+          out.push_back(char(f));
+        }
+      }
+
+      Align(out, 8);
+      curve.controlPoints = out.size();
+      out.append(encoded.controlPoints);
+
+      if (encoded.hasBounds) {
+        Align(out, 16);
+        curve.minMaxBounds = out.size();
+        Append(out, encoded.bounds);
+      }
+
+      memcpy(out.data() + curvesBegin + curCurve++ * sizeof(CurveRaw), &curve,
+             sizeof(curve));
+    }
+
+    memcpy(out.data() + tracksBegin + t * sizeof(TrackRaw), &track,
+           sizeof(track));
+  }
+
+  Align(out, 2);
+  hdr.animationName = out.size();
+  AppendString(out, motion.Name());
+  Align(out, 16);
+  memcpy(out.data(), &hdr, sizeof(hdr));
+
+  return out;
+}
+
+std::vector<std::string>
+EncodeMotions(std::span<const uni::Motion *const> motions,
+              const REMotionExportSettings &settings) {
+  std::vector<MotionJob> jobs(motions.size());
+  std::vector<CurveJob> curves;
+
+  for (size_t m = 0; m < motions.size(); m++) {
+    jobs[m].motion = motions[m];
+    CollectCurves(jobs[m], curves, settings);
+  }
+
+  revil::ParallelFor(curves.size(),
+                     [&](size_t c) { EncodeCurve(curves[c]); });
+
+  std::vector<std::string> retVal;
+
+  for (auto &job : jobs) {
+    retVal.emplace_back(WriteMotion(job, curves));
+  }
+
+  return retVal;
+}
+} // namespace
+
+namespace revil {
+void SaveREMotion(BinWritterRef wr, const uni::Motion &motion,
+                  const REMotionExportSettings &settings) {
+  const uni::Motion *motions[]{&motion};
+  wr.WriteContainer(EncodeMotions(motions, settings).front());
+}
+
+void SaveREMotionList(BinWritterRef wr,
+                      std::span<const uni::Motion *const> motions,
+                      std::string_view name,
+                      const REMotionExportSettings &settings) {
+  auto encoded = EncodeMotions(motions, settings);
+  std::string out;
+  MotionListHeaderRaw hdr{};
+  hdr.assetID = REMotlist99Asset::VERSION;
+  hdr.assetFourCC = REMotlist99Asset::ID;
+  hdr.numMotions = encoded.size();
+  Append(out, hdr);
+
+  Align(out, 8);
+  hdr.motions = out.size();
+  out.resize(out.size() + sizeof(uint64) * encoded.size());
+
+  Align(out, 2);
+  hdr.fileName = out.size();
+  AppendString(out, name);
+
+  for (size_t m = 0; m < encoded.size(); m++) {
+    Align(out, 16);
+    const uint64 motionOffset = out.size();
+    memcpy(out.data() + hdr.motions + m * sizeof(uint64), &motionOffset,
+           sizeof(motionOffset));
+    out.append(encoded[m]);
+  }
+
+  memcpy(out.data(), &hdr, sizeof(hdr));
+  wr.WriteContainer(out);
+}
+} // namespace revil
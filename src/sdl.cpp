@@ -30,6 +30,7 @@
 #include "spike/util/endian.hpp"
 #include <array>
 #include <cassert>
+#include <set>
 #include <sstream>
 
 using namespace revil;
@@ -193,8 +194,23 @@ template <> void FByteswapper(SDLHeaderV2_x64 &, bool) {
   // Not implemented
 }
 
-template <class C> void SwapData(C &entry, bool way = false) {
-  size_t numBlocks = 0;
+template <class C> uint64 RawOffset(const es::PointerX86<C> &ptr) {
+  return reinterpret_cast<const uint32 &>(ptr);
+}
+
+template <class C> uint64 RawOffset(const es::PointerX64<C> &ptr) {
+  return reinterpret_cast<const uint64 &>(ptr);
+}
+
+template <class C> void SetRawOffset(es::PointerX86<C> &ptr, uint64 offset) {
+  reinterpret_cast<uint32 &>(ptr) = offset;
+}
+
+template <class C> void SetRawOffset(es::PointerX64<C> &ptr, uint64 offset) {
+  reinterpret_cast<uint64 &>(ptr) = offset;
+}
+
+template <class C> size_t NumDataBlocks(const C &entry) {
   using EnumType = decltype(entry.type);
 
   switch (entry.type) {
@@ -205,31 +221,46 @@ template <class C> void SwapData(C &entry, bool way = false) {
   case EnumType::String:
   case EnumType::Unit:
   case EnumType::BitFlags:
-    numBlocks = 1;
-    break;
+    return 1;
 
   case EnumType::Vector4:
-    numBlocks = 4;
-    break;
+    return 4;
   case EnumType::Curve:
-    numBlocks = 16;
-    break;
+    return 16;
 
   default:
-    break;
+    return 0;
+  }
+}
+
+// Swaps entry values and frames in place, pointers are expected to be
+// swapped, but not fixed
+template <class C>
+void SwapData(C &entry, char *buffer, size_t bufferSize, bool way = false) {
+  if (!entry.numFrames) {
+    return;
   }
 
-  const size_t numSwaps = numBlocks * entry.numFrames;
-  char *dataRaw = entry.data;
-  uint32 *data = reinterpret_cast<uint32 *>(dataRaw);
+  const size_t numSwaps = NumDataBlocks(entry) * entry.numFrames;
+  const uint64 dataOffset = RawOffset(entry.data);
+  const uint64 framesOffset = RawOffset(entry.frames);
+
+  if (dataOffset > bufferSize ||
+      numSwaps * sizeof(uint32) > bufferSize - dataOffset ||
+      framesOffset > bufferSize ||
+      entry.numFrames * sizeof(SDLFrame) > bufferSize - framesOffset) {
+    throw es::RuntimeError("SDL entry data out of bounds");
+  }
+
+  uint32 *data = reinterpret_cast<uint32 *>(buffer + dataOffset);
 
   for (size_t i = 0; i < numSwaps; i++) {
     FByteswapper(data[i]);
   }
 
-  SDLFrame *frames = entry.frames;
+  SDLFrame *frames = reinterpret_cast<SDLFrame *>(buffer + framesOffset);
 
-  for (size_t i = 0; i < numSwaps; i++) {
+  for (size_t i = 0; i < entry.numFrames; i++) {
     FByteswapper(frames[i].data, way);
   }
 }
@@ -273,7 +304,7 @@ pugi::xml_node XMLChild(pugi::xml_node parentNode, const char *nodeName) {
   return node;
 }
 
-void ToXML(SDLFrame &frame, pugi::xml_node node) {
+void ToXML(const SDLFrame &frame, pugi::xml_node node) {
   node.append_attribute("frame").set_value(frame->Get<SDLFrame::Frame>());
   node.append_attribute("frameFlags").set_value(frame->Get<SDLFrame::Flags>());
 }
@@ -666,22 +697,121 @@ void revil::SDLFromXML(BinWritterRef wr, pugi::xml_node rootNode) {
   wr.WriteContainer(dataBuilder.items);
 }
 
-template <class HdrType> void ToXML(HdrType *hdr, pugi::xml_node root) {
-  using EntryType = std::decay_t<decltype(hdr->entries[0])>;
+
+// Read-only view over unfixed scheduler data
+// All pointers are resolved on access, underlying buffer is never modified
+template <class HdrType> struct SDLView {
+  using header_type = HdrType;
+  using EntryType = std::decay_t<decltype(std::declval<HdrType>().entries[0])>;
+  using PtrTypeChar = decltype(HdrType::strings);
+  using OffsetType =
+      std::conditional_t<sizeof(PtrTypeChar) == 8, uint64, uint32>;
+
+  std::string_view data;
+  // Resource hashes in string table are kept in original byte order
+  bool swappedStrings = false;
+
+  SDLView(std::string_view data_, bool swappedStrings_ = false)
+      : data(data_), swappedStrings(swappedStrings_) {
+    if (data.size() < sizeof(HdrType) ||
+        data.size() < sizeof(HdrType) +
+                          Header()->numTracks * sizeof(EntryType)) {
+      throw es::RuntimeError("SDL entries out of bounds");
+    }
+  }
+
+  const HdrType *Header() const {
+    return reinterpret_cast<const HdrType *>(data.data());
+  }
+
+  size_t NumEntries() const { return Header()->numTracks; }
+
+  const EntryType &Entry(size_t index) const {
+    if (index >= NumEntries()) {
+      throw es::RuntimeError("SDL entry index out of bounds");
+    }
+
+    return Header()->entries[index];
+  }
+
+  const char *At(uint64 offset, size_t size = 0) const {
+    if (offset > data.size() || size > data.size() - offset) {
+      throw es::RuntimeError("SDL offset out of bounds");
+    }
+
+    return data.data() + offset;
+  }
+
+  uint64 StringsOffset() const { return RawOffset(Header()->strings); }
+
+  // Strings must be terminated within data
+  // Prefix bytes (resource hash) are skipped by terminator scan
+  const char *String(uint64 offset, size_t prefix = 0) const {
+    const uint64 stringsOffset = StringsOffset();
+    At(stringsOffset);
+
+    if (offset > data.size() - stringsOffset) {
+      throw es::RuntimeError("SDL offset out of bounds");
+    }
+
+    const char *str = At(stringsOffset + offset, prefix);
+    const size_t rest = data.data() + data.size() - str - prefix;
+
+    if (!memchr(str + prefix, 0, rest)) {
+      throw es::RuntimeError("SDL string is not terminated");
+    }
+
+    return str;
+  }
+
+  // Zero name offset is valid and points to a first string
+  const char *Name(const EntryType &entry) const {
+    return String(RawOffset(entry.name));
+  }
+
+  const SDLFrame *Frames(const EntryType &entry) const {
+    return reinterpret_cast<const SDLFrame *>(
+        At(RawOffset(entry.frames), entry.numFrames * sizeof(SDLFrame)));
+  }
+
+  template <class C> const C *Values(const EntryType &entry) const {
+    return reinterpret_cast<const C *>(
+        At(RawOffset(entry.data), entry.numFrames * sizeof(C)));
+  }
+
+  // String or resource frame, null for empty slots
+  const char *StringFrame(const EntryType &entry, size_t frame,
+                          size_t prefix = 0) const {
+    const OffsetType offset = Values<OffsetType>(entry)[frame];
+    return offset ? String(offset, prefix) : nullptr;
+  }
+
+  // Resource string is prefixed with a class hash
+  uint32 ResourceHash(const char *resource) const {
+    uint32 hash;
+    memcpy(&hash, At(resource - data.data(), sizeof(hash)), sizeof(hash));
+
+    if (swappedStrings) {
+      FByteswapper(hash);
+    }
+
+    return hash;
+  }
+};
+
+template <class HdrType>
+void ToXML(const SDLView<HdrType> &view, pugi::xml_node root) {
+  using EntryType = typename SDLView<HdrType>::EntryType;
   using EnumType = decltype(EntryType::type);
-  using PtrTypeChar = decltype(hdr->strings);
-  using PtrTypeUint =
-      std::conditional_t<sizeof(PtrTypeChar) == 8, es::PointerX64<uint32>,
-                         es::PointerX86<uint32>>;
+  auto hdr = view.Header();
 
   ::ToXML(hdr->maxFrame, root.append_child("maxFrame"));
 
   if (hdr->baseTrack > 0) {
-    auto &entry = hdr->entries[hdr->baseTrack];
-    std::string xmlTrack(
-        static_cast<const char *>(hdr->entries[entry.parentOrSlot].name));
+    auto &entry = view.Entry(hdr->baseTrack);
+    std::string xmlTrack(view.Name(view.Entry(entry.parentOrSlot)));
     xmlTrack.append("::");
-    xmlTrack.append(static_cast<const char *>(entry.name));
+    xmlTrack.append(view.Name(entry));
 
     root.append_attribute("baseTrack").set_value(xmlTrack.c_str());
   }
@@ -690,8 +820,8 @@ template <class HdrType> void ToXML(HdrType *hdr, pugi::xml_node root) {
   std::vector<pugi::xml_node> nodes;
   pugi::xml_node currentRoot;
 
-  for (size_t i = 0; i < hdr->numTracks; i++) {
-    auto &entry = hdr->entries[i];
+  for (size_t i = 0; i < view.NumEntries(); i++) {
+    auto &entry = view.Entry(i);
 
     if constexpr (std::is_same_v<HdrType, SDLHeaderV2_x64>) {
       assert(entry.unk2 == 0);
@@ -754,13 +884,12 @@ template <class HdrType> void ToXML(HdrType *hdr, pugi::xml_node root) {
 
     nodes.emplace_back(xEntry);
 
-    xEntry.append_attribute("name").set_value(
-        static_cast<const char *>(entry.name));
+    xEntry.append_attribute("name").set_value(view.Name(entry));
     xEntry.append_attribute("type").set_value(uint8(entry.usageType));
     //xEntry.append_attribute("id").set_value(i);
 
     if (entry.numFrames > 0) {
-      SDLFrame *frames = entry.frames;
+      const SDLFrame *frames = view.Frames(entry);
 
       for (auto f = 0; f < entry.numFrames; f++) {
         auto frame = frames[f];
@@ -771,11 +900,10 @@ template <class HdrType> void ToXML(HdrType *hdr, pugi::xml_node root) {
         case EnumType::Int32:
         case EnumType::Unit:
           xFrame.append_attribute("value").set_value(
-              reinterpret_cast<int32 *>(static_cast<char *>(entry.data))[f]);
+              view.template Values<int32>(entry)[f]);
           break;
         case EnumType::Vector4: {
-          auto &value =
-              reinterpret_cast<Vector4 *>(static_cast<char *>(entry.data))[f];
+          auto &value = view.template Values<Vector4>(entry)[f];
           xFrame.append_attribute("x").set_value(value.x);
           xFrame.append_attribute("y").set_value(value.y);
           xFrame.append_attribute("z").set_value(value.z);
@@ -784,40 +912,34 @@ template <class HdrType> void ToXML(HdrType *hdr, pugi::xml_node root) {
         }
         case EnumType::Float:
           xFrame.append_attribute("value").set_value(
-              reinterpret_cast<float *>(static_cast<char *>(entry.data))[f]);
+              view.template Values<float>(entry)[f]);
           break;
         case EnumType::Bool:
           xFrame.append_attribute("value").set_value(
-              reinterpret_cast<bool *>(static_cast<char *>(entry.data))[f]);
+              view.template Values<bool>(entry)[f]);
           break;
         case EnumType::BitFlags:
           xFrame.append_attribute("value").set_value(
-              reinterpret_cast<uint32 *>(static_cast<char *>(entry.data))[f]);
+              view.template Values<uint32>(entry)[f]);
           break;
         case EnumType::NodeIndex:
           xFrame.append_attribute("nodeName")
-              .set_value(static_cast<const char *>(
-                  hdr->entries[reinterpret_cast<uint32 *>(
-                                   static_cast<char *>(entry.data))[f]]
-                      .name));
+              .set_value(view.Name(
+                  view.Entry(view.template Values<uint32>(entry)[f])));
           break;
 
         case EnumType::ResourceInstance: {
-          auto &dataPtr = reinterpret_cast<PtrTypeUint *>(
-              static_cast<char *>(entry.data))[f];
-
-          if (dataPtr) {
-            SetClassName(xFrame, *dataPtr);
-            xFrame.append_attribute("path").set_value(
-                reinterpret_cast<const char *>(dataPtr.operator->() + 1));
+          if (auto resource = view.StringFrame(entry, f, sizeof(uint32))) {
+            SetClassName(xFrame, view.ResourceHash(resource));
+            xFrame.append_attribute("path").set_value(resource +
+                                                      sizeof(uint32));
           }
 
           break;
         }
 
         case EnumType::Curve: {
-          auto &value = reinterpret_cast<std::array<float, 16> *>(
-              static_cast<char *>(entry.data))[f];
+          auto &value = view.template Values<std::array<float, 16>>(entry)[f];
           for (size_t i = 0; i < value.size(); i++) {
             auto aName = "e" + std::to_string(i);
             xFrame.append_attribute(aName.c_str()).set_value(value[i]);
@@ -826,9 +948,11 @@ template <class HdrType> void ToXML(HdrType *hdr, pugi::xml_node root) {
         }
 
         case EnumType::String:
-          xFrame.append_attribute("value").set_value(
-              static_cast<const char *>(reinterpret_cast<PtrTypeChar *>(
-                  static_cast<char *>(entry.data))[f]));
+          if (auto value = view.StringFrame(entry, f)) {
+            xFrame.append_attribute("value").set_value(value);
+          } else {
+            xFrame.append_attribute("value").set_value("");
+          }
 
           break;
 
@@ -840,116 +964,330 @@ template <class HdrType> void ToXML(HdrType *hdr, pugi::xml_node root) {
   }
 }
 
+template <class DstEnum, class SrcEnum> DstEnum ConvertSDLType(SrcEnum type) {
+  if constexpr (std::is_same_v<DstEnum, SrcEnum>) {
+    return type;
+  } else {
+    static const auto srcEnum = GetReflectedEnum<SrcEnum>();
+    static const auto dstEnum = GetReflectedEnum<DstEnum>();
+
+    for (size_t i = 0; i < srcEnum->numMembers; i++) {
+      if (srcEnum->values[i] != static_cast<uint64>(type)) {
+        continue;
+      }
+
+      const std::string_view typeName(srcEnum->names[i]);
+
+      for (size_t d = 0; d < dstEnum->numMembers; d++) {
+        if (typeName == dstEnum->names[d]) {
+          return DstEnum(dstEnum->values[d]);
+        }
+      }
+
+      throw es::RuntimeError("Cannot convert SDL type: " +
+                             std::string(typeName));
+    }
+
+    throw es::RuntimeError("Unknown SDL type: " +
+                           std::to_string(static_cast<uint32>(type)));
+  }
+}
+
+// Direct layout conversion, values and frames are re-laid out in one pass
+// String table keeps relative offsets, so it's copied verbatim
+template <class DstHdr, class SrcHdr>
+void ConvertSDL(const SDLView<SrcHdr> &view, BinWritterRef wr,
+                bool bigEndian) {
+  using SrcOffset = typename SDLView<SrcHdr>::OffsetType;
+  using DstEntry = typename SDLView<DstHdr>::EntryType;
+  using DstOffset = typename SDLView<DstHdr>::OffsetType;
+  static_assert(std::is_same_v<SrcHdr, SDLHeaderV1> ==
+                std::is_same_v<DstHdr, SDLHeaderV1>);
+
+  auto srcHdr = view.Header();
+  DstHdr hdr{};
+  hdr.id = bigEndian ? SDL_ID_BE : SDL_ID;
+  hdr.version = srcHdr->version;
+  hdr.numTracks = srcHdr->numTracks;
+  hdr.maxFrame = srcHdr->maxFrame;
+  hdr.baseTrack = srcHdr->baseTrack;
+
+  if constexpr (!std::is_same_v<DstHdr, SDLHeaderV1>) {
+    hdr.unk0 = srcHdr->unk0;
+  }
+
+  std::vector<DstEntry> entries(view.NumEntries());
+  wr.Write(hdr);
+  wr.WriteContainer(entries);
+
+  // Shared values and frames are kept shared
+  std::map<std::pair<uint64, uint16>, uint64> dataRemap;
+  std::map<std::pair<uint64, uint16>, uint64> framesRemap;
+  std::set<uint64> resources;
+
+  auto WriteValue = [&](auto value) {
+    if (bigEndian) {
+      FByteswapper(value);
+    }
+
+    wr.Write(value);
+  };
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    auto &src = view.Entry(i);
+    auto &dst = entries[i];
+    dst.type = ConvertSDLType<decltype(dst.type)>(src.type);
+    dst.usageType = src.usageType;
+    dst.numFrames = src.numFrames;
+    dst.parentOrSlot = src.parentOrSlot;
+    dst.hashOrArrayIndex = src.hashOrArrayIndex;
+    SetRawOffset(dst.name, RawOffset(src.name));
+
+    if constexpr (std::is_same_v<DstEntry, SDLEntryV2_x64> &&
+                  std::is_same_v<typename SDLView<SrcHdr>::EntryType,
+                                 SDLEntryV2_x64>) {
+      dst.unk2 = src.unk2;
+      dst.unk3 = src.unk3;
+    }
+
+    if (!src.numFrames) {
+      continue;
+    }
+
+    using EnumType = decltype(src.type);
+    const std::pair<uint64, uint16> dataKey{RawOffset(src.data),
+                                            src.numFrames};
+
+    if (auto found = dataRemap.find(dataKey); found != dataRemap.end()) {
+      SetRawOffset(dst.data, found->second);
+    } else {
+      wr.ApplyPadding(16);
+      dataRemap.emplace(dataKey, wr.Tell());
+      SetRawOffset(dst.data, wr.Tell());
+
+      switch (src.type) {
+      case EnumType::String:
+      case EnumType::ResourceInstance: {
+        const SrcOffset *values = view.template Values<SrcOffset>(src);
+
+        for (size_t f = 0; f < src.numFrames; f++) {
+          if (src.type == EnumType::ResourceInstance && values[f]) {
+            resources.emplace(values[f]);
+          }
+
+          WriteValue(DstOffset(values[f]));
+        }
+        break;
+      }
+
+      case EnumType::Bool:
+        wr.WriteBuffer(view.template Values<char>(src), src.numFrames);
+        break;
+
+      default: {
+        const size_t numValues = NumDataBlocks(src) * src.numFrames;
+        auto values = reinterpret_cast<const uint32 *>(
+            view.At(dataKey.first, numValues * sizeof(uint32)));
+
+        for (size_t v = 0; v < numValues; v++) {
+          WriteValue(values[v]);
+        }
+        break;
+      }
+      }
+    }
+
+    const std::pair<uint64, uint16> framesKey{RawOffset(src.frames),
+                                              src.numFrames};
+
+    if (auto found = framesRemap.find(framesKey); found != framesRemap.end()) {
+      SetRawOffset(dst.frames, found->second);
+    } else {
+      wr.ApplyPadding(4);
+      framesRemap.emplace(framesKey, wr.Tell());
+      SetRawOffset(dst.frames, wr.Tell());
+      const SDLFrame *frames = view.Frames(src);
+
+      for (size_t f = 0; f < src.numFrames; f++) {
+        SDLFrame frame = frames[f];
+
+        if (bigEndian) {
+          FByteswapper(frame.data, true);
+        }
+
+        wr.Write(frame);
+      }
+    }
+  }
+
+  SetRawOffset(hdr.strings, wr.Tell());
+  const char *srcStrings = view.At(view.StringsOffset());
+  std::string strings(srcStrings, view.data.data() + view.data.size());
+
+  for (uint64 r : resources) {
+    if (r + sizeof(uint32) > strings.size()) {
+      throw es::RuntimeError("SDL resource string out of bounds");
+    }
+
+    uint32 hash = view.ResourceHash(view.String(r, sizeof(uint32)));
+
+    if (bigEndian) {
+      FByteswapper(hash);
+    }
+
+    memcpy(strings.data() + r, &hash, sizeof(hash));
+  }
+
+  wr.WriteContainer(strings);
+
+  if (bigEndian) {
+    FByteswapper(hdr, true);
+
+    for (auto &e : entries) {
+      FByteswapper(e);
+    }
+  }
+
+  wr.Seek(0);
+  wr.Write(hdr);
+  wr.WriteContainer(entries);
+}
+
 class revil::SDLImpl {
 public:
+  // Owned storage, unused for views
   std::string buffer;
+  std::string_view data;
+  // Big endian data are swapped in place, saving goes through conversion
+  bool swapped = false;
+
+  const SDLHeaderBase *Base() const {
+    return reinterpret_cast<const SDLHeaderBase *>(data.data());
+  }
 
   bool IsX86() const {
-    auto hdr = reinterpret_cast<const SDLHeaderV2_x86 *>(buffer.data());
+    auto hdr = reinterpret_cast<const SDLHeaderV2_x86 *>(data.data());
     // Member strings overlaps with padding after baseTrack
     // Big endian are always x86
     // There are no MTF V1 x64 schedulers
 
-    return hdr->version < 0x10 || hdr->id == SDL_ID_BE || hdr->strings;
+    return hdr->version < 0x10 || swapped || RawOffset(hdr->strings);
   }
 
-  void ToXML(pugi::xml_node node) {
+  template <class Fn> void Visit(Fn &&fn) const {
+    if (Base()->version < 0x10) {
+      fn(SDLView<SDLHeaderV1>(data, swapped));
+    } else if (IsX86()) {
+      fn(SDLView<SDLHeaderV2_x86>(data, swapped));
+    } else {
+      fn(SDLView<SDLHeaderV2_x64>(data, swapped));
+    }
+  }
+
+  void ToXML(pugi::xml_node node) const {
     auto root = node.append_child("class");
     root.append_attribute("type").set_value("rScheduler");
-    auto hdrBase = reinterpret_cast<SDLHeaderBase *>(buffer.data());
+    Visit([&](auto &&view) { ::ToXML(view, root); });
+  }
 
-    if (hdrBase->version < 0x10) {
-      auto hdr = reinterpret_cast<SDLHeaderV1 *>(buffer.data());
-      ::ToXML(hdr, root);
-    } else {
-      if (IsX86()) {
-        auto hdr = reinterpret_cast<SDLHeaderV2_x86 *>(buffer.data());
-        ::ToXML(hdr, root);
-      } else {
-        auto hdrx64 = reinterpret_cast<SDLHeaderV2_x64 *>(buffer.data());
-        ::ToXML(hdrx64, root);
-      }
+  template <class HdrType> void SwapEndian() {
+    using EntryType = typename SDLView<HdrType>::EntryType;
+    auto hdr = reinterpret_cast<HdrType *>(buffer.data());
+    FByteswapper(*hdr);
+
+    if (buffer.size() < sizeof(HdrType) + hdr->numTracks * sizeof(EntryType)) {
+      throw es::RuntimeError("SDL entries out of bounds");
+    }
+
+    for (size_t i = 0; i < hdr->numTracks; i++) {
+      auto &entry = hdr->entries[i];
+      FByteswapper(entry);
+      SwapData(entry, buffer.data(), buffer.size());
     }
   }
+
   void Load(BinReaderRef_e rd) {
     uint32 id;
     rd.Read(id);
     rd.Seek(0);
 
-    if (id == SDL_ID_BE) {
-      rd.SwapEndian(true);
-    } else if (id != SDL_ID) {
+    if (id != SDL_ID_BE && id != SDL_ID) {
       throw es::InvalidHeaderError(id);
     }
 
     rd.ReadContainer(buffer, rd.GetSize());
 
-    auto hdrBase = reinterpret_cast<SDLHeaderBase *>(buffer.data());
-
-    if (hdrBase->version < 0x10) {
-      auto hdr = reinterpret_cast<SDLHeaderV1 *>(buffer.data());
-      hdr->strings.Fixup(buffer.data());
+    if (buffer.size() < sizeof(SDLHeaderV2_x86)) {
+      throw es::RuntimeError("SDL header out of bounds");
+    }
 
-      for (size_t i = 0; i < hdr->numTracks; i++) {
-        auto &entry = hdr->entries[i];
-        es::FixupPointers(buffer.data(), entry.data, entry.frames);
-        // This can be misleading, since null is allowed only for root nodes
-        entry.name.FixupRelative(hdr->strings);
+    if (id == SDL_ID_BE) {
+      uint16 version =
+          reinterpret_cast<SDLHeaderBase *>(buffer.data())->version;
+      FByteswapper(version);
 
-        if (entry.type == SDLType1::ResourceInstance ||
-            entry.type == SDLType1::String) {
-          for (auto f = 0; f < entry.numFrames; f++) {
-            reinterpret_cast<es::PointerX86<char> *>(
-                static_cast<char *>(entry.data))[f]
-                .Fixup(hdr->strings);
-          }
-        }
+      if (version < 0x10) {
+        SwapEndian<SDLHeaderV1>();
+      } else {
+        SwapEndian<SDLHeaderV2_x86>();
       }
-    } else {
-      auto FixupStuff = [&](auto *hdr) {
-        const bool shouldSwap = hdr->id == SDL_ID_BE;
 
-        if (shouldSwap) {
-          FByteswapper(*hdr);
-        }
+      swapped = true;
+    }
 
-        hdr->strings.Fixup(buffer.data());
+    data = buffer;
+  }
 
-        for (size_t i = 0; i < hdr->numTracks; i++) {
-          auto &entry = hdr->entries[i];
-          if (shouldSwap) {
-            FByteswapper(entry);
-          }
+  void LoadView(std::string_view data_) {
+    if (data_.size() < sizeof(SDLHeaderV2_x86)) {
+      throw es::RuntimeError("SDL header out of bounds");
+    }
 
-          es::FixupPointers(buffer.data(), entry.data, entry.frames);
-          // This can be misleading, since null is allowed only for root nodes
-          entry.name.FixupRelative(hdr->strings);
+    auto hdr = reinterpret_cast<const SDLHeaderBase *>(data_.data());
 
-          if (shouldSwap) {
-            SwapData(entry);
-          }
+    if (hdr->id == SDL_ID_BE) {
+      throw es::RuntimeError(
+          "Big endian scheduler cannot be viewed, use Load instead");
+    } else if (hdr->id != SDL_ID) {
+      throw es::InvalidHeaderError(hdr->id);
+    }
 
-          using EnumType = decltype(entry.type);
+    es::Dispose(buffer);
+    swapped = false;
+    data = data_;
+    // Validate entry table
+    Visit([](auto &&) {});
+  }
 
-          if (entry.type == EnumType::ResourceInstance ||
-              entry.type == EnumType::String) {
-            for (auto f = 0; f < entry.numFrames; f++) {
-              reinterpret_cast<es::PointerX64<char> *>(
-                  static_cast<char *>(entry.data))[f]
-                  .Fixup(hdr->strings);
-            }
-          }
+  void Save(BinWritterRef wr, Platform platform) const {
+    if (platform == Platform::Auto) {
+      if (!swapped) {
+        wr.WriteBuffer(data.data(), data.size());
+        return;
+      }
+
+      // Swapped data are always from x86 big endian platform
+      platform = Platform::PS3;
+    }
+
+    const bool bigEndian = IsPlatformBigEndian(platform);
+    const bool x64 = IsPlatformX64(platform);
+
+    Visit([&](auto &&view) {
+      using HdrType = typename std::decay_t<decltype(view)>::header_type;
+
+      if constexpr (std::is_same_v<HdrType, SDLHeaderV1>) {
+        if (x64) {
+          throw es::RuntimeError("V1 scheduler cannot be converted to x64");
         }
-      };
 
-      if (IsX86()) {
-        auto hdr = reinterpret_cast<SDLHeaderV2_x86 *>(buffer.data());
-        FixupStuff(hdr);
+        ConvertSDL<SDLHeaderV1>(view, wr, bigEndian);
+      } else if (x64) {
+        ConvertSDL<SDLHeaderV2_x64>(view, wr, false);
       } else {
-        auto hdr = reinterpret_cast<SDLHeaderV2_x64 *>(buffer.data());
-        FixupStuff(hdr);
+        ConvertSDL<SDLHeaderV2_x86>(view, wr, bigEndian);
       }
-    }
+    });
   }
 };
 
@@ -958,4 +1296,10 @@ SDL::~SDL() = default;
 
 void SDL::Load(BinReaderRef_e rd) { pi->Load(rd); }
 
+void SDL::LoadView(std::string_view data) { pi->LoadView(data); }
+
+void SDL::Save(BinWritterRef wr, Platform platform) const {
+  pi->Save(wr, platform);
+}
+
 void SDL::ToXML(pugi::xml_node node) const { pi->ToXML(node); }
@@ -0,0 +1,302 @@
+/*  Revil Format Library
+    Copyright(C) 2021-2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "revil/sngw.hpp"
+#include "parallel.hpp"
+#include "spike/io/binwritter_stream.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define REVIL_SNGW_SIMD
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+constexpr uint32 SNGW_KEY = 0x64958637;
+constexpr uint32 SNGW_ID = CompileFourCC("OggS");
+// Blocks processed by single worker of whole file helpers
+constexpr size_t BLOCK_SIZE = 0x100000;
+
+// Key rotated to start at given file position
+uint32 KeyAt(size_t offset) {
+  const uint32 shift = (offset % 4) * 8;
+  return shift ? (SNGW_KEY >> shift) | (SNGW_KEY << (32 - shift)) : SNGW_KEY;
+}
+
+uint8 SwapNibbles(uint8 value) { return (value << 4) | (value >> 4); }
+
+template <bool encrypt>
+void CryptScalar(const char *input, char *output, size_t size, size_t offset) {
+  for (size_t i = 0; i < size; i++) {
+    const uint8 key = SNGW_KEY >> (((offset + i) % 4) * 8);
+    const uint8 value = input[i];
+    output[i] = encrypt ? SwapNibbles(value ^ key) : SwapNibbles(value) ^ key;
+  }
+}
+
+#ifdef REVIL_SNGW_SIMD
+#if defined(__GNUC__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#define AVX512_TARGET __attribute__((target("avx512f")))
+#else
+#define AVX2_TARGET
+#define AVX512_TARGET
+#endif
+
+enum class SIMDLevel { SSE2, AVX2, AVX512 };
+
+SIMDLevel CPUSIMDLevel() {
+#if defined(_MSC_VER)
+  int regs[4];
+  __cpuid(regs, 1);
+  // OSXSAVE: bit 27, AVX: bit 28
+  if ((regs[2] & 0x18000000) != 0x18000000) {
+    return SIMDLevel::SSE2;
+  }
+
+  const uint64 xcr0 = _xgetbv(0);
+  __cpuidex(regs, 7, 0);
+
+  // AVX512F: bit 16, opmask and zmm states
+  if ((regs[1] & 0x10000) && (xcr0 & 0xE6) == 0xE6) {
+    return SIMDLevel::AVX512;
+  }
+
+  // AVX2: bit 5, ymm state
+  if ((regs[1] & 0x20) && (xcr0 & 6) == 6) {
+    return SIMDLevel::AVX2;
+  }
+
+  return SIMDLevel::SSE2;
+#else
+  if (__builtin_cpu_supports("avx512f")) {
+    return SIMDLevel::AVX512;
+  } else if (__builtin_cpu_supports("avx2")) {
+    return SIMDLevel::AVX2;
+  }
+
+  return SIMDLevel::SSE2;
+#endif
+}
+
+// Nibble swap within every byte, 64 bit shifts don't cross bytes after
+// masking
+template <bool encrypt>
+size_t CryptSSE2(const char *input, char *output, size_t size, size_t offset) {
+  const __m128i key = _mm_set1_epi32(KeyAt(offset));
+  const __m128i lmask = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m128i data =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+
+    if constexpr (encrypt) {
+      data = _mm_xor_si128(data, key);
+    }
+
+    data = _mm_or_si128(_mm_slli_epi64(_mm_and_si128(data, lmask), 4),
+                        _mm_srli_epi64(_mm_andnot_si128(lmask, data), 4));
+
+    if constexpr (!encrypt) {
+      data = _mm_xor_si128(data, key);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), data);
+  }
+
+  return i;
+}
+
+template <bool encrypt>
+AVX2_TARGET size_t CryptAVX2(const char *input, char *output, size_t size,
+                             size_t offset) {
+  const __m256i key = _mm256_set1_epi32(KeyAt(offset));
+  const __m256i lmask = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+
+  for (; i + 32 <= size; i += 32) {
+    __m256i data =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+
+    if constexpr (encrypt) {
+      data = _mm256_xor_si256(data, key);
+    }
+
+    data =
+        _mm256_or_si256(_mm256_slli_epi64(_mm256_and_si256(data, lmask), 4),
+                        _mm256_srli_epi64(_mm256_andnot_si256(lmask, data), 4));
+
+    if constexpr (!encrypt) {
+      data = _mm256_xor_si256(data, key);
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i), data);
+  }
+
+  return i;
+}
+
+template <bool encrypt>
+AVX512_TARGET size_t CryptAVX512(const char *input, char *output, size_t size,
+                                 size_t offset) {
+  const __m512i key = _mm512_set1_epi32(KeyAt(offset));
+  const __m512i lmask = _mm512_set1_epi32(0x0f0f0f0f);
+  size_t i = 0;
+
+  for (; i + 64 <= size; i += 64) {
+    __m512i data = _mm512_loadu_si512(input + i);
+
+    if constexpr (encrypt) {
+      data = _mm512_xor_si512(data, key);
+    }
+
+    data =
+        _mm512_or_si512(_mm512_slli_epi64(_mm512_and_si512(data, lmask), 4),
+                        _mm512_srli_epi64(_mm512_andnot_si512(lmask, data), 4));
+
+    if constexpr (!encrypt) {
+      data = _mm512_xor_si512(data, key);
+    }
+
+    _mm512_storeu_si512(output + i, data);
+  }
+
+  return i;
+}
+#endif
+
+template <bool encrypt>
+void Crypt(std::string_view input, char *output, size_t offset) {
+  size_t done = 0;
+
+#ifdef REVIL_SNGW_SIMD
+  static const SIMDLevel simdLevel = CPUSIMDLevel();
+
+  switch (simdLevel) {
+  case SIMDLevel::AVX512:
+    done = CryptAVX512<encrypt>(input.data(), output, input.size(), offset);
+    break;
+  case SIMDLevel::AVX2:
+    done = CryptAVX2<encrypt>(input.data(), output, input.size(), offset);
+    break;
+  default:
+    break;
+  }
+
+  done += CryptSSE2<encrypt>(input.data() + done, output + done,
+                             input.size() - done, offset + done);
+#endif
+
+  CryptScalar<encrypt>(input.data() + done, output + done,
+                       input.size() - done, offset + done);
+}
+
+template <bool encrypt>
+void CryptBlocks(std::string_view input, char *output, size_t offset) {
+  const size_t numBlocks = (input.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+  revil::ParallelFor(numBlocks, [&](size_t b) {
+    const size_t blockOffset = b * BLOCK_SIZE;
+    Crypt<encrypt>(input.substr(blockOffset, BLOCK_SIZE), output + blockOffset,
+                   offset + blockOffset);
+  });
+}
+
+template <bool encrypt>
+void CryptFile(std::string_view input, BinWritterRef output) {
+  const size_t batchSize =
+      BLOCK_SIZE * std::max(1U, std::thread::hardware_concurrency());
+  std::string batch;
+
+  for (size_t offset = 0; offset < input.size(); offset += batch.size()) {
+    batch.resize(std::min(batchSize, input.size() - offset));
+    CryptBlocks<encrypt>(input.substr(offset, batch.size()), batch.data(),
+                         offset);
+
+    if (offset == 0) {
+      const size_t headerSize = std::min(batch.size(), sizeof(SNGW_ID));
+
+      if constexpr (encrypt) {
+        const char zeroes[sizeof(SNGW_ID)]{};
+        Crypt<true>({zeroes, headerSize}, batch.data(), 0);
+      } else {
+        memcpy(batch.data(), &SNGW_ID, headerSize);
+      }
+    }
+
+    output.WriteBuffer(batch.data(), batch.size());
+  }
+}
+} // namespace
+
+namespace revil {
+void EncryptSNGW(std::string_view input, char *output, size_t offset) {
+  Crypt<true>(input, output, offset);
+}
+
+void DecryptSNGW(std::string_view input, char *output, size_t offset) {
+  Crypt<false>(input, output, offset);
+}
+
+bool IsSNGWFile(std::string_view data, bool encrypted) {
+  uint32 id;
+
+  if (data.size() < sizeof(id)) {
+    return false;
+  }
+
+  if (encrypted) {
+    DecryptSNGW(data.substr(0, sizeof(id)), reinterpret_cast<char *>(&id));
+    return id == 0;
+  }
+
+  memcpy(&id, data.data(), sizeof(id));
+  return id == SNGW_ID;
+}
+
+bool DecryptSNGWFile(std::span<char> data) {
+  if (!IsSNGWFile({data.data(), data.size()}, true)) {
+    return false;
+  }
+
+  CryptBlocks<false>({data.data(), data.size()}, data.data(), 0);
+  memcpy(data.data(), &SNGW_ID, sizeof(SNGW_ID));
+
+  return true;
+}
+
+void EncryptSNGWFile(std::span<char> data) {
+  memset(data.data(), 0, std::min(data.size(), sizeof(SNGW_ID)));
+  CryptBlocks<true>({data.data(), data.size()}, data.data(), 0);
+}
+
+void DecryptSNGWFile(std::string_view input, BinWritterRef output) {
+  CryptFile<false>(input, output);
+}
+
+void EncryptSNGWFile(std::string_view input, BinWritterRef output) {
+  CryptFile<true>(input, output);
+}
+} // namespace revil
@@ -0,0 +1,55 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "spike/except.hpp"
+#include "spike/util/supercore.hpp"
+#include <cstddef>
+
+namespace revil {
+// Extent checks for loaders that read tables straight from stream
+// Counts and offsets come from file, so tables must fit into stream before
+// anything is allocated for them
+
+// Throws if count items of itemSize at offset don't fit into size
+inline void CheckExtent(size_t size, size_t offset, size_t count,
+                        size_t itemSize) {
+  if (offset > size || (itemSize && count > (size - offset) / itemSize)) {
+    throw es::RuntimeError("Table out of file bounds");
+  }
+}
+
+// Throws if count items of itemSize don't fit into rest of stream
+template <class Reader>
+void CheckTable(Reader &rd, size_t count, size_t itemSize) {
+  CheckExtent(rd.GetSize(), rd.Tell(), count, itemSize);
+}
+
+// ReadContainer for counts read from file
+template <class Reader, class C>
+void ReadTable(Reader &rd, C &container, size_t count) {
+  CheckTable(rd, count, sizeof(typename C::value_type));
+  rd.ReadContainer(container, count);
+}
+
+// ReadContainer for count prefixed tables
+template <class Reader, class C> void ReadTable(Reader &rd, C &container) {
+  uint32 count;
+  rd.Read(count);
+  ReadTable(rd, container, count);
+}
+} // namespace revil
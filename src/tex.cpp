@@ -17,10 +17,15 @@
 
 #include "tex.hpp"
 #include "hfs.hpp"
+#include "parallel.hpp"
 #include "revil/tex.hpp"
+#include "revil/trace.hpp"
 #include "spike/except.hpp"
 #include "spike/format/DDS.hpp"
 #include "spike/io/binreader_stream.hpp"
+#include "spike/io/binwritter_stream.hpp"
+#include "stream_extent.hpp"
+#include <cmath>
 #include <map>
 
 using namespace revil;
@@ -185,7 +190,23 @@ void ApplyModifications(NewTexelContextCreate &ctx, Platform platform) {
   }
 }
 
-TEX LoadTEXx56(BinReaderRef_e rd) {
+// Face major offsets of tightly packed mipmaps, for versions without
+// offset table
+std::vector<uint32> PackedMipOffsets(const NewTexelContextCreate &ctx);
+
+// Texel data are left in stream for header only loads
+template <class Reader>
+void ReadTexels(TEX &main, Reader rd, size_t bufferSize, bool headerOnly) {
+  CheckTable(rd, bufferSize, 1);
+  main.dataOffset = rd.Tell();
+  main.dataSize = bufferSize;
+
+  if (!headerOnly) {
+    rd.ReadContainer(main.buffer, bufferSize);
+  }
+}
+
+TEX LoadTEXx56(BinReaderRef_e rd, bool headerOnly) {
   TEX main;
   TEXx56 header;
   rd.Read(header);
@@ -224,14 +245,15 @@ TEX LoadTEXx56(BinReaderRef_e rd) {
   }
 
   size_t bufferSize = rd.GetSize() - rd.Tell();
-  rd.ReadContainer(main.buffer, bufferSize);
+  ReadTexels(main, rd, bufferSize, headerOnly);
   ApplyModifications(main.ctx, Platform::Win32);
+  main.offsets = PackedMipOffsets(main.ctx);
 
   return main;
 }
 
 template <class header_type>
-TEX LoadTEXx66(BinReaderRef_e rd, Platform platform) {
+TEX LoadTEXx66(BinReaderRef_e rd, Platform platform, bool headerOnly) {
   TEX main;
   header_type header;
   rd.Read(header);
@@ -251,7 +273,7 @@ TEX LoadTEXx66(BinReaderRef_e rd, Platform platform) {
     rd.Read(main.harmonics);
   }
 
-  rd.ReadContainer(main.offsets, header.numFaces * header.numMips);
+  ReadTable(rd, main.offsets, header.numFaces * header.numMips);
   uint32 bufferBegin = rd.Tell();
 
   for (uint32 &o : main.offsets) {
@@ -260,7 +282,7 @@ TEX LoadTEXx66(BinReaderRef_e rd, Platform platform) {
 
   size_t bufferSize = rd.GetSize() - bufferBegin;
 
-  rd.ReadContainer(main.buffer, bufferSize);
+  ReadTexels(main, rd, bufferSize, headerOnly);
   ApplyModifications(main.ctx, platform);
 
   if (rd.SwappedEndian() &&
@@ -271,7 +293,7 @@ TEX LoadTEXx66(BinReaderRef_e rd, Platform platform) {
   return main;
 }
 
-TEX LoadTEXx87(BinReaderRef_e rd, Platform platform) {
+TEX LoadTEXx87(BinReaderRef_e rd, Platform platform, bool headerOnly) {
   TEX main;
   TEXx87 header;
   rd.Read(header);
@@ -292,7 +314,7 @@ TEX LoadTEXx87(BinReaderRef_e rd, Platform platform) {
 
   uint32 numOffsets =
       std::max(int8(1), main.ctx.numFaces) * main.ctx.numMipmaps;
-  rd.ReadContainer(main.offsets, numOffsets);
+  ReadTable(rd, main.offsets, numOffsets);
 
   uint32 bufferBegin = rd.Tell();
 
@@ -301,7 +323,7 @@ TEX LoadTEXx87(BinReaderRef_e rd, Platform platform) {
   }
 
   size_t bufferSize = rd.GetSize() - bufferBegin;
-  rd.ReadContainer(main.buffer, bufferSize);
+  ReadTexels(main, rd, bufferSize, headerOnly);
   ApplyModifications(main.ctx, platform);
 
   if (rd.SwappedEndian() &&
@@ -312,7 +334,7 @@ TEX LoadTEXx87(BinReaderRef_e rd, Platform platform) {
   return main;
 }
 
-TEX LoadTEXx9D(BinReaderRef_e rd, Platform platform) {
+TEX LoadTEXx9D(BinReaderRef_e rd, Platform platform, bool headerOnly) {
   TEX main;
   TEXx9D header;
   rd.Read(header);
@@ -334,7 +356,7 @@ TEX LoadTEXx9D(BinReaderRef_e rd, Platform platform) {
       std::max(int8(1), main.ctx.numFaces) * main.ctx.numMipmaps;
 
   auto fallback = [&] {
-    rd.ReadContainer(main.offsets, numOffsets);
+    ReadTable(rd, main.offsets, numOffsets);
     main.ctx.baseFormat = ConvertTEXFormat(header.format, platform);
   };
 
@@ -349,7 +371,7 @@ TEX LoadTEXx9D(BinReaderRef_e rd, Platform platform) {
       fallback();
     } else {
       std::vector<uint64> offsets;
-      rd.ReadContainer(offsets, numOffsets);
+      ReadTable(rd, offsets, numOffsets);
       main.offsets.assign(offsets.begin(), offsets.end());
       main.ctx.baseFormat = ConvertTEXFormat(header.format, platform);
     }
@@ -365,13 +387,13 @@ TEX LoadTEXx9D(BinReaderRef_e rd, Platform platform) {
 
   size_t bufferSize = rd.GetSize() - bufferBegin;
 
-  rd.ReadContainer(main.buffer, bufferSize);
+  ReadTexels(main, rd, bufferSize, headerOnly);
   ApplyModifications(main.ctx, platform);
 
   return main;
 }
 
-TEX LoadTEXx09(BinReaderRef_e rd_, Platform) {
+TEX LoadTEXx09(BinReaderRef_e rd_, Platform, bool headerOnly) {
   BinReaderRef rd(rd_);
   TEX main;
   TEXx09 header;
@@ -416,12 +438,12 @@ TEX LoadTEXx09(BinReaderRef_e rd_, Platform) {
   rd.Seek(header.dataOffset);
   size_t bufferSize = rd.GetSize() - header.dataOffset;
 
-  rd.ReadContainer(main.buffer, bufferSize);
+  ReadTexels(main, rd, bufferSize, headerOnly);
 
   return main;
 }
 
-TEX LoadTEXxA0(BinReaderRef_e rd, Platform platform) {
+TEX LoadTEXxA0(BinReaderRef_e rd, Platform platform, bool headerOnly) {
   TEX main;
   TEXx9D header;
   rd.Read(header);
@@ -443,7 +465,7 @@ TEX LoadTEXxA0(BinReaderRef_e rd, Platform platform) {
 
   uint32 bufferSize;
   rd.Read(bufferSize);
-  rd.ReadContainer(main.offsets, numOffsets);
+  ReadTable(rd, main.offsets, numOffsets);
   main.ctx.baseFormat = ConvertTEXFormat(header.format, platform);
 
   if (type == TextureTypeV2::Cubemap) {
@@ -460,13 +482,13 @@ TEX LoadTEXxA0(BinReaderRef_e rd, Platform platform) {
     }
   }
 
-  rd.ReadContainer(main.buffer, bufferSize);
+  ReadTexels(main, rd, bufferSize, headerOnly);
   ApplyModifications(main.ctx, platform);
 
   return main;
 }
 
-TEX LoadTEXxA6(BinReaderRef_e rd, Platform) {
+TEX LoadTEXxA6(BinReaderRef_e rd, Platform, bool headerOnly) {
   TEX main;
   TEXx9D header;
   rd.Read(header);
@@ -486,18 +508,18 @@ TEX LoadTEXxA6(BinReaderRef_e rd, Platform) {
 
   uint32 numOffsets =
       main.ctx.numMipmaps * std::max(int8(1), main.ctx.numFaces);
-  rd.ReadContainer(main.offsets, numOffsets);
+  ReadTable(rd, main.offsets, numOffsets);
   main.ctx.baseFormat = ConvertTEXFormat(TEXFormat3DS(header.format));
 
   size_t bufferSize = rd.GetSize() - rd.Tell();
 
-  rd.ReadContainer(main.buffer, bufferSize);
+  ReadTexels(main, rd, bufferSize, headerOnly);
   main.ctx.baseFormat.tile = TexelTile::N3DS;
 
   return main;
 }
 
-TEX LoadTEXxA4(BinReaderRef_e rd, Platform) {
+TEX LoadTEXxA4(BinReaderRef_e rd, Platform, bool headerOnly) {
   TEX main;
   TEXx9D header;
   rd.Read(header);
@@ -516,18 +538,19 @@ TEX LoadTEXxA4(BinReaderRef_e rd, Platform) {
     throw es::RuntimeError("Cubemaps are not supported.");
   }
 
-  main.offsets.emplace_back(0);
   main.ctx.baseFormat = ConvertTEXFormat(TEXFormat3DS(header.format));
 
   size_t bufferSize = rd.GetSize() - rd.Tell();
 
-  rd.ReadContainer(main.buffer, bufferSize);
+  ReadTexels(main, rd, bufferSize, headerOnly);
   main.ctx.baseFormat.tile = TexelTile::N3DS;
+  main.offsets = PackedMipOffsets(main.ctx);
 
   return main;
 }
 
-static const std::map<uint16, TEX (*)(BinReaderRef_e, Platform)> texLoaders{
+static const std::map<uint16, TEX (*)(BinReaderRef_e, Platform, bool)>
+    texLoaders{
     {0x66, LoadTEXx66<TEXx66>}, {0x70, LoadTEXx66<TEXx70>}, {0x87, LoadTEXx87},
     {0x97, LoadTEXx9D},         {0x98, LoadTEXx9D},         {0x99, LoadTEXx9D},
     {0x9A, LoadTEXx9D},         {0x9D, LoadTEXx9D},         {0x09, LoadTEXx09},
@@ -592,20 +615,21 @@ void revil::LoadDetectTex(BinReaderRef_e rd, Platform platform,
   throw es::InvalidVersionError();
 }
 
-void TEX::Load(BinReaderRef_e rd, Platform platform) {
-  auto func = [this](uint32 version, BinReaderRef_e rd, Platform platform) {
+void LoadTEX(TEX &main, BinReaderRef_e rd, Platform platform,
+             bool headerOnly) {
+  auto func = [&](uint32 version, BinReaderRef_e rd, Platform platform) {
     if (version == 0x56) {
       if (rd.SwappedEndian()) {
         throw es::RuntimeError("X360 texture format is unsupported.");
       }
 
-      *this = LoadTEXx56(rd);
+      main = LoadTEXx56(rd, headerOnly);
       return true;
     }
 
     auto found = texLoaders.find(version);
     if (!es::IsEnd(texLoaders, found)) {
-      *this = found->second(rd, platform);
+      main = found->second(rd, platform, headerOnly);
       return true;
     };
 
@@ -614,3 +638,729 @@ void TEX::Load(BinReaderRef_e rd, Platform platform) {
 
   LoadDetectTex(rd, platform, func);
 }
+
+void TEX::Load(BinReaderRef_e rd, Platform platform) {
+  TraceZone zone("tex.load");
+  LoadTEX(*this, rd, platform, false);
+  zone.Bytes(dataSize);
+}
+
+void TEX::LoadHeader(BinReaderRef_e rd, Platform platform) {
+  uint32 id;
+  rd.Push();
+  rd.Read(id);
+  rd.Pop();
+
+  // HFS wrapped textures are decompressed into temporary stream
+  LoadTEX(*this, rd, platform, id != SFHID);
+}
+
+size_t TEX::MipSize(uint32 face, uint32 mip) const {
+  const size_t index = face * std::max(uint8(1), uint8(ctx.numMipmaps)) + mip;
+
+  if (index >= offsets.size() || offsets[index] > dataSize) {
+    throw es::RuntimeError("Mipmap index out of range!");
+  }
+
+  if (index + 1 < offsets.size() && offsets[index + 1] > offsets[index] &&
+      offsets[index + 1] <= dataSize) {
+    return offsets[index + 1] - offsets[index];
+  }
+
+  return dataSize - offsets[index];
+}
+
+void TEX::ReadMip(BinReaderRef_e rd, uint32 face, uint32 mip,
+                  std::span<char> out) const {
+  const size_t size = MipSize(face, mip);
+  const uint32 offset =
+      offsets[face * std::max(uint8(1), uint8(ctx.numMipmaps)) + mip];
+
+  if (out.size() < size) {
+    throw es::RuntimeError("Output span is too small for mipmap!");
+  }
+
+  if (!buffer.empty()) {
+    memcpy(out.data(), buffer.data() + offset, size);
+    return;
+  }
+
+  rd.Push();
+  rd.Seek(dataOffset + offset);
+  rd.ReadBuffer(out.data(), size);
+  rd.Pop();
+}
+
+std::string_view TEX::MipView(std::string_view file, uint32 face,
+                              uint32 mip) const {
+  const size_t size = MipSize(face, mip);
+  const size_t offset =
+      offsets[face * std::max(uint8(1), uint8(ctx.numMipmaps)) + mip];
+
+  if (!buffer.empty()) {
+    return std::string_view(buffer).substr(offset, size);
+  }
+
+  if (dataOffset + offset + size > file.size()) {
+    throw es::RuntimeError("Mipmap out of file bounds!");
+  }
+
+  return file.substr(dataOffset + offset, size);
+}
+
+struct TexelElement {
+  uint32 blockSize = 1; // in pixels
+  uint32 blockBits;
+};
+
+TexelElement GetTexelElement(TexelInputFormatType type) {
+  switch (type) {
+  case TexelInputFormatType::BC1:
+  case TexelInputFormatType::BC4:
+  case TexelInputFormatType::ETC1:
+  case TexelInputFormatType::PVRTC4:
+    return {4, 64};
+  case TexelInputFormatType::BC2:
+  case TexelInputFormatType::BC3:
+  case TexelInputFormatType::BC5:
+  case TexelInputFormatType::BC7:
+  case TexelInputFormatType::ETC1A4:
+    return {4, 128};
+  case TexelInputFormatType::RGBA16:
+    return {1, 64};
+  case TexelInputFormatType::RGBA8:
+  case TexelInputFormatType::RGB10A2:
+    return {1, 32};
+  case TexelInputFormatType::RGB8:
+    return {1, 24};
+  case TexelInputFormatType::RG8:
+  case TexelInputFormatType::RGBA4:
+  case TexelInputFormatType::R5G6B5:
+    return {1, 16};
+  case TexelInputFormatType::R8:
+  case TexelInputFormatType::RG4:
+    return {1, 8};
+  case TexelInputFormatType::R4:
+    return {1, 4};
+  default:
+    throw es::RuntimeError("Unknown texel format!");
+  }
+}
+
+struct MipExtent {
+  uint32 width;  // in elements
+  uint32 height; // in elements
+  uint32 depth;
+  uint32 elementSize; // in bytes, 0 for sub byte elements
+
+  size_t LinearSize(const TexelElement &el) const {
+    return (size_t(width) * height * depth * el.blockBits + 7) / 8;
+  }
+};
+
+MipExtent GetMipExtent(const NewTexelContextCreate &ctx, uint32 mip,
+                       const TexelElement &el) {
+  const uint32 width = std::max(1, ctx.width >> mip);
+  const uint32 height = std::max(1, ctx.height >> mip);
+
+  return {
+      .width = (width + el.blockSize - 1) / el.blockSize,
+      .height = (height + el.blockSize - 1) / el.blockSize,
+      .depth = std::max(1U, uint32(std::max(1, int(ctx.depth))) >> mip),
+      .elementSize = el.blockBits / 8,
+  };
+}
+
+uint32 MortonIndex(uint32 x, uint32 y, uint32 width, uint32 height) {
+  uint32 index = 0;
+  uint32 bit = 0;
+
+  for (uint32 mask = 1; mask < width || mask < height; mask <<= 1) {
+    if (mask < width) {
+      index |= uint32((x & mask) != 0) << bit++;
+    }
+
+    if (mask < height) {
+      index |= uint32((y & mask) != 0) << bit++;
+    }
+  }
+
+  return index;
+}
+
+// Tegra X1 block linear layout, GOB is 64 bytes wide and 8 rows high
+uint32 NXBlockHeight(uint32 heightInElements) {
+  uint32 blockHeight = 16;
+
+  while (blockHeight > 1 && heightInElements <= (blockHeight / 2) * 8) {
+    blockHeight /= 2;
+  }
+
+  return blockHeight;
+}
+
+size_t TiledMipSize(const MipExtent &ext, const TexelElement &el,
+                    TexelTile tile) {
+  switch (tile) {
+  case TexelTile::PS4: {
+    const size_t width = (ext.width + 7) & ~7;
+    const size_t height = (ext.height + 7) & ~7;
+    return width * height * ext.depth * ext.elementSize;
+  }
+  case TexelTile::NX: {
+    const uint32 blockHeight = NXBlockHeight(ext.height);
+    const size_t widthInGobs = (ext.width * ext.elementSize + 63) / 64;
+    const size_t numBlockRows =
+        (ext.height + blockHeight * 8 - 1) / (blockHeight * 8);
+    return numBlockRows * widthInGobs * 512 * blockHeight * ext.depth;
+  }
+  case TexelTile::N3DS: {
+    const size_t tileSize = std::max(1U, 8 / el.blockSize);
+    const size_t width = (ext.width + tileSize - 1) / tileSize * tileSize;
+    const size_t height = (ext.height + tileSize - 1) / tileSize * tileSize;
+    return width * height * ext.depth * ext.elementSize;
+  }
+  default:
+    return ext.LinearSize(el);
+  }
+}
+
+std::vector<uint32> PackedMipOffsets(const NewTexelContextCreate &ctx) {
+  const TexelElement el = GetTexelElement(ctx.baseFormat.type);
+  const uint32 numFaces = std::max(int8(1), ctx.numFaces);
+  const uint32 numMips = std::max(uint8(1), uint8(ctx.numMipmaps));
+  std::vector<uint32> offsets;
+  size_t offset = 0;
+
+  for (uint32 f = 0; f < numFaces; f++) {
+    for (uint32 m = 0; m < numMips; m++) {
+      offsets.emplace_back(offset);
+      offset += TiledMipSize(GetMipExtent(ctx, m, el), el, ctx.baseFormat.tile);
+    }
+  }
+
+  return offsets;
+}
+
+// Inverse of untiling done by texel pipeline for ApplyModifications layouts
+void TileMip(const char *src, char *dst, const MipExtent &ext,
+             const TexelElement &el, TexelTile tile) {
+  if (tile != TexelTile::Morton && tile != TexelTile::PS4 &&
+      tile != TexelTile::NX && tile != TexelTile::N3DS) {
+    memcpy(dst, src, ext.LinearSize(el));
+    return;
+  }
+
+  if (!ext.elementSize || el.blockBits % 8) {
+    throw es::RuntimeError("Cannot tile sub byte texel format!");
+  }
+
+  const size_t elSize = ext.elementSize;
+  const size_t sliceSize = ext.LinearSize(el) / ext.depth;
+  const size_t tiledSliceSize = TiledMipSize(ext, el, tile) / ext.depth;
+  const uint32 tileSize =
+      tile == TexelTile::N3DS ? std::max(1U, 8 / el.blockSize) : 8;
+  const uint32 tilesPerRow = (ext.width + tileSize - 1) / tileSize;
+  const uint32 blockHeight = NXBlockHeight(ext.height);
+  const size_t widthInGobs = (ext.width * elSize + 63) / 64;
+
+  for (uint32 z = 0; z < ext.depth; z++) {
+    const char *srcSlice = src + sliceSize * z;
+    char *dstSlice = dst + tiledSliceSize * z;
+
+    for (uint32 y = 0; y < ext.height; y++) {
+      for (uint32 x = 0; x < ext.width; x++) {
+        size_t dstIndex = 0;
+
+        switch (tile) {
+        case TexelTile::Morton:
+          dstIndex = MortonIndex(x, y, ext.width, ext.height) * elSize;
+          break;
+        case TexelTile::PS4:
+        case TexelTile::N3DS: {
+          const size_t tileIndex = (y / tileSize) * tilesPerRow + x / tileSize;
+          dstIndex = (tileIndex * tileSize * tileSize +
+                      MortonIndex(x % tileSize, y % tileSize, tileSize,
+                                  tileSize)) *
+                     elSize;
+          break;
+        }
+        default: {
+          const size_t xb = x * elSize;
+          const size_t gobRowSize = 512 * blockHeight * widthInGobs;
+          dstIndex = (y / (8 * blockHeight)) * gobRowSize +
+                     (xb / 64) * 512 * blockHeight +
+                     ((y % (8 * blockHeight)) / 8) * 512 +
+                     ((xb % 64) / 32) * 256 + ((y % 8) / 2) * 64 +
+                     ((xb % 32) / 16) * 32 + (y % 2) * 16 + (xb % 16);
+          break;
+        }
+        }
+
+        memcpy(dstSlice + dstIndex,
+               srcSlice + (size_t(y) * ext.width + x) * elSize, elSize);
+      }
+    }
+  }
+}
+
+TEXFormatV2 ConvertToTEXFormat(const TexelInputFormat &fmt,
+                               Platform platform) {
+  const bool isNext = platform == Platform::PS4 || platform == Platform::NSW;
+
+  switch (fmt.type) {
+  case TexelInputFormatType::BC1:
+    return TEXFormatV2::BC1;
+  case TexelInputFormatType::BC2:
+    return fmt.premultAlpha ? TEXFormatV2::BC2_PA : TEXFormatV2::BC2;
+  case TexelInputFormatType::BC3:
+    return fmt.premultAlpha ? TEXFormatV2::BC3_PA : TEXFormatV2::BC3;
+  case TexelInputFormatType::BC4:
+    if (isNext) {
+      return TEXFormatV2::COMPRESSED_GRAYSCALE;
+    }
+    break;
+  case TexelInputFormatType::BC5:
+    if (isNext) {
+      return TEXFormatV2::COMPRESSED_DERIVED_NORMAL_MAP;
+    }
+    break;
+  case TexelInputFormatType::BC7:
+    return fmt.premultAlpha ? TEXFormatV2::BC7_PA : TEXFormatV2::BC7;
+  case TexelInputFormatType::RGBA16:
+    return TEXFormatV2::RGBA16F;
+  case TexelInputFormatType::RGBA8:
+    return fmt.premultAlpha ? TEXFormatV2::RGBA8_PA : TEXFormatV2::RGBA8;
+  case TexelInputFormatType::R8:
+    return TEXFormatV2::R8;
+  case TexelInputFormatType::RGB10A2:
+    return TEXFormatV2::RGB10A2;
+  default:
+    break;
+  }
+
+  throw es::RuntimeError("Texture format is not supported for platform!");
+}
+
+TEXFormat3DS ConvertToTEXFormat3DS(const TexelInputFormat &fmt) {
+  switch (fmt.type) {
+  case TexelInputFormatType::RG8:
+    return TEXFormat3DS::IA8;
+  case TexelInputFormatType::ETC1:
+    return TEXFormat3DS::ETC1;
+  case TexelInputFormatType::ETC1A4:
+    return TEXFormat3DS::ETC1A4;
+  case TexelInputFormatType::R4:
+    return TEXFormat3DS::L4;
+  case TexelInputFormatType::RGB8:
+    return TEXFormat3DS::RGB8;
+  case TexelInputFormatType::RGBA8:
+    return TEXFormat3DS::RGBA8;
+  case TexelInputFormatType::RGBA4:
+    return TEXFormat3DS::RGBA4;
+  case TexelInputFormatType::R5G6B5:
+    return TEXFormat3DS::R5G6B5;
+  case TexelInputFormatType::R8:
+    return TEXFormat3DS::R8;
+  case TexelInputFormatType::RG4:
+    return TEXFormat3DS::RG4;
+  default:
+    throw es::RuntimeError("Texture format is not supported for platform!");
+  }
+}
+
+struct TEXData {
+  std::string buffer;
+  std::vector<uint32> offsets; // relative to buffer begin, face major
+};
+
+TEXData BuildTEXData(const TEX &tex, TexelTile tile, bool swapRGBA) {
+  const TexelElement el = GetTexelElement(tex.ctx.baseFormat.type);
+  const uint32 numFaces = std::max(int8(1), tex.ctx.numFaces);
+  const uint32 numMips = std::max(uint8(1), uint8(tex.ctx.numMipmaps));
+  // Already tiled data are copied verbatim
+  const bool pretiled = tex.ctx.baseFormat.tile != TexelInputFormat{}.tile;
+  const bool hasOffsets = tex.offsets.size() == numFaces * numMips;
+  TEXData retVal;
+  size_t srcOffset = 0;
+
+  for (uint32 f = 0; f < numFaces; f++) {
+    for (uint32 m = 0; m < numMips; m++) {
+      const uint32 index = f * numMips + m;
+      const MipExtent ext = GetMipExtent(tex.ctx, m, el);
+      const size_t srcSize = pretiled ? TiledMipSize(ext, el, tile)
+                                      : ext.LinearSize(el);
+
+      if (hasOffsets) {
+        srcOffset = tex.offsets[index];
+      }
+
+      if (srcOffset + srcSize > tex.buffer.size()) {
+        throw es::RuntimeError("Texel data out of bounds!");
+      }
+
+      const char *src = tex.buffer.data() + srcOffset;
+      srcOffset += srcSize;
+      retVal.offsets.emplace_back(retVal.buffer.size());
+
+      if (pretiled) {
+        retVal.buffer.append(src, srcSize);
+        continue;
+      }
+
+      std::string linear;
+
+      if (swapRGBA) {
+        linear.assign(src, srcSize);
+
+        for (size_t p = 0; p + 4 <= linear.size(); p += 4) {
+          std::reverse(linear.begin() + p, linear.begin() + p + 4);
+        }
+
+        src = linear.data();
+      }
+
+      const size_t tiledSize = TiledMipSize(ext, el, tile);
+      retVal.buffer.resize(retVal.buffer.size() + tiledSize);
+      TileMip(src, retVal.buffer.data() + retVal.offsets.back(), ext, el, tile);
+    }
+  }
+
+  return retVal;
+}
+
+TextureTypeV2 GetTextureTypeV2(const NewTexelContextCreate &ctx) {
+  if (ctx.numFaces == 6) {
+    return TextureTypeV2::Cubemap;
+  } else if (ctx.depth > 1) {
+    return TextureTypeV2::Volume;
+  }
+
+  return TextureTypeV2::General;
+}
+
+TEXx9D MakeTEXx9D(const TEX &tex, uint16 version, uint8 format) {
+  using t = TEXx9D;
+  TEXx9D header{};
+  header.id = TEXID;
+  header.tier0.Set<t::Version>(version);
+  header.tier0.Set<t::TextureType>(uint32(GetTextureTypeV2(tex.ctx)));
+  header.tier1.Set<t::NumMips>(std::max(uint8(1), uint8(tex.ctx.numMipmaps)));
+  header.tier1.Set<t::Width>(tex.ctx.width);
+  header.tier1.Set<t::Height>(tex.ctx.height);
+  header.numFaces = std::max(int8(1), tex.ctx.numFaces);
+  header.format = TEXFormatV2(format);
+  header.depth = std::max(1, int(tex.ctx.depth));
+
+  return header;
+}
+
+void SaveTEXx9D(const TEX &tex, BinWritterRef_e wr, uint16 version,
+                Platform platform) {
+  NewTexelContextCreate tctx = tex.ctx;
+  tctx.baseFormat.tile = TexelInputFormat{}.tile;
+  ApplyModifications(tctx, platform);
+  TEXData data = BuildTEXData(tex, tctx.baseFormat.tile, false);
+  TEXx9D header = MakeTEXx9D(
+      tex, version, uint8(ConvertToTEXFormat(tex.ctx.baseFormat, platform)));
+  wr.Write(header);
+
+  if (tex.ctx.numFaces == 6) {
+    wr.Write(tex.harmonics);
+  }
+
+  const bool wideOffsets = IsPlatformX64(platform) && !wr.SwappedEndian();
+  const size_t dataBegin =
+      wr.Tell() + data.offsets.size() * (wideOffsets ? 8 : 4);
+
+  for (uint32 o : data.offsets) {
+    if (wideOffsets) {
+      wr.Write<uint64>(dataBegin + o);
+    } else {
+      wr.Write<uint32>(dataBegin + o);
+    }
+  }
+
+  wr.WriteContainer(data.buffer);
+}
+
+void SaveTEXxA0(const TEX &tex, BinWritterRef_e wr, uint16 version,
+                Platform platform) {
+  NewTexelContextCreate tctx = tex.ctx;
+  tctx.baseFormat.tile = TexelInputFormat{}.tile;
+  ApplyModifications(tctx, platform);
+  TEXData data = BuildTEXData(tex, tctx.baseFormat.tile, false);
+  TEXx9D header = MakeTEXx9D(
+      tex, version, uint8(ConvertToTEXFormat(tex.ctx.baseFormat, platform)));
+  const bool isCubemap = tex.ctx.numFaces == 6;
+  const uint32 numMips = header.tier1.Get<TEXx9D::NumMips>();
+  wr.Write(header);
+
+  if (isCubemap) {
+    wr.Write(tex.harmonics);
+  }
+
+  wr.Write(uint32(data.buffer.size()));
+
+  // Faces are evenly spaced by faceSize
+  for (uint32 m = 0; m < numMips; m++) {
+    wr.Write(data.offsets[m]);
+  }
+
+  if (isCubemap) {
+    wr.Write(numMips < data.offsets.size() ? data.offsets[numMips]
+                                           : uint32(data.buffer.size()));
+  }
+
+  wr.WriteContainer(data.buffer);
+}
+
+void SaveTEXxA6(const TEX &tex, BinWritterRef_e wr, uint16 version,
+                Platform) {
+  const TEXFormat3DS format = ConvertToTEXFormat3DS(tex.ctx.baseFormat);
+  TEXData data = BuildTEXData(tex, TexelTile::N3DS,
+                              format == TEXFormat3DS::RGBA8 &&
+                                  tex.ctx.baseFormat.tile ==
+                                      TexelInputFormat{}.tile);
+  TEXx9D header = MakeTEXx9D(tex, version, uint8(format));
+  wr.Write(header);
+
+  if (tex.ctx.numFaces == 6) {
+    wr.Write(tex.harmonics);
+  }
+
+  wr.WriteContainer(data.offsets);
+  wr.WriteContainer(data.buffer);
+}
+
+static const std::map<uint16, void (*)(const TEX &, BinWritterRef_e, uint16,
+                                       Platform)>
+    texSavers{
+        {0x97, SaveTEXx9D}, {0x98, SaveTEXx9D}, {0x99, SaveTEXx9D},
+        {0x9A, SaveTEXx9D}, {0x9D, SaveTEXx9D}, {0xA0, SaveTEXxA0},
+        {0xA3, SaveTEXxA0}, {0xA5, SaveTEXxA6}, {0xA6, SaveTEXxA6},
+    };
+
+void TEX::Save(BinWritterRef_e wr, uint16 version, Platform platform) const {
+  auto found = texSavers.find(version);
+
+  if (es::IsEnd(texSavers, found)) {
+    throw es::InvalidVersionError(version);
+  }
+
+  if (platform == Platform::Auto) {
+    platform = Platform::Win32;
+  }
+
+  if (IsPlatformBigEndian(platform)) {
+    wr.SwapEndian(true);
+  }
+
+  found->second(*this, wr, version, platform);
+}
+
+void TEX::GenerateMipmaps(uint8 numMips) {
+  uint32 numChannels = 0;
+
+  switch (ctx.baseFormat.type) {
+  case TexelInputFormatType::RGBA8:
+    numChannels = 4;
+    break;
+  case TexelInputFormatType::RG8:
+    numChannels = 2;
+    break;
+  case TexelInputFormatType::R8:
+    numChannels = 1;
+    break;
+  default:
+    throw es::RuntimeError(
+        "Mipmaps can be generated only for 8bit uncompressed formats!");
+  }
+
+  if (ctx.baseFormat.tile != TexelInputFormat{}.tile || ctx.depth > 1) {
+    throw es::RuntimeError(
+        "Mipmaps can be generated only for linear 2D textures!");
+  }
+
+  uint8 maxMips = 1;
+
+  while ((std::max(ctx.width, ctx.height) >> maxMips) > 0) {
+    maxMips++;
+  }
+
+  numMips = numMips ? std::min(numMips, maxMips) : maxMips;
+
+  const uint32 numFaces = std::max(int8(1), ctx.numFaces);
+  const uint32 oldNumMips = std::max(uint8(1), uint8(ctx.numMipmaps));
+  std::vector<uint32> mipOffsets;
+  size_t faceSize = 0;
+
+  for (uint32 m = 0; m < numMips; m++) {
+    mipOffsets.emplace_back(faceSize);
+    faceSize += size_t(std::max(1, ctx.width >> m)) *
+                std::max(1, ctx.height >> m) * numChannels;
+  }
+
+  std::string newBuffer(faceSize * numFaces, '\0');
+  std::vector<uint32> newOffsets;
+  const size_t topSize = size_t(ctx.width) * ctx.height * numChannels;
+
+  for (uint32 f = 0; f < numFaces; f++) {
+    const size_t srcOffset = offsets.size() == numFaces * oldNumMips
+                                 ? offsets[f * oldNumMips]
+                                 : f * topSize;
+
+    if (srcOffset + topSize > buffer.size()) {
+      throw es::RuntimeError("Texel data out of bounds!");
+    }
+
+    memcpy(newBuffer.data() + faceSize * f, buffer.data() + srcOffset,
+           topSize);
+
+    for (uint32 m : mipOffsets) {
+      newOffsets.emplace_back(faceSize * f + m);
+    }
+  }
+
+  // Box filter, every level is split by rows of all faces
+  for (uint32 m = 1; m < numMips; m++) {
+    const uint32 srcWidth = std::max(1, ctx.width >> (m - 1));
+    const uint32 srcHeight = std::max(1, ctx.height >> (m - 1));
+    const uint32 dstWidth = std::max(1, ctx.width >> m);
+    const uint32 dstHeight = std::max(1, ctx.height >> m);
+
+    ParallelFor(numFaces * dstHeight, [&](size_t row) {
+      const uint32 face = row / dstHeight;
+      const uint32 y = row % dstHeight;
+      auto src = reinterpret_cast<const uint8 *>(
+          newBuffer.data() + faceSize * face + mipOffsets[m - 1]);
+      auto dst = reinterpret_cast<uint8 *>(newBuffer.data() + faceSize * face +
+                                           mipOffsets[m]);
+      const uint32 y0 = std::min(y * 2, srcHeight - 1);
+      const uint32 y1 = std::min(y * 2 + 1, srcHeight - 1);
+
+      for (uint32 x = 0; x < dstWidth; x++) {
+        const uint32 x0 = std::min(x * 2, srcWidth - 1);
+        const uint32 x1 = std::min(x * 2 + 1, srcWidth - 1);
+
+        for (uint32 c = 0; c < numChannels; c++) {
+          auto At = [&](uint32 sx, uint32 sy) {
+            return uint32(src[(size_t(sy) * srcWidth + sx) * numChannels + c]);
+          };
+
+          dst[(size_t(y) * dstWidth + x) * numChannels + c] =
+              (At(x0, y0) + At(x1, y0) + At(x0, y1) + At(x1, y1) + 2) / 4;
+        }
+      }
+    });
+  }
+
+  buffer = std::move(newBuffer);
+  offsets = std::move(newOffsets);
+  ctx.numMipmaps = numMips;
+}
+
+void TEX::ComputeHarmonics() {
+  if (ctx.numFaces != 6) {
+    throw es::RuntimeError("Harmonics can be computed only for cubemaps!");
+  }
+
+  if (ctx.baseFormat.type != TexelInputFormatType::RGBA8 ||
+      ctx.baseFormat.tile != TexelInputFormat{}.tile) {
+    throw es::RuntimeError(
+        "Harmonics can be computed only from linear RGBA8 data!");
+  }
+
+  const uint32 numMips = std::max(uint8(1), uint8(ctx.numMipmaps));
+  const size_t faceSize = size_t(ctx.width) * ctx.height * 4;
+  double coeffs[9][3]{};
+  double totalWeight = 0;
+
+  for (uint32 f = 0; f < 6; f++) {
+    const size_t faceOffset =
+        offsets.size() == 6 * numMips ? offsets[f * numMips] : 0;
+    size_t packedOffset = 0;
+
+    // Tightly packed faces, compute begin of face
+    if (offsets.size() != 6 * numMips) {
+      for (uint32 m = 0; m < numMips; m++) {
+        packedOffset += size_t(std::max(1, ctx.width >> m)) *
+                        std::max(1, ctx.height >> m) * 4;
+      }
+
+      packedOffset *= f;
+    }
+
+    if (faceOffset + packedOffset + faceSize > buffer.size()) {
+      throw es::RuntimeError("Texel data out of bounds!");
+    }
+
+    auto texels = reinterpret_cast<const uint8 *>(buffer.data() + faceOffset +
+                                                  packedOffset);
+
+    for (uint32 y = 0; y < ctx.height; y++) {
+      for (uint32 x = 0; x < ctx.width; x++) {
+        const double u = (2.0 * (x + 0.5) / ctx.width) - 1.0;
+        const double v = (2.0 * (y + 0.5) / ctx.height) - 1.0;
+        double dir[3];
+
+        // D3D cubemap face orientation
+        switch (f) {
+        case 0:
+          dir[0] = 1, dir[1] = -v, dir[2] = -u;
+          break;
+        case 1:
+          dir[0] = -1, dir[1] = -v, dir[2] = u;
+          break;
+        case 2:
+          dir[0] = u, dir[1] = 1, dir[2] = v;
+          break;
+        case 3:
+          dir[0] = u, dir[1] = -1, dir[2] = -v;
+          break;
+        case 4:
+          dir[0] = u, dir[1] = -v, dir[2] = 1;
+          break;
+        default:
+          dir[0] = -u, dir[1] = -v, dir[2] = -1;
+          break;
+        }
+
+        const double len2 = dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2];
+        const double invLen = 1.0 / std::sqrt(len2);
+        const double dx = dir[0] * invLen;
+        const double dy = dir[1] * invLen;
+        const double dz = dir[2] * invLen;
+        const double weight = 4.0 / (len2 * std::sqrt(len2));
+        const double basis[9]{
+            0.282095,
+            0.488603 * dy,
+            0.488603 * dz,
+            0.488603 * dx,
+            1.092548 * dx * dy,
+            1.092548 * dy * dz,
+            0.315392 * (3 * dz * dz - 1),
+            1.092548 * dx * dz,
+            0.546274 * (dx * dx - dy * dy),
+        };
+        const uint8 *texel = texels + (size_t(y) * ctx.width + x) * 4;
+
+        for (uint32 b = 0; b < 9; b++) {
+          for (uint32 c = 0; c < 3; c++) {
+            coeffs[b][c] += basis[b] * weight * (texel[c] / 255.0);
+          }
+        }
+
+        totalWeight += weight;
+      }
+    }
+  }
+
+  const double normalize = 4.0 * 3.14159265358979323846 / totalWeight;
+
+  for (uint32 b = 0; b < 9; b++) {
+    for (uint32 c = 0; c < 3; c++) {
+      harmonics[b * 3 + c] = coeffs[b][c] * normalize;
+    }
+  }
+}
@@ -0,0 +1,226 @@
+/*  Revil Format Library
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "revil/trace.hpp"
+#include <ostream>
+
+#ifdef REVIL_TRACING
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace revil {
+namespace {
+struct TraceEvent {
+  const char *stage;
+  uint64 begin;
+  uint64 duration;
+  size_t bytes;
+};
+
+// Events are owned by registry, they outlive threads that recorded them
+struct ThreadEvents {
+  uint32 threadId;
+  std::mutex mutex;
+  std::vector<TraceEvent> events;
+};
+
+struct TraceRegistry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadEvents>> threads;
+  std::chrono::steady_clock::time_point origin =
+      std::chrono::steady_clock::now();
+};
+
+TraceRegistry &Registry() {
+  static TraceRegistry registry;
+  return registry;
+}
+
+std::atomic_bool ENABLED{false};
+
+uint64 Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - Registry().origin)
+      .count();
+}
+
+ThreadEvents &LocalEvents() {
+  thread_local std::shared_ptr<ThreadEvents> local = [] {
+    auto &reg = Registry();
+    auto events = std::make_shared<ThreadEvents>();
+    std::lock_guard<std::mutex> lg(reg.mutex);
+    events->threadId = reg.threads.size() + 1;
+    reg.threads.emplace_back(events);
+    return events;
+  }();
+
+  return *local;
+}
+
+template <class Fn> void ForEachEvent(Fn &&fn) {
+  auto &reg = Registry();
+  std::lock_guard<std::mutex> lg(reg.mutex);
+
+  for (auto &t : reg.threads) {
+    std::lock_guard<std::mutex> tlg(t->mutex);
+
+    for (auto &e : t->events) {
+      fn(t->threadId, e);
+    }
+  }
+}
+
+struct TraceAtExit {
+  std::string path;
+
+  TraceAtExit() {
+    Registry();
+
+    if (const char *env = std::getenv("REVIL_TRACE"); env && *env) {
+      path = env;
+      ENABLED = true;
+    }
+  }
+
+  ~TraceAtExit() {
+    if (path.empty()) {
+      return;
+    }
+
+    std::ofstream str(path);
+
+    if (str.fail()) {
+      std::cerr << "Cannot write trace into " << path << '\n';
+    } else {
+      TraceWriteChrome(str);
+    }
+
+    TraceWriteSummary(std::cerr);
+  }
+} TRACE_AT_EXIT;
+} // namespace
+
+TraceZone::TraceZone(const char *stage_, size_t bytes_)
+    : stage(stage_), bytes(bytes_), begin(ENABLED ? Now() : 0) {}
+
+TraceZone::~TraceZone() {
+  if (!ENABLED || !begin) {
+    return;
+  }
+
+  const uint64 end = Now();
+  ThreadEvents &local = LocalEvents();
+  std::lock_guard<std::mutex> lg(local.mutex);
+  local.events.push_back({stage, begin, end - begin, bytes});
+}
+
+void TraceEnable(bool enable) { ENABLED = enable; }
+
+bool TraceEnabled() { return ENABLED; }
+
+void TraceClear() {
+  auto &reg = Registry();
+  std::lock_guard<std::mutex> lg(reg.mutex);
+
+  for (auto &t : reg.threads) {
+    std::lock_guard<std::mutex> tlg(t->mutex);
+    t->events.clear();
+  }
+}
+
+void TraceWriteChrome(std::ostream &str) {
+  str << "{\"traceEvents\":[";
+  bool first = true;
+  str << std::fixed << std::setprecision(3);
+
+  ForEachEvent([&](uint32 threadId, const TraceEvent &e) {
+    if (!first) {
+      str << ',';
+    }
+
+    first = false;
+    str << "\n{\"name\":\"" << e.stage << "\",\"cat\":\"revil\",\"ph\":\"X\""
+        << ",\"ts\":" << e.begin / 1000.0 << ",\"dur\":" << e.duration / 1000.0
+        << ",\"pid\":1,\"tid\":" << threadId << ",\"args\":{\"bytes\":"
+        << e.bytes << "}}";
+  });
+
+  str << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void TraceWriteSummary(std::ostream &str) {
+  struct Stage {
+    size_t count = 0;
+    uint64 duration = 0;
+    size_t bytes = 0;
+  };
+
+  std::map<std::string_view, Stage> stages;
+
+  ForEachEvent([&](uint32, const TraceEvent &e) {
+    Stage &s = stages[e.stage];
+    s.count++;
+    s.duration += e.duration;
+    s.bytes += e.bytes;
+  });
+
+  std::vector<std::pair<std::string_view, Stage>> sorted(stages.begin(),
+                                                         stages.end());
+  std::sort(sorted.begin(), sorted.end(), [](auto &a, auto &b) {
+    return a.second.duration > b.second.duration;
+  });
+
+  str << std::left << std::setw(24) << "stage" << std::right << std::setw(10)
+      << "calls" << std::setw(14) << "total ms" << std::setw(12) << "avg us"
+      << std::setw(12) << "MB/s" << '\n';
+  str << std::fixed << std::setprecision(2);
+
+  for (auto &[name, s] : sorted) {
+    const double seconds = s.duration / 1e9;
+    str << std::left << std::setw(24) << name << std::right << std::setw(10)
+        << s.count << std::setw(14) << s.duration / 1e6 << std::setw(12)
+        << s.duration / 1e3 / s.count << std::setw(12);
+
+    if (s.bytes && seconds > 0) {
+      str << s.bytes / seconds / (1024 * 1024);
+    } else {
+      str << '-';
+    }
+
+    str << '\n';
+  }
+}
+} // namespace revil
+#else
+namespace revil {
+void TraceEnable(bool) {}
+bool TraceEnabled() { return false; }
+void TraceWriteChrome(std::ostream &str) { str << "{\"traceEvents\":[]}\n"; }
+void TraceWriteSummary(std::ostream &) {}
+void TraceClear() {}
+} // namespace revil
+#endif
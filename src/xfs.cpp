@@ -18,6 +18,7 @@
 #include "revil/xfs.hpp"
 #include "pugixml.hpp"
 #include "revil/hashreg.hpp"
+#include "revil/trace.hpp"
 #include "spike/io/binreader.hpp"
 #include "spike/io/binwritter.hpp"
 #include "spike/reflect/reflector.hpp"
@@ -25,6 +26,7 @@
 #include "spike/type/bitfield.hpp"
 #include "spike/type/matrix44.hpp"
 #include "spike/type/vectors_simd.hpp"
+#include "stream_extent.hpp"
 #include <algorithm>
 #include <deque>
 #include <vector>
@@ -183,7 +185,9 @@ template <class PadType> struct XFSClass {
   void Read(BinReaderRef_e rd) {
     rd.Read(hash);
     rd.Read(info.data);
-    rd.ReadContainer(members, info->Get<XFSClassInfo::NumMembers>());
+    const size_t numMembers = info->Get<XFSClassInfo::NumMembers>();
+    CheckTable(rd, numMembers, sizeof(uint32) * 2 + sizeof(PadType) * 4);
+    rd.ReadContainer(members, numMembers);
   }
 };
 
@@ -199,7 +203,10 @@ template <class PtrType, bool PSN> struct XFSClassV2 {
       rd.Skip(4);
     }
 
-    rd.ReadContainer<PtrType>(members);
+    PtrType numMembers;
+    rd.Read(numMembers);
+    CheckTable(rd, numMembers, sizeof(PtrType) * (PSN ? 10 : 6));
+    rd.ReadContainer(members, numMembers);
   }
 };
 
@@ -429,7 +436,8 @@ public:
   XFSClassData *root;
 
   template <class PtrType>
-  void ReadData(BinReaderRef_e rd, XFSClassData **root = nullptr);
+  void ReadData(BinReaderRef_e rd, XFSClassData **root = nullptr,
+                size_t depth = 0);
   void ToXML(const XFSClassData &item, pugi::xml_node node);
   void ToXML(pugi::xml_node node);
   void RTTIToXML(pugi::xml_node node);
@@ -445,8 +453,45 @@ void XFS::ToXML(pugi::xml_node node) const { pi->ToXML(node); }
 
 void XFS::RTTIToXML(pugi::xml_node node) const { pi->RTTIToXML(node); }
 
+// Smallest stored size of array item, class items store at least their meta
+static size_t XFSItemSize(XFSType type) {
+  switch (type) {
+  case XFSType::s16_:
+  case XFSType::u16_:
+    return 2;
+  case XFSType::f32_:
+  case XFSType::s32_:
+  case XFSType::u32_:
+  case XFSType::color_:
+  case XFSType::class_:
+  case XFSType::classref_:
+    return 4;
+  case XFSType::s64_:
+  case XFSType::u64_:
+  case XFSType::point_:
+  case XFSType::size_:
+  case XFSType::vector3_:
+    return 8;
+  case XFSType::vector4_:
+  case XFSType::_vector4_:
+    return 16;
+  case XFSType::_matrix_:
+    return 64;
+  default:
+    return 1;
+  }
+}
+
+// Nested classes are read recursively, deeper trees are rejected
+static constexpr size_t XFS_MAX_DEPTH = 0x100;
+
 template <class PtrType>
-void XFSImpl::ReadData(BinReaderRef_e rd, XFSClassData **root) {
+void XFSImpl::ReadData(BinReaderRef_e rd, XFSClassData **root,
+                       size_t depth) {
+  if (depth > XFS_MAX_DEPTH) {
+    throw es::RuntimeError("Class nesting is too deep");
+  }
+
   XFSMeta meta;
   rd.Read(meta.data);
 
@@ -518,7 +563,8 @@ void XFSImpl::ReadData(BinReaderRef_e rd, XFSClassData **root) {
       case XFSType::class_:
       case XFSType::classref_:
         ReadData<PtrType>(
-            rd, reinterpret_cast<XFSClassData **>(&cType.data.asPointer));
+            rd, reinterpret_cast<XFSClassData **>(&cType.data.asPointer),
+            depth + 1);
         break;
       case XFSType::_resource_:
         rd.Read(*cType.AllocClass<XFSDataResource>());
@@ -528,6 +574,8 @@ void XFSImpl::ReadData(BinReaderRef_e rd, XFSClassData **root) {
                                  std::to_string(rd.Tell()));
       }
     } else {
+      CheckTable(rd, cType.numItems, XFSItemSize(d.type));
+
       switch (d.type) {
       case XFSType::bool_:
       case XFSType::s8_:
@@ -604,7 +652,7 @@ void XFSImpl::ReadData(BinReaderRef_e rd, XFSClassData **root) {
       case XFSType::classref_: {
         auto adata = cType.AllocArray<XFSClassData *>(cType.numItems);
         for (size_t i = 0; i < cType.numItems; i++) {
-          ReadData<PtrType>(rd, adata++);
+          ReadData<PtrType>(rd, adata++, depth + 1);
         }
         break;
       }
@@ -886,6 +934,7 @@ void XFSImpl::ToXML(const XFSClassData &item, pugi::xml_node node) {
 }
 
 void XFSImpl::ToXML(pugi::xml_node node) {
+  TraceZone zone("xfs.to_xml");
   auto rNode = node.append_child("class");
   auto &&rootData = *root;
   XMLSetType(rootData, rNode);
@@ -905,7 +954,8 @@ template <class PtrType> void Load(XFSImpl &main, BinReaderRef_e rd) {
   rd.SetRelativeOrigin(rd.Tell(), false);
   std::vector<uint32> layoutOffsets;
   std::vector<XFSClass<PtrType>> layouts;
-  rd.ReadContainer(layoutOffsets, header.numLayouts);
+  ReadTable(rd, layoutOffsets, header.numLayouts);
+  CheckTable(rd, header.numLayouts, sizeof(uint32) * 2);
   rd.ReadContainer(layouts, header.numLayouts);
   rd.Seek(header.dataStart);
 
@@ -923,7 +973,7 @@ template <class PtrType> void Load(XFSImpl &main, BinReaderRef_e rd) {
 template <class PtrType>
 void LoadV2(XFSImpl &main, BinReaderRef_e rd, XFSHeaderV2 &header) {
   std::vector<PtrType> layoutOffsets;
-  rd.ReadContainer(layoutOffsets, header.numLayouts);
+  ReadTable(rd, layoutOffsets, header.numLayouts);
 
   // Determine member padding
   rd.Push();
@@ -938,7 +988,8 @@ void LoadV2(XFSImpl &main, BinReaderRef_e rd, XFSHeaderV2 &header) {
 
   const size_t expectedEnd =
       layoutOffsets.size() > 1 ? layoutOffsets.at(1) : nameOffset;
-  const size_t memberSize = (expectedEnd - memberBegin) / numMembers;
+  const size_t memberSize =
+      numMembers ? (expectedEnd - memberBegin) / numMembers : 0;
 
   constexpr size_t singleMemberSize = sizeof(PtrType) * 6;
   constexpr size_t singleMemberSizePSN = sizeof(PtrType) * 10;
@@ -959,7 +1010,7 @@ void LoadV2(XFSImpl &main, BinReaderRef_e rd, XFSHeaderV2 &header) {
                    std::back_inserter(main.rtti),
                    [](auto &&item) { return std::move(item); });
   } else {
-    es::RuntimeError("Cannot detect member padding");
+    throw es::RuntimeError("Cannot detect member padding");
   }
 
   rd.Seek(header.dataStart);
@@ -984,6 +1035,7 @@ bool LoadV2(XFSImpl &main, BinReaderRef_e rd) {
 }
 
 void XFSImpl::Load(BinReaderRef_e rd, bool openEnded) {
+  TraceZone zone("xfs.load");
   using pt = Platform;
   XFSHeaderBase hdr;
   rd.Push();
@@ -1021,14 +1073,20 @@ void XFSImpl::Load(BinReaderRef_e rd, bool openEnded) {
 #endif
   }
 
-  if (isX64) {
-    ReadData<uint64>(rd);
-  } else {
-    ReadData<uint32>(rd);
+  {
+    TraceZone dataZone("xfs.read_data");
+
+    if (isX64) {
+      ReadData<uint64>(rd);
+    } else {
+      ReadData<uint32>(rd);
+    }
   }
+
   root = &dataStore.back();
 
   const size_t eof = rd.GetSize();
+  zone.Bytes(eof);
 
   if (!openEnded && eof != rd.Tell()) {
     throw es::RuntimeError("Unexpected eof");
@@ -0,0 +1,107 @@
+#pragma once
+#include "../toolset/arc_conv/arc_update.hpp"
+#include "revil/arc.hpp"
+#include "revil/hashreg.hpp"
+#include "spike/util/unit_testing.hpp"
+#include "synth.hpp"
+#include <cstring>
+#include <map>
+#include <sstream>
+
+// Updating one entry must leave data and flags of other entries intact
+int test_arc_update() {
+  struct CollectContext : revil::ArcExtractContext {
+    std::map<std::string, std::string> files;
+    std::string *current = nullptr;
+
+    void NewFile(const std::string &path) override { current = &files[path]; }
+    void SendData(std::string_view data) override { current->append(data); }
+  };
+
+  auto Extract = [](const std::string &arc, std::string_view title) {
+    std::stringstream str(arc);
+    CollectContext ctx;
+    revil::EnumerateArchive(
+        str, revil::Platform::Win32, title, [&] { return &ctx; }, {});
+    return ctx.files;
+  };
+
+  synth::ARCSettings settings{.numFiles = 8};
+  std::string arc = synth::MakeARC(settings);
+  const size_t tableBegin = arc.find(synth::MakePaths(settings.numFiles)[0]);
+  TEST_EQUAL(tableBegin != arc.npos, true);
+
+  // Every entry gets different flags
+  for (size_t f = 0; f < settings.numFiles; f++) {
+    char *sizeAndFlags = arc.data() + tableBegin + f * sizeof(ARCFile) + 0x48;
+    uint32 raw;
+    memcpy(&raw, sizeAndFlags, sizeof(raw));
+    raw = (raw & 0x1fffffff) | (uint32(f) << 29);
+    memcpy(sizeAndFlags, &raw, sizeof(raw));
+  }
+
+  std::stringstream baseStr(arc);
+  std::vector<ARCTableEntry> table = ReadARCEntries(baseStr, false);
+  TEST_EQUAL(table.size(), settings.numFiles);
+
+  const std::string payload(0x300, 'u');
+  std::string compressed(0x8000, 0);
+  compressed.resize(revil::CompressZlib(
+      payload, compressed,
+      revil::GetTitleSupport(settings.title, settings.platform)->arc.windowSize,
+      9));
+
+  const size_t updated = 3;
+  std::vector<ARCTableEntry> newFiles(1);
+  ARCTableEntry &entry = newFiles.front();
+  entry.path = table[updated].path;
+  entry.hash = table[updated].hash;
+  entry.offset = 0;
+  entry.uSize = uint32(payload.size());
+  entry.cSize = compressed.size();
+  entry.baseIndex = updated;
+
+  const std::vector<ARCRun> runs =
+      MergeARCTable(table, std::move(newFiles), tableBegin, sizeof(ARCFile));
+  TEST_EQUAL(table.size(), settings.numFiles);
+
+  std::stringstream updatedStr;
+  updatedStr.write(arc.data(), tableBegin);
+  BinWritterRef wr(updatedStr);
+
+  for (auto &f : table) {
+    WriteARCEntry(wr, f, false, true);
+  }
+
+  for (auto &r : runs) {
+    updatedStr.write(arc.data() + r.begin, r.end - r.begin);
+  }
+
+  updatedStr.write(compressed.data(), compressed.size());
+
+  const std::string updatedArc = std::move(updatedStr).str();
+  auto baseFiles = Extract(arc, settings.title);
+  auto updatedFiles = Extract(updatedArc, settings.title);
+  TEST_EQUAL(updatedFiles.size(), baseFiles.size());
+
+  std::stringstream tableStr(updatedArc);
+  auto [hdr, files] = ReadARC(tableStr);
+
+  for (size_t f = 0; f < files.size(); f++) {
+    const uint32 flags =
+        files[f].uncompressedSize.sizeAndFlags.Get<ARCFileSize::Flags>();
+    TEST_EQUAL(flags, f == updated ? 2 : f);
+  }
+
+  const std::string updatedPath = std::string(files[updated].fileName) + ".";
+
+  for (auto &[path, data] : baseFiles) {
+    if (path.starts_with(updatedPath)) {
+      TEST_EQUAL(updatedFiles.at(path) == payload, true);
+    } else {
+      TEST_EQUAL(updatedFiles.at(path) == data, true);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,461 @@
+#include "synth.hpp"
+#include "pugixml.hpp"
+#include "revil/arc.hpp"
+#include "revil/hashreg.hpp"
+#include "revil/lmt.hpp"
+#include "revil/mod.hpp"
+#include "revil/re_asset.hpp"
+#include "revil/sdl.hpp"
+#include "revil/tex.hpp"
+#include "revil/xfs.hpp"
+#include "spike/except.hpp"
+#include "spike/io/binreader_stream.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <spanstream>
+
+// Usage:
+//   revil_bench --generate <dir>
+//   revil_bench [--fixtures <dir>] [--rounds N] [--filter text]
+//               [--output file.json]
+// Missing fixtures are generated in memory.
+
+#ifndef REVIL_BENCH_FIXTURES
+#define REVIL_BENCH_FIXTURES "bench_fixtures"
+#endif
+
+struct Fixture {
+  std::string_view fileName;
+  std::string (*make)();
+};
+
+static const Fixture FIXTURES[]{
+    {"arc_zlib.arc",
+     [] {
+       return synth::MakeARC({.title = "re5",
+                              .compression = synth::ARCCompression::Zlib,
+                              .numFiles = 2048});
+     }},
+    {"arc_lzx.arc",
+     [] {
+       return synth::MakeARC({.title = "dmc4",
+                              .compression = synth::ARCCompression::LZX,
+                              .numFiles = 2048});
+     }},
+    {"arc_arcc.arc",
+     [] {
+       return synth::MakeARC({.title = "ddon",
+                              .compression = synth::ARCCompression::ARCC,
+                              .numFiles = 2048});
+     }},
+    {"texture.tex", [] { return synth::MakeTEX({.size = 2048}); }},
+    {"motion.lmt",
+     [] {
+       return synth::MakeLMT(
+           {.numAnimations = 64, .numBones = 48, .numKeys = 60});
+     }},
+    {"motion_bilinear.lmt",
+     [] {
+       return synth::MakeLMT({.platform = revil::Platform::Win32,
+                              .codecs = synth::LMTCodecs::BiLinear,
+                              .numAnimations = 64,
+                              .numBones = 48,
+                              .numKeys = 60});
+     }},
+    {"model_x99.mod",
+     [] {
+       return synth::MakeMOD({.version = revil::MODVersion::X99,
+                              .numMeshes = 256,
+                              .numVertices = 1024});
+     }},
+    {"model_19c.mod",
+     [] {
+       return synth::MakeMOD({.version = revil::MODVersion::X19C,
+                              .numMeshes = 256,
+                              .numVertices = 1024});
+     }},
+    {"model_xc5.mod",
+     [] {
+       return synth::MakeMOD({.version = revil::MODVersion::XC5,
+                              .numMeshes = 256,
+                              .numVertices = 1024});
+     }},
+    {"data.xfs", [] { return synth::MakeXFS({.numItems = 2048}); }},
+    {"scheduler.sdl",
+     [] {
+       return synth::MakeSDL(
+           {.numNodes = 512, .numTracks = 16, .numFrames = 32});
+     }},
+    {"motion.motlist.99",
+     [] {
+       return synth::MakeREMotionList(
+           {.numAnimations = 16, .numBones = 48, .numKeys = 60});
+     }},
+};
+
+struct BenchResult {
+  std::string name;
+  size_t bytes;
+  std::vector<uint64> samples;
+};
+
+struct BenchContext {
+  std::string fixturesDir = REVIL_BENCH_FIXTURES;
+  std::string filter;
+  std::string output;
+  uint32 numRounds = 10;
+  std::map<std::string_view, std::string> fixtures;
+  std::vector<BenchResult> results;
+  uint64 sink = 0;
+
+  const std::string &Fixture(std::string_view fileName) {
+    auto found = fixtures.find(fileName);
+
+    if (found != fixtures.end()) {
+      return found->second;
+    }
+
+    auto fixture =
+        std::find_if(std::begin(FIXTURES), std::end(FIXTURES),
+                     [&](auto &f) { return f.fileName == fileName; });
+    std::string &data = fixtures[fixture->fileName];
+    std::ifstream str(fixturesDir + "/" + std::string(fileName),
+                      std::ios::binary);
+
+    if (str.fail()) {
+      printf("Generating missing fixture: %s\n", fixture->fileName.data());
+      data = fixture->make();
+    } else {
+      data.assign(std::istreambuf_iterator<char>(str), {});
+    }
+
+    return data;
+  }
+
+  // One warmup call, then numRounds timed calls
+  template <class Fn> void Run(std::string_view name, size_t bytes, Fn &&fn) {
+    if (!filter.empty() && name.find(filter) == name.npos) {
+      return;
+    }
+
+    BenchResult &result = results.emplace_back();
+    result.name = name;
+    result.bytes = bytes;
+    fn();
+
+    for (uint32 r = 0; r < numRounds; r++) {
+      const auto start = std::chrono::steady_clock::now();
+      fn();
+      const auto elapsed = std::chrono::steady_clock::now() - start;
+      result.samples.emplace_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+              .count());
+    }
+  }
+};
+
+std::ispanstream FixtureStream(const std::string &data) {
+  return std::ispanstream(std::span<const char>(data.data(), data.size()));
+}
+
+struct SinkContext : revil::ArcExtractContext {
+  uint64 &sink;
+  SinkContext(uint64 &sink_) : sink(sink_) {}
+
+  void NewFile(const std::string &path) override { sink += path.size(); }
+  void SendData(std::string_view data) override {
+    sink += data.size() + uint8(data.front()) + uint8(data.back());
+  }
+};
+
+void BenchARC(BenchContext &ctx) {
+  static const std::pair<std::string_view, std::string_view> ARCS[]{
+      {"arc_zlib.arc", "re5"},
+      {"arc_lzx.arc", "dmc4"},
+      {"arc_arcc.arc", "ddon"},
+  };
+
+  for (auto [fileName, title] : ARCS) {
+    std::string name("EnumerateArchive/");
+    name.append(fileName.substr(0, fileName.find('.')));
+    auto &data = ctx.Fixture(fileName);
+
+    ctx.Run(name, data.size(), [&] {
+      auto str = FixtureStream(data);
+      SinkContext ectx(ctx.sink);
+      revil::EnumerateArchive(
+          str, revil::Platform::Win32, title, [&] { return &ectx; }, {});
+    });
+  }
+}
+
+void BenchLMT(BenchContext &ctx, std::string_view fileName,
+              std::string_view suffix) {
+  auto &data = ctx.Fixture(fileName);
+  const std::string loadName = std::string("LMT::Load").append(suffix);
+  const std::string valueName = std::string("LMT::GetValue").append(suffix);
+
+  ctx.Run(loadName, data.size(), [&] {
+    auto str = FixtureStream(data);
+    revil::LMT lmt;
+    lmt.Load(str);
+    ctx.sink += uint8(lmt.Version());
+  });
+
+  auto str = FixtureStream(data);
+  revil::LMT lmt;
+  lmt.Load(str);
+  uni::MotionsConst motions = lmt;
+  size_t numSamples = 0;
+
+  auto NumFrames = [](auto &m) {
+    return static_cast<const revil::LMTAnimation *>(m.get())->NumFrames();
+  };
+
+  for (auto m : *motions) {
+    m->FrameRate(60);
+    numSamples += m->Tracks()->Size() * (NumFrames(m) + 1);
+  }
+
+  ctx.Run(valueName, numSamples * sizeof(Vector4A16), [&] {
+    Vector4A16 accum(0.f, 0.f, 0.f, 0.f);
+
+    for (auto m : *motions) {
+      const size_t numFrames = NumFrames(m);
+
+      for (auto t : *m) {
+        for (size_t f = 0; f <= numFrames; f++) {
+          Vector4A16 value;
+          t->GetValue(value, f / 60.f);
+          accum += value;
+        }
+      }
+    }
+
+    ctx.sink += uint32(accum.X);
+  });
+}
+
+void BenchMOD(BenchContext &ctx) {
+  for (auto fileName : {"model_x99.mod", "model_19c.mod", "model_xc5.mod"}) {
+    std::string_view fileNameView(fileName);
+    std::string name("MOD::Load/");
+    name.append(fileNameView.substr(6, fileNameView.find('.') - 6));
+    auto &data = ctx.Fixture(fileName);
+
+    ctx.Run(name, data.size(), [&] {
+      auto str = FixtureStream(data);
+      revil::MOD mod;
+      mod.Load(str);
+      ctx.sink += mod.Primitives().size();
+    });
+  }
+}
+
+void BenchTEX(BenchContext &ctx) {
+  auto &data = ctx.Fixture("texture.tex");
+
+  ctx.Run("TEX::Load", data.size(), [&] {
+    auto str = FixtureStream(data);
+    revil::TEX tex;
+    tex.Load(str, revil::Platform::Win32);
+    ctx.sink += tex.buffer.size();
+  });
+}
+
+void BenchXFS(BenchContext &ctx) {
+  auto &data = ctx.Fixture("data.xfs");
+
+  ctx.Run("XFS::Load", data.size(), [&] {
+    auto str = FixtureStream(data);
+    revil::XFS xfs;
+    xfs.Load(str);
+  });
+
+  auto str = FixtureStream(data);
+  revil::XFS xfs;
+  xfs.Load(str);
+
+  ctx.Run("XFS::ToXML", data.size(), [&] {
+    pugi::xml_document doc;
+    xfs.ToXML(doc);
+    ctx.sink += !doc.first_child().empty();
+  });
+}
+
+void BenchSDL(BenchContext &ctx) {
+  auto &data = ctx.Fixture("scheduler.sdl");
+
+  ctx.Run("SDL::Load", data.size(), [&] {
+    auto str = FixtureStream(data);
+    revil::SDL sdl;
+    sdl.Load(str);
+  });
+
+  ctx.Run("SDL::LoadView", data.size(), [&] {
+    revil::SDL sdl;
+    sdl.LoadView(data);
+  });
+}
+
+void BenchREMotionList(BenchContext &ctx) {
+  auto &data = ctx.Fixture("motion.motlist.99");
+
+  ctx.Run("REAsset::Load/motlist", data.size(), [&] {
+    auto str = FixtureStream(data);
+    revil::REAsset asset;
+    asset.Load(str);
+    ctx.sink += asset.As<uni::MotionsConst>()->Size();
+  });
+}
+
+void BenchHash(BenchContext &ctx) {
+  const auto paths = synth::MakePaths(0x10000);
+  const std::vector<std::string_view> views(paths.begin(), paths.end());
+  std::vector<uint32> hashes(views.size());
+  size_t totalSize = 0;
+
+  for (auto v : views) {
+    totalSize += v.size();
+  }
+
+  revil::MTHashV2(views, hashes);
+
+  ctx.Run("MTHashV1", totalSize, [&] {
+    revil::MTHashV1(views, hashes);
+    ctx.sink += hashes.back();
+  });
+
+  ctx.Run("MTHashV2", totalSize, [&] {
+    revil::MTHashV2(views, hashes);
+    ctx.sink += hashes.back();
+  });
+
+  const revil::TitleHandle title = revil::ResolveTitle("re5");
+  std::vector<uint32> known;
+
+  for (auto ext : {"tex", "mod", "lmt", "xfs", "sdl", "efl"}) {
+    if (auto found = revil::GetHash(ext, title); !found.empty()) {
+      known.emplace_back(found.front());
+    }
+  }
+
+  // Half of lookups hit registered classes, other half misses
+  std::vector<uint32> classes(hashes.size());
+
+  for (size_t i = 0; i < classes.size(); i++) {
+    classes[i] = i % 2 || known.empty() ? hashes[i] : known[i % known.size()];
+  }
+
+  ctx.Run("GetExtension", classes.size() * sizeof(uint32), [&] {
+    for (uint32 c : classes) {
+      ctx.sink += revil::GetExtension(c, title).size();
+    }
+  });
+}
+
+void WriteReport(BenchContext &ctx) {
+  std::string json = "{\n  \"rounds\": " + std::to_string(ctx.numRounds) +
+                     ",\n  \"results\": [";
+  char buffer[0x200];
+
+  for (size_t i = 0; auto &r : ctx.results) {
+    std::sort(r.samples.begin(), r.samples.end());
+    const uint64 median = r.samples[r.samples.size() / 2];
+    const uint64 minimum = r.samples.front();
+    const double mbps = median ? double(r.bytes) * 1000 / median : 0;
+
+    printf("%-32s median %12llu ns, min %12llu ns, %10.2f MB/s\n",
+           r.name.c_str(), (unsigned long long)median,
+           (unsigned long long)minimum, mbps);
+    snprintf(buffer, sizeof(buffer),
+             "%s\n    {\"name\": \"%s\", \"iterations\": %zu, \"bytes\": "
+             "%zu, \"median_ns\": %llu, \"min_ns\": %llu, \"mb_per_s\": %.3f}",
+             i++ ? "," : "", r.name.c_str(), r.samples.size(), r.bytes,
+             (unsigned long long)median, (unsigned long long)minimum, mbps);
+    json.append(buffer);
+  }
+
+  json.append("\n  ]\n}\n");
+  printf("Checksum: %llx\n", (unsigned long long)ctx.sink);
+
+  if (!ctx.output.empty()) {
+    std::ofstream str(ctx.output, std::ios::binary);
+
+    if (str.fail()) {
+      throw es::FileInvalidAccessError(ctx.output);
+    }
+
+    str << json;
+  }
+}
+
+int Generate(const std::string &dir) {
+  std::filesystem::create_directories(dir);
+
+  for (auto &f : FIXTURES) {
+    const std::string path = dir + "/" + std::string(f.fileName);
+    const std::string data = f.make();
+    std::ofstream str(path, std::ios::binary);
+
+    if (str.fail()) {
+      throw es::FileInvalidAccessError(path);
+    }
+
+    str.write(data.data(), data.size());
+    printf("%s: %zu bytes\n", path.c_str(), data.size());
+  }
+
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  BenchContext ctx;
+
+  try {
+    for (int a = 1; a < argc; a++) {
+      std::string_view arg(argv[a]);
+      auto Value = [&]() -> std::string {
+        if (++a >= argc) {
+          throw es::RuntimeError("Missing value for " + std::string(arg));
+        }
+
+        return argv[a];
+      };
+
+      if (arg == "--generate") {
+        return Generate(Value());
+      } else if (arg == "--fixtures") {
+        ctx.fixturesDir = Value();
+      } else if (arg == "--rounds") {
+        ctx.numRounds = std::max(1, std::stoi(Value()));
+      } else if (arg == "--filter") {
+        ctx.filter = Value();
+      } else if (arg == "--output") {
+        ctx.output = Value();
+      } else {
+        throw es::RuntimeError("Unknown argument: " + std::string(arg));
+      }
+    }
+
+    BenchARC(ctx);
+    BenchLMT(ctx, "motion.lmt", "");
+    BenchLMT(ctx, "motion_bilinear.lmt", "/bilinear_x86");
+    BenchMOD(ctx);
+    BenchTEX(ctx);
+    BenchXFS(ctx);
+    BenchSDL(ctx);
+    BenchREMotionList(ctx);
+    BenchHash(ctx);
+    WriteReport(ctx);
+  } catch (const std::exception &e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "revil/arc.hpp"
+#include "revil/container.hpp"
+#include "revil/hashreg.hpp"
+#include "spike/util/unit_testing.hpp"
+#include "synth.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+int test_container_extract() {
+  struct CollectContext : revil::ArcExtractContext {
+    std::map<std::string, std::string> files;
+    std::string *current = nullptr;
+
+    void NewFile(const std::string &path) override { current = &files[path]; }
+    void SendData(std::string_view data) override { current->append(data); }
+  };
+
+  auto Payload = [](size_t size, size_t seed) {
+    std::string payload;
+
+    for (size_t i = 0; i < size; i++) {
+      payload.push_back(char((i * seed) >> 2));
+    }
+
+    return payload;
+  };
+
+  const std::string stored = Payload(0x120, 7);
+  const std::string deflated = Payload(0x1800, 13);
+  const std::string lzx = Payload(0x400, 29);
+
+  std::string compressed(0x4000, 0);
+  compressed.resize(revil::CompressZlib(deflated, compressed, 15, 9));
+
+  std::string data;
+  std::vector<revil::ContainerEntry> entries;
+
+  auto Append = [&](std::string path, std::string_view raw,
+                    std::string_view uncompressed,
+                    revil::ContainerCodec codec) -> revil::ContainerEntry & {
+    auto &e = entries.emplace_back();
+    e.path = std::move(path);
+    e.offset = data.size();
+    e.size = raw.size();
+    e.uncompressedSize = uncompressed.size();
+    e.codec = codec;
+    data.append(raw);
+    return e;
+  };
+
+  entries.reserve(3);
+  Append("stored.bin", stored, stored, revil::ContainerCodec::Stored);
+  auto &zlibEntry = Append("zlib.bin", compressed, deflated,
+                           revil::ContainerCodec::Zlib);
+  auto &lzxEntry = Append("lzx.bin", synth::MakeStoredLZX(lzx), lzx,
+                          revil::ContainerCodec::LZX);
+
+  // One matching and one mismatching checksum
+  zlibEntry.verifyCrc = true;
+  zlibEntry.crc = revil::CRC32Update(0xFFFFFFFF, deflated);
+  lzxEntry.verifyCrc = true;
+  lzxEntry.crc = revil::CRC32Update(0xFFFFFFFF, lzx) ^ 1;
+
+  CollectContext ctx;
+  TEST_EQUAL(revil::ExtractContainer(data, entries, &ctx), 1);
+  TEST_EQUAL(ctx.files.size(), 3);
+  TEST_EQUAL(ctx.files.at("stored.bin") == stored, true);
+  TEST_EQUAL(ctx.files.at("zlib.bin") == deflated, true);
+  TEST_EQUAL(ctx.files.at("lzx.bin") == lzx, true);
+
+  auto Rejected = [&] {
+    try {
+      CollectContext badCtx;
+      revil::ExtractContainer(data, entries, &badCtx);
+    } catch (const std::exception &) {
+      return true;
+    }
+
+    return false;
+  };
+
+  // Stream inflates to less than declared size
+  entries[1].uncompressedSize = deflated.size() + 0x10;
+  TEST_EQUAL(Rejected(), true);
+
+  // Uncompressed size is capped by compression ratio before allocation
+  entries[1].uncompressedSize = entries[1].size * 0x1000;
+  TEST_EQUAL(Rejected(), true);
+
+  return 0;
+}
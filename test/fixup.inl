@@ -0,0 +1,130 @@
+#pragma once
+#include "fixup_tracker.hpp"
+#include "spike/util/unit_testing.hpp"
+#include <thread>
+
+struct TestPointer {
+  int64 value;
+
+  void Fixup(char *base, std::vector<void *> &) {
+    value += reinterpret_cast<intptr_t>(base);
+  }
+};
+
+int test_fixup_tracker() {
+  revil::FixupTracker tracker;
+  std::vector<TestPointer> pointers(1000, TestPointer{1});
+  char *base = reinterpret_cast<char *>(0x100);
+
+  for (auto &p : pointers) {
+    TEST_EQUAL(tracker.Fixup(p, base), true);
+  }
+
+  for (auto &p : pointers) {
+    TEST_EQUAL(tracker.Fixup(p, base), false);
+    TEST_EQUAL(tracker.Check(p), true);
+    TEST_EQUAL(p.value, 0x101);
+  }
+
+  TEST_EQUAL(tracker.Size(), pointers.size());
+
+  TestPointer a{0}, b{0};
+  TEST_EQUAL(tracker.FixupPointers(base, a, b), true);
+  TEST_EQUAL(tracker.FixupPointers(base, a, b), false);
+  TEST_EQUAL(a.value, 0x100);
+
+  revil::FixupTracker other;
+  TestPointer c{0};
+  other.Fixup(c, base);
+  tracker.Merge(other);
+  TEST_EQUAL(tracker.Check(c), true);
+  TEST_EQUAL(tracker.Size(), pointers.size() + 3);
+
+  return 0;
+}
+
+int test_fixup_tracker_extent() {
+  std::vector<TestPointer> pointers(8, TestPointer{0});
+  char *base = reinterpret_cast<char *>(pointers.data());
+  revil::FixupTracker tracker(
+      {base, pointers.size() * sizeof(TestPointer)});
+
+  auto Throws = [](auto &&fn) {
+    try {
+      fn();
+    } catch (const std::exception &) {
+      return true;
+    }
+
+    return false;
+  };
+
+  pointers[0].value = 16;
+  TEST_EQUAL(tracker.Fixup(pointers[0], base), true);
+  TEST_EQUAL(pointers[0].value, reinterpret_cast<intptr_t>(base + 16));
+
+  // Target past end of extent
+  pointers[1].value = 64;
+  TEST_EQUAL(Throws([&] { tracker.Fixup(pointers[1], base); }), true);
+
+  // Null pointers are not checked
+  TEST_EQUAL(tracker.Fixup(pointers[2], base), true);
+
+  // Pointer field outside of extent
+  TestPointer outside{8};
+  TEST_EQUAL(Throws([&] { tracker.Fixup(outside, base); }), true);
+
+  TEST_EQUAL(Throws([&] { tracker.CheckArray(pointers.data(), 8); }), false);
+  TEST_EQUAL(Throws([&] { tracker.CheckArray(pointers.data() + 1, 8); }),
+             true);
+  TEST_EQUAL(Throws([&] { tracker.CheckArray(pointers.data(), size_t(-1)); }),
+             true);
+
+  // Offset table is expected to be inside of extent
+  uint32 *offsets = reinterpret_cast<uint32 *>(pointers.data() + 4);
+  offsets[0] = 0;
+  offsets[1] = 8;
+  offsets[2] = 64;
+  TEST_EQUAL(Throws([&] { tracker.CheckOffsets(offsets, 3); }), true);
+  TEST_EQUAL(Throws([&] { tracker.CheckOffsets(offsets, 2); }), false);
+
+  return 0;
+}
+
+int test_fixup_tracker_shared() {
+  std::vector<TestPointer> pointers(4096, TestPointer{1});
+  char *base = reinterpret_cast<char *>(0x100);
+  revil::FixupTracker tracker;
+  tracker.Fixup(pointers[0], base);
+
+  // Workers walk overlapping halves, each field must be fixed once
+  revil::SharedFixupTracker shared(tracker);
+  std::vector<std::thread> workers;
+
+  for (size_t t = 0; t < 4; t++) {
+    workers.emplace_back([&, t] {
+      revil::FixupTracker worker = shared.Worker();
+      const size_t begin = (t % 2) * pointers.size() / 4;
+
+      for (size_t p = begin; p < begin + pointers.size() / 2; p++) {
+        worker.Fixup(pointers[p], base);
+      }
+    });
+  }
+
+  for (auto &w : workers) {
+    w.join();
+  }
+
+  shared.Merge();
+
+  for (size_t p = 0; p < pointers.size(); p++) {
+    const bool walked = p < pointers.size() * 3 / 4;
+    TEST_EQUAL(pointers[p].value, walked ? 0x101 : 1);
+    TEST_EQUAL(tracker.Check(pointers[p]), walked);
+  }
+
+  TEST_EQUAL(tracker.Size(), pointers.size() * 3 / 4);
+
+  return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <exception>
+#include <span>
+#include <spanstream>
+#include <string_view>
+
+// Malformed input must be rejected by exception, crashes and sanitizer
+// reports are findings
+template <class Fn> int FuzzInput(const uint8_t *data, size_t size, Fn &&fn) {
+  std::string_view input(reinterpret_cast<const char *>(data), size);
+  std::ispanstream str(std::span<const char>(input.data(), input.size()));
+
+  try {
+    fn(str, input);
+  } catch (const std::exception &) {
+  }
+
+  return 0;
+}
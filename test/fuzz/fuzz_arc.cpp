@@ -0,0 +1,16 @@
+#include "fuzz.hpp"
+#include "revil/arc.hpp"
+
+struct NullContext : revil::ArcExtractContext {
+  void NewFile(const std::string &) override {}
+  void SendData(std::string_view) override {}
+};
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  return FuzzInput(data, size, [](auto &str, std::string_view) {
+    NullContext ctx;
+    // ddon enables encrypted archives
+    revil::EnumerateArchive(
+        str, revil::Platform::Auto, "ddon", [&] { return &ctx; }, {});
+  });
+}
@@ -0,0 +1,20 @@
+#include "fuzz.hpp"
+#include "revil/lmt.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  return FuzzInput(data, size, [](auto &str, std::string_view) {
+    revil::LMT lmt;
+    lmt.Load(str);
+    uni::MotionsConst motions = lmt;
+
+    for (auto m : *motions) {
+      m->FrameRate(60);
+
+      for (auto t : *m) {
+        Vector4A16 value;
+        t->GetValue(value, 0);
+        t->GetValue(value, m->Duration());
+      }
+    }
+  });
+}
@@ -0,0 +1,9 @@
+#include "fuzz.hpp"
+#include "revil/mod.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  return FuzzInput(data, size, [](auto &str, std::string_view) {
+    revil::MOD mod;
+    mod.Load(str);
+  });
+}
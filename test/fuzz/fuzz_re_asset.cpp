@@ -0,0 +1,9 @@
+#include "fuzz.hpp"
+#include "revil/re_asset.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  return FuzzInput(data, size, [](auto &str, std::string_view) {
+    revil::REAsset asset;
+    asset.Load(str);
+  });
+}
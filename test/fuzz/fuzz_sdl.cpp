@@ -0,0 +1,19 @@
+#include "fuzz.hpp"
+#include "pugixml.hpp"
+#include "revil/sdl.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  FuzzInput(data, size, [](auto &, std::string_view input) {
+    revil::SDL view;
+    view.LoadView(input);
+    pugi::xml_document doc;
+    view.ToXML(doc);
+  });
+
+  return FuzzInput(data, size, [](auto &str, std::string_view) {
+    revil::SDL sdl;
+    sdl.Load(str);
+    pugi::xml_document doc;
+    sdl.ToXML(doc);
+  });
+}
@@ -0,0 +1,12 @@
+#include "fuzz.hpp"
+#include "pugixml.hpp"
+#include "revil/xfs.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  return FuzzInput(data, size, [](auto &str, std::string_view) {
+    revil::XFS xfs;
+    xfs.Load(str, true);
+    pugi::xml_document doc;
+    xfs.ToXML(doc);
+  });
+}
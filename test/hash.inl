@@ -0,0 +1,66 @@
+#pragma once
+#include "revil/hashreg.hpp"
+#include "spike/util/unit_testing.hpp"
+#include <string>
+#include <vector>
+
+int test_hash_v1() {
+  TEST_EQUAL(revil::MTHashV1("rTexture"), 0x3CAD8076U);
+  TEST_EQUAL(revil::MTHashV1(""), 0U);
+
+  return 0;
+}
+
+int test_hash_v2() {
+  TEST_EQUAL(revil::MTHashV2("rTexture"), 0x241F5DEBU);
+  TEST_EQUAL(revil::MTHashV2("rModel"), 0x58A15856U);
+  TEST_EQUAL(revil::MTHashV2(""), 0x7FFFFFFFU);
+
+  // Long enough for folded path
+  std::string longText;
+
+  for (size_t i = 0; i < 300; i++) {
+    longText.push_back(char('a' + i % 26));
+  }
+
+  uint32 tableHash = 0xFFFFFFFF;
+
+  for (char c : longText) {
+    tableHash ^= uint8(c);
+
+    for (size_t b = 0; b < 8; b++) {
+      tableHash = (tableHash >> 1) ^ (0xEDB88320 * (tableHash & 1));
+    }
+  }
+
+  TEST_EQUAL(revil::MTHashV2(longText), tableHash & 0x7FFFFFFF);
+  TEST_EQUAL(revil::CRC32Update(0xFFFFFFFF, longText), tableHash);
+  TEST_EQUAL(revil::CRC32Update(0xFFFFFFFF, "123456789"), ~0xCBF43926U);
+
+  return 0;
+}
+
+int test_hash_batch() {
+  std::vector<std::string> texts;
+
+  for (size_t i = 0; i < 37; i++) {
+    texts.emplace_back(i * 7, char('0' + i % 64));
+  }
+
+  std::vector<std::string_view> views(texts.begin(), texts.end());
+  std::vector<uint32> hashes(views.size());
+
+  revil::MTHashV1(views, hashes);
+
+  for (size_t i = 0; i < views.size(); i++) {
+    TEST_EQUAL(hashes[i], revil::MTHashV1(views[i]));
+  }
+
+  revil::MTHashV2(views, hashes);
+
+  for (size_t i = 0; i < views.size(); i++) {
+    TEST_EQUAL(hashes[i], revil::MTHashV2(views[i]));
+  }
+
+  return 0;
+}
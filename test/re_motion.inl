@@ -0,0 +1,267 @@
+#pragma once
+#include "reng/motion_43.hpp"
+#include "reng/motion_list_85.hpp"
+#include "revil/lmt.hpp"
+#include "revil/re_asset.hpp"
+#include "spike/util/unit_testing.hpp"
+#include "synth.hpp"
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+bool NearlyEqual(float a, float b, float tolerance) {
+  if (std::isnan(a) || std::isnan(b)) {
+    return std::isnan(a) && std::isnan(b);
+  }
+
+  return std::abs(a - b) <= tolerance * std::max(1.f, std::abs(a));
+}
+
+int test_re_codec_decode() {
+  // Odd count covers both SIMD and scalar tail of bit unpacking
+  const uint32 numFrames = 37;
+  const REMimMaxBounds bounds{{0.3f, 0.25f, 0.2f, 0.1f},
+                              {-0.1f, -0.15f, 0.05f, 0.1f}};
+  std::vector<uint8> frames(numFrames);
+  std::vector<float> controlPoints(numFrames * 4);
+  uint32 seed = 0x1234567;
+
+  for (uint32 f = 0; f < numFrames; f++) {
+    frames[f] = f * 2;
+  }
+
+  for (float &c : controlPoints) {
+    seed = seed * 1664525 + 1013904223;
+    c = (static_cast<float>(seed >> 8) / float(1 << 24) - 0.5f) * 0.6f;
+  }
+
+  for (uint32 curveVersion : {43, 65, 78}) {
+    for (uint32 type : RETrackCurveTypes(curveVersion)) {
+      RETrackCurveData curve{
+          .flags = type | (2 << 20),
+          .numFrames = numFrames,
+          .frames = frames.data(),
+          .controlPoints = reinterpret_cast<char *>(controlPoints.data()),
+          .minMaxBounds = &bounds,
+      };
+      auto controller = CreateRETrackController(curveVersion, curve);
+      TEST_EQUAL(controller != nullptr, true);
+
+      std::vector<float> decoded(numFrames * 4);
+      controller->Decode(decoded.data());
+
+      for (uint32 f = 0; f < numFrames; f++) {
+        Vector4A16 value{};
+        controller->Evaluate(f, value);
+
+        for (uint32 c = 0; c < 4; c++) {
+          TEST_EQUAL(
+              NearlyEqual(decoded[c * numFrames + f], value[c], 0.00001f),
+              true);
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+int test_re_motion_roundtrip() {
+  const revil::REMotionExportSettings settings;
+  std::stringstream lmtStr(synth::MakeLMT(
+      {.codecs = synth::LMTCodecs::Mixed, .numAnimations = 3, .numBones = 4}));
+  revil::LMT lmt;
+  lmt.Load(lmtStr);
+  uni::MotionsConst motions = lmt;
+  std::vector<std::decay_t<decltype(*motions->begin())>> holders;
+  std::vector<const uni::Motion *> items;
+
+  for (auto m : *motions) {
+    items.emplace_back(m.get());
+    holders.emplace_back(std::move(m));
+  }
+
+  // Rates that don't divide, or exceed RE frame rate
+  for (uint32 frameRate : {30U, 24U, 25U, 120U}) {
+    for (auto &m : holders) {
+      m->FrameRate(frameRate);
+    }
+
+    std::stringstream str;
+    revil::SaveREMotionList(str, items, "synth", settings);
+    revil::REAsset asset;
+    asset.Load(str);
+    auto reMotions = asset.As<uni::MotionsConst>();
+    TEST_EQUAL(reMotions->Size(), items.size());
+
+    size_t m = 0;
+
+    for (auto reMotion : *reMotions) {
+      const uni::Motion &source = *items[m++];
+      std::vector<std::decay_t<decltype(*source.begin())>> trackHolders;
+      std::map<std::pair<size_t, uint32>, const uni::MotionTrack *>
+          sourceTracks;
+
+      for (auto t : source) {
+        sourceTracks.emplace(
+            std::make_pair(t->BoneIndex(), uint32(t->TrackType())), t.get());
+        trackHolders.emplace_back(std::move(t));
+      }
+
+      // Keys are resampled onto 60 Hz frames, other times are interpolated
+      const float duration = source.Duration();
+      std::vector<float> times;
+
+      for (size_t k = 0; k <= size_t(duration * 60 + 0.001f); k++) {
+        times.emplace_back(std::min(duration, float(k) / 60));
+      }
+
+      size_t numTracks = 0;
+
+      for (auto t : *reMotion) {
+        auto worker = dynamic_cast<const REMotionTrackWorker *>(t.get());
+        TEST_EQUAL(worker != nullptr, true);
+        const uni::MotionTrack *sourceTrack =
+            sourceTracks.at({t->BoneIndex(), uint32(t->TrackType())});
+        const bool isQuat = t->TrackType() == uni::MotionTrack::Rotation;
+        const float tolerance =
+            0.00001f + (isQuat ? settings.rotationTolerance
+                       : t->TrackType() == uni::MotionTrack::Position
+                           ? settings.positionTolerance
+                           : settings.scaleTolerance);
+        std::vector<Vector4A16> values(times.size());
+        worker->GetValues(times, values);
+        numTracks++;
+
+        for (size_t k = 0; k < times.size(); k++) {
+          Vector4A16 expected;
+          sourceTrack->GetValue(expected, times[k]);
+          Vector4A16 value;
+          t->GetValue(value, times[k]);
+
+          // Writer keeps W positive
+          if (isQuat && expected.Dot(value) < 0.f) {
+            expected *= -1.f;
+          }
+
+          // Only rotation carries W
+          for (uint32 c = 0; c < (isQuat ? 4 : 3); c++) {
+            TEST_EQUAL(std::abs(value[c] - expected[c]) <= tolerance, true);
+          }
+
+          for (uint32 c = 0; c < 4; c++) {
+            TEST_EQUAL(values[k][c], value[c]);
+          }
+        }
+      }
+
+      TEST_EQUAL(numTracks, sourceTracks.size());
+    }
+  }
+
+  // Frame rate is clamped, loaded duration must stay finite
+  struct ZeroRateMotion : uni::Motion {
+    const uni::Motion *source;
+
+    explicit ZeroRateMotion(const uni::Motion *source_) : source(source_) {}
+    std::string Name() const override { return source->Name(); }
+    void FrameRate(uint32) const override {}
+    uint32 FrameRate() const override { return 0; }
+    float Duration() const override { return source->Duration(); }
+    uni::MotionTracksConst Tracks() const override { return source->Tracks(); }
+    MotionType_e MotionType() const override { return source->MotionType(); }
+  };
+
+  const ZeroRateMotion zeroRate(items.front());
+  const uni::Motion *zeroRateItems[]{&zeroRate};
+  std::stringstream zeroRateStr;
+  revil::SaveREMotionList(zeroRateStr, zeroRateItems, "synth", settings);
+  revil::REAsset zeroRateAsset;
+  zeroRateAsset.Load(zeroRateStr);
+  auto zeroRateMotions = zeroRateAsset.As<uni::MotionsConst>();
+  auto zeroRateMotion = *zeroRateMotions->begin();
+  TEST_EQUAL(zeroRateMotion->FrameRate(), 1U);
+  TEST_EQUAL(std::isfinite(zeroRateMotion->Duration()), true);
+
+  return 0;
+}
+
+// Two motions of motlist point to same bone header, header and bones it
+// points to must be fixed by one worker only
+int test_re_motlist_overlap() {
+  static_assert(sizeof(REMotlist85) <= 0x40);
+  static_assert(sizeof(REMotion65) <= 0x80);
+  // Field offsets of REMotlist85 and REMotion65
+  const size_t listMotions = 0x10;
+  const size_t listNumMotions = 0x30;
+  const size_t motionBones = 0x10;
+  const size_t motionNumBones = 0x68;
+  static_assert(sizeof(REArray<REMotionBone>) == 0x10);
+  static_assert(sizeof(REMotionBone) == 0x50);
+
+  const size_t motionOffsets[]{0x80, 0x100};
+  const size_t headerOffset = 0x180;
+  // Relative to motion that wins bone header
+  const int64 bonesOffset = 0x200;
+  const int64 boneNameOffset = 0x300;
+
+  auto Write = [](std::string &file, size_t offset, auto value) {
+    memcpy(file.data() + offset, &value, sizeof(value));
+  };
+
+  auto Read = [](const std::string &file, size_t offset) {
+    int64 value;
+    memcpy(&value, file.data() + offset, sizeof(value));
+    return value;
+  };
+
+  for (size_t iteration = 0; iteration < 16; iteration++) {
+    std::string file(0x480, 0);
+    Write(file, 0, uint32(REMotlist85Asset::VERSION));
+    Write(file, 4, uint32(REMotlist85Asset::ID));
+    Write(file, listMotions, int64(0x40));
+    Write(file, listNumMotions, uint32(2));
+
+    for (size_t m = 0; m < 2; m++) {
+      const size_t motion = motionOffsets[m];
+      Write(file, 0x40 + m * 8, int64(motion));
+      Write(file, motion, uint32(REMotion65Asset::VERSION));
+      Write(file, motion + 4, uint32(REMotion65Asset::ID));
+      Write(file, motion + motionBones, int64(headerOffset - motion));
+      Write(file, motion + motionNumBones, uint16(1));
+      Write(file, motion + bonesOffset, boneNameOffset);
+    }
+
+    Write(file, headerOffset, bonesOffset);
+    Write(file, headerOffset + 8, int32(1));
+
+    REMotlist85Asset asset;
+    revil::REAssetImpl &impl = asset;
+    impl.buffer = file.data();
+    revil::FixupTracker tracker(file);
+    impl.Fixup(tracker);
+
+    const intptr_t begin = reinterpret_cast<intptr_t>(file.data());
+    const int64 bones = Read(file, headerOffset);
+    size_t numFixedBones = 0;
+
+    for (size_t m = 0; m < 2; m++) {
+      const size_t motion = motionOffsets[m];
+      TEST_EQUAL(Read(file, motion + motionBones), int64(begin + headerOffset));
+
+      const int64 boneName = Read(file, motion + bonesOffset);
+
+      if (bones == int64(begin + motion + bonesOffset)) {
+        numFixedBones++;
+        TEST_EQUAL(boneName, int64(begin + motion + boneNameOffset));
+      } else {
+        TEST_EQUAL(boneName, boneNameOffset);
+      }
+    }
+
+    TEST_EQUAL(numFixedBones, 1);
+  }
+
+  return 0;
+}
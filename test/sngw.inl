@@ -0,0 +1,54 @@
+#pragma once
+#include "revil/sngw.hpp"
+#include "spike/util/unit_testing.hpp"
+#include <sstream>
+#include <string>
+
+int test_sngw() {
+  std::string plain;
+
+  for (size_t i = 0; i < 1000; i++) {
+    plain.push_back(char(i * 37 + (i >> 3)));
+  }
+
+  // Per byte reference of original 16 byte implementation
+  auto Reference = [&](size_t i) {
+    const uint8 key = 0x64958637 >> ((i % 4) * 8);
+    const uint8 value = plain[i];
+    return char(((value << 4) | (value >> 4)) ^ key);
+  };
+
+  // Unaligned offsets and sizes go through every SIMD path and tail
+  for (size_t offset : {0, 1, 3, 17, 64, 131}) {
+    const size_t size = plain.size() - offset;
+    std::string decrypted(size, 0);
+    revil::DecryptSNGW({plain.data() + offset, size}, decrypted.data(),
+                       offset);
+
+    for (size_t i = 0; i < size; i++) {
+      TEST_EQUAL(decrypted[i], Reference(offset + i));
+    }
+
+    revil::EncryptSNGW(decrypted, decrypted.data(), offset);
+    TEST_EQUAL(decrypted, plain.substr(offset));
+  }
+
+  std::string file = "OggS" + plain;
+  revil::EncryptSNGWFile(file);
+  TEST_EQUAL(revil::DecryptSNGWFile(file), true);
+  TEST_EQUAL(file, "OggS" + plain);
+  TEST_EQUAL(revil::DecryptSNGWFile(file), false);
+
+  // Streamed helpers must match in place ones
+  TEST_EQUAL(revil::IsSNGWFile(file, false), true);
+  std::stringstream encrypted;
+  revil::EncryptSNGWFile(file, encrypted);
+  revil::EncryptSNGWFile(file);
+  TEST_EQUAL(encrypted.str(), file);
+  TEST_EQUAL(revil::IsSNGWFile(file, true), true);
+  std::stringstream decrypted;
+  revil::DecryptSNGWFile(file, decrypted);
+  TEST_EQUAL(decrypted.str(), "OggS" + plain);
+
+  return 0;
+}
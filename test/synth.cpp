@@ -0,0 +1,745 @@
+#include "synth.hpp"
+#include "arc.hpp"
+#include "mtf_lmt/codecs.hpp"
+#include "mtf_mod/traits.hpp"
+#include "pugixml.hpp"
+#include "revil/arc.hpp"
+#include "revil/hashreg.hpp"
+#include "revil/lmt.hpp"
+#include "revil/re_asset.hpp"
+#include "revil/sdl.hpp"
+#include "revil/tex.hpp"
+#include "spike/crypto/blowfish.h"
+#include "spike/except.hpp"
+#include "spike/io/binreader_stream.hpp"
+#include "spike/io/binwritter_stream.hpp"
+#include "spike/util/endian.hpp"
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+void SaveMODX99(const MODInner<MODTraitsX99LE> &main, BinWritterRef wr);
+void SaveMODXC5(const MODInner<MODTraitsXC5> &main, BinWritterRef wr);
+
+namespace synth {
+std::string MakePayload(Random &rng, size_t size) {
+  std::string retVal;
+  retVal.reserve(size);
+
+  while (retVal.size() < size) {
+    const uint32 token = rng.Next();
+    const size_t runSize =
+        std::min<size_t>(4 + (token & 0x3f), size - retVal.size());
+
+    if (token & 0x8000 && retVal.size() > 0x100) {
+      const size_t from = retVal.size() - 1 - ((token >> 16) & 0xff);
+      for (size_t i = 0; i < runSize; i++) {
+        retVal.push_back(retVal[from + i]);
+      }
+    } else {
+      for (size_t i = 0; i < runSize; i++) {
+        retVal.push_back(char('a' + (rng.Next() % 26)));
+      }
+    }
+  }
+
+  return retVal;
+}
+
+std::vector<std::string> MakePaths(size_t numPaths) {
+  std::vector<std::string> retVal;
+  retVal.reserve(numPaths);
+
+  for (size_t i = 0; i < numPaths; i++) {
+    char buffer[0x40];
+    snprintf(buffer, sizeof(buffer), "synth\\folder%02zu\\item_%05zu", i % 37,
+             i);
+    retVal.emplace_back(buffer);
+  }
+
+  return retVal;
+}
+
+std::string MakeStoredLZX(std::string_view data) {
+  std::string stream;
+  auto Write16 = [&](uint16 value) {
+    stream.push_back(char(value));
+    stream.push_back(char(value >> 8));
+  };
+
+  // block type 3 (uncompressed), 24 bit block size, aligned to 16 bits
+  const uint32 blockHeader = (3 << 28) | (uint32(data.size()) << 4);
+  Write16(blockHeader >> 16);
+  Write16(blockHeader);
+
+  // R0, R1, R2
+  for (size_t r = 0; r < 3; r++) {
+    stream.push_back(1);
+    stream.append(3, 0);
+  }
+
+  stream.append(data);
+
+  if (data.size() & 1) {
+    stream.push_back(0);
+  }
+
+  std::string retVal;
+
+  for (size_t c = 0; c < stream.size(); c += 0x8000) {
+    const size_t chunkSize = std::min<size_t>(0x8000, stream.size() - c);
+    retVal.push_back(char(chunkSize >> 8));
+    retVal.push_back(char(chunkSize));
+    retVal.append(stream, c, chunkSize);
+  }
+
+  return retVal;
+}
+
+std::string MakeARC(const ARCSettings &settings) {
+  const revil::TitleHandle handle =
+      revil::ResolveTitle(settings.title, settings.platform);
+  const revil::TitleSupport *ts =
+      revil::GetTitleSupport(settings.title, settings.platform);
+  const ARCCompression type = settings.compression;
+  const bool bigEndian = revil::IsPlatformBigEndian(settings.platform);
+  std::vector<uint32> classes;
+
+  for (auto ext : {"tex", "mod", "lmt", "xfs", "efl", "sdl"}) {
+    if (auto hashes = revil::GetHash(ext, handle); !hashes.empty()) {
+      classes.emplace_back(hashes.front());
+    }
+  }
+
+  if (classes.empty()) {
+    throw es::RuntimeError("No known classes for title: " +
+                           std::string(settings.title));
+  }
+
+  if (settings.numFiles > 0xffff) {
+    throw es::RuntimeError("Too many files for ARC: " +
+                           std::to_string(settings.numFiles));
+  }
+
+  BlowfishEncoder enc;
+
+  if (type == ARCCompression::ARCC) {
+    enc.SetKey(ts->arc.key);
+  }
+
+  const uint16 version = type == ARCCompression::LZX ? 0x11 : ts->arc.version;
+  // LZXTag overlaps first file name for LZX archives
+  const bool extendedHeader = version >= 0x10 && type == ARCCompression::Zlib;
+  const size_t headerSize = extendedHeader ? 12 : 8;
+  const size_t fileSizeRange =
+      std::max(settings.maxFileSize, settings.minFileSize + 1) -
+      settings.minFileSize;
+
+  Random rng{0x4152430000000000 ^ settings.seed ^ settings.numFiles};
+  auto paths = MakePaths(settings.numFiles);
+  std::vector<ARCFile> entries(settings.numFiles);
+  std::string data;
+  std::string compressed;
+  const size_t dataBegin = headerSize + entries.size() * sizeof(ARCFile);
+
+  for (size_t f = 0; f < entries.size(); f++) {
+    ARCFile &entry = entries[f];
+    std::string payload = MakePayload(
+        rng, settings.minFileSize + (rng.Next() % fileSizeRange));
+    memcpy(entry.fileName, paths[f].data(), paths[f].size());
+    entry.typeHash = classes[f % classes.size()];
+    entry.uncompressedSize = payload.size();
+    entry.offset = dataBegin + data.size();
+
+    if (type == ARCCompression::LZX) {
+      compressed = MakeStoredLZX(payload);
+    } else {
+      compressed.resize(payload.size() + payload.size() / 100 + 0x40);
+      compressed.resize(
+          revil::CompressZlib(payload, compressed, ts->arc.windowSize, 6));
+    }
+
+    if (type == ARCCompression::ARCC) {
+      // Trailing bytes are ignored by inflate
+      compressed.resize((compressed.size() + 7) & ~7);
+      enc.Encode(compressed.data(), compressed.size());
+    }
+
+    entry.compressedSize = compressed.size();
+    data.append(compressed);
+
+    if (bigEndian) {
+      entry.SwapEndian();
+    }
+  }
+
+  std::stringstream str;
+  BinWritterRef_e wr(str);
+  wr.SwapEndian(bigEndian);
+  wr.Write(type == ARCCompression::ARCC ? CompileFourCC("ARCC")
+                                        : CompileFourCC("ARC"));
+  wr.Write(version);
+  wr.Write<uint16>(entries.size());
+
+  if (extendedHeader) {
+    wr.Write<uint32>(0);
+  }
+
+  if (type == ARCCompression::ARCC) {
+    enc.Encode(reinterpret_cast<char *>(entries.data()),
+               entries.size() * sizeof(ARCFile));
+  }
+
+  wr.WriteBuffer(reinterpret_cast<const char *>(entries.data()),
+                 entries.size() * sizeof(ARCFile));
+  wr.WriteContainer(data);
+
+  return std::move(str).str();
+}
+
+std::string MakeTEX(const TEXSettings &settings) {
+  revil::TEX tex{};
+  tex.ctx.width = settings.size;
+  tex.ctx.height = settings.size;
+  tex.ctx.depth = 1;
+  tex.ctx.numFaces = 1;
+  tex.ctx.baseFormat.type = TexelInputFormatType::BC1;
+  tex.ctx.numMipmaps = 0;
+
+  size_t bufferSize = 0;
+
+  for (uint32 mipSize = settings.size; mipSize; mipSize >>= 1) {
+    const size_t numBlocks = std::max<uint32>(1, mipSize / 4);
+    bufferSize += numBlocks * numBlocks * 8;
+    tex.ctx.numMipmaps++;
+  }
+
+  Random rng{0x5445580000000000 ^ settings.seed ^ settings.size};
+  tex.buffer.resize(bufferSize);
+
+  for (auto &c : tex.buffer) {
+    c = char(rng.Next());
+  }
+
+  std::stringstream str;
+  tex.Save(str, settings.version, settings.platform);
+
+  return std::move(str).str();
+}
+
+// Field offsets of Animation and BoneTrack, see animation.inl and
+// bone_track.inl
+struct LMTLayout {
+  size_t animationSize;
+  size_t numTracks;
+  size_t numFrames;
+  size_t loopFrame;
+  size_t trackSize;
+  size_t boneID2;
+  size_t weight;
+  size_t bufferSize;
+  size_t buffer;
+  size_t referenceData;
+  size_t extremes;
+};
+
+static const LMTLayout LMT_LAYOUTS[][2]{
+    // LMT66, LMT67: x86, x64
+    {
+        {64, 4, 8, 12, 36, 0, 4, 8, 12, 16, 32},
+        {96, 8, 12, 16, 48, 0, 4, 8, 16, 24, 40},
+    },
+    // LMT68
+    {
+        {64, 4, 8, 12, 40, 4, 8, 12, 16, 20, 36},
+        {96, 8, 12, 16, 48, 4, 8, 12, 16, 24, 40},
+    },
+};
+
+std::string MakeLMT(const LMTSettings &settings) {
+  if (settings.version < 66 || settings.version > 68) {
+    throw es::InvalidVersionError(settings.version);
+  }
+
+  static constexpr uint32 FRAME_STEP = 2;
+  const bool x64 = revil::IsPlatformX64(settings.platform);
+  const bool bigEndian = revil::IsPlatformBigEndian(settings.platform);
+  const LMTLayout &layout = LMT_LAYOUTS[settings.version == 68][x64];
+  const size_t ptrSize = x64 ? 8 : 4;
+  const size_t numKeys = std::max<size_t>(settings.numKeys, 2);
+  const size_t numTracks = settings.numBones * 3;
+  std::string retVal;
+
+  auto Align = [&] { retVal.resize((retVal.size() + 15) & ~size_t(15)); };
+  auto Put = [&](size_t offset, auto value) {
+    if (bigEndian) {
+      FByteswapper(value);
+    }
+
+    memcpy(retVal.data() + offset, &value, sizeof(value));
+  };
+  auto PutPtr = [&](size_t offset, size_t value) {
+    if (x64) {
+      Put(offset, uint64(value));
+    } else {
+      Put(offset, uint32(value));
+    }
+  };
+  auto AppendKey = [&](std::string &keys, auto key) {
+    if (bigEndian) {
+      key.SwapEndian();
+    }
+
+    keys.append(reinterpret_cast<const char *>(&key), sizeof(key));
+  };
+
+  retVal.resize(8 + settings.numAnimations * ptrSize);
+  Put(0, CompileFourCC("LMT\0"));
+  Put(4, settings.version);
+  Put(6, uint16(settings.numAnimations));
+  Align();
+
+  Random rng{0x4C4D540000000000 ^ settings.seed ^ settings.numAnimations};
+  auto RandomQuat = [&] {
+    float q[4]{rng.NextFloat() - 0.5f, rng.NextFloat() - 0.5f,
+               rng.NextFloat() - 0.5f, rng.NextFloat() + 0.5f};
+    const float length =
+        std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    return Vector4A16(q[0], q[1], q[2], q[3]) * (1.f / length);
+  };
+  auto RandomVector = [&] {
+    return Vector4A16(rng.NextFloat(), rng.NextFloat(), rng.NextFloat(), 1.f);
+  };
+
+  for (size_t a = 0; a < settings.numAnimations; a++) {
+    const size_t animation = retVal.size();
+    PutPtr(8 + a * ptrSize, animation);
+    retVal.resize(animation + layout.animationSize);
+    const size_t tracks = retVal.size();
+    retVal.resize(tracks + numTracks * layout.trackSize);
+    Align();
+
+    PutPtr(animation, tracks);
+    Put(animation + layout.numTracks, uint32(numTracks));
+    Put(animation + layout.numFrames, uint32((numKeys - 1) * FRAME_STEP + 1));
+    Put(animation + layout.loopFrame, int32(0));
+
+    for (size_t t = 0; t < numTracks; t++) {
+      const size_t track = tracks + t * layout.trackSize;
+      const uint8 trackType = t % 3;
+      const uint8 boneID = t / 3;
+      const bool biLinear =
+          settings.codecs == LMTCodecs::BiLinear ||
+          (settings.codecs == LMTCodecs::Mixed && (boneID & 1));
+      const size_t buffer = retVal.size();
+      uint8 compression = 0;
+      std::string keys;
+
+      // Compression values are TrackV2BufferTypes
+      // Bilinear values are normalized into extremes
+      for (size_t k = 0; k < numKeys; k++) {
+        const uint64 frame = k + 1 < numKeys ? FRAME_STEP : 0;
+
+        if (trackType == 0 && biLinear) {
+          compression = 7;
+          Buf_BiLinearRotationQuat4_7bit key{};
+          key.Devaluate(RandomQuat() * 0.5f + Vector4A16(0.5f));
+          key.SetFrame(frame);
+          AppendKey(keys, key);
+        } else if (trackType == 0) {
+          compression = 6;
+          Buf_LinearRotationQuat4_14bit key{};
+          key.Devaluate(RandomQuat());
+          key.SetFrame(frame);
+          AppendKey(keys, key);
+        } else if (trackType == 1 && biLinear) {
+          compression = 4;
+          Buf_BiLinearVector3_16bit key{};
+          key.Devaluate(RandomVector());
+          key.SetFrame(frame);
+          AppendKey(keys, key);
+        } else if (trackType == 1) {
+          compression = 3;
+          Buf_LinearVector3 key{};
+          key.Devaluate(RandomVector());
+          key.SetFrame(frame);
+          AppendKey(keys, key);
+        } else if (biLinear) {
+          compression = 5;
+          Buf_BiLinearVector3_8bit key{};
+          key.Devaluate(RandomVector());
+          key.SetFrame(frame);
+          AppendKey(keys, key);
+        } else {
+          compression = 1;
+          Buf_SingleVector3 key{};
+          key.Devaluate(Vector4A16(1.f, 1.f, 1.f, 1.f));
+          AppendKey(keys, key);
+          break;
+        }
+      }
+
+      // First 4 bytes are swapped as single uint32 on big endian
+      const uint8 header[]{compression, trackType, 0, boneID};
+
+      for (size_t b = 0; b < 4; b++) {
+        retVal[track + (bigEndian ? 3 - b : b)] = char(header[b]);
+      }
+
+      if (layout.boneID2) {
+        Put(track + layout.boneID2, int32(boneID));
+      }
+
+      Put(track + layout.weight, 1.f);
+      Put(track + layout.bufferSize, uint32(keys.size()));
+      PutPtr(track + layout.buffer, buffer);
+      Put(track + layout.referenceData, Vector4A16(0.f, 0.f, 0.f, 1.f));
+      retVal.append(keys);
+      Align();
+
+      if (biLinear) {
+        // Evaluated as max + min * value
+        TrackMinMax extremes{Vector4A16(2.f, 2.f, 2.f, 2.f),
+                             Vector4A16(-1.f, -1.f, -1.f, -1.f)};
+
+        if (bigEndian) {
+          extremes.SwapEndian();
+        }
+
+        PutPtr(track + layout.extremes, retVal.size());
+        retVal.append(reinterpret_cast<const char *>(&extremes),
+                      sizeof(extremes));
+      }
+    }
+  }
+
+  return retVal;
+}
+
+template <class Traits>
+static void FillMODCommon(MODInner<Traits> &main,
+                          const MODSettings &settings, size_t stride) {
+  main.bounds.bboxMin = Vector4A16(-1.f, -1.f, -1.f, 1.f);
+  main.bounds.bboxMax = Vector4A16(1.f, 1.f, 1.f, 1.f);
+  main.bounds.boundingSphere = Vector4A16(0.f, 0.f, 0.f, 1.73f);
+  main.metadata = {};
+  main.unkBufferSize = 0;
+  memset(main.remaps, 0, sizeof(main.remaps));
+
+  main.materials.resize(1);
+  auto &mat = main.materials.front().main;
+  mat.baseTextureIndex = -1;
+  mat.normalTextureIndex = -1;
+  mat.maskTextureIndex = -1;
+  mat.lightTextureIndex = -1;
+  mat.shadowTextureIndex = -1;
+  mat.additionalTextureIndex = -1;
+  mat.cubeMapTextureIndex = -1;
+  mat.detailTextureIndex = -1;
+  mat.AOTextureIndex = -1;
+
+  const size_t totalVertices = settings.numMeshes * settings.numVertices;
+  Random rng{0x4D4F440000000000 ^ settings.seed ^ settings.numMeshes};
+  main.vertexBuffer.resize(totalVertices * stride);
+
+  for (size_t v = 0; v < totalVertices; v++) {
+    float *position = reinterpret_cast<float *>(main.vertexBuffer.data() +
+                                                v * stride);
+    for (size_t c = 0; c < 3; c++) {
+      position[c] = rng.NextFloat() * 2.f - 1.f;
+    }
+  }
+
+  // Same triangle strip for every mesh, indices are mesh local
+  main.indexBuffer.reserve(totalVertices);
+
+  for (size_t m = 0; m < settings.numMeshes; m++) {
+    for (size_t i = 0; i < settings.numVertices; i++) {
+      main.indexBuffer.push_back(i);
+    }
+  }
+}
+
+// MODVersion::X99 layout, version field is patched for X19C
+static std::string MakeMODX99(const MODSettings &settings) {
+  // Non skinned material: P3f_N4c_R32_U2h_U2h_R32
+  static constexpr size_t STRIDE = 32;
+  MODInner<MODTraitsX99LE> main;
+  FillMODCommon(main, settings, STRIDE);
+
+  for (size_t m = 0; m < settings.numMeshes; m++) {
+    MODMeshX99 mesh{};
+    mesh.unk = m;
+    mesh.visible = true;
+    mesh.visibleLOD = es::Flags<uint8>(uint8(7));
+    mesh.buffer0Stride = STRIDE;
+    mesh.numVertices = settings.numVertices;
+    mesh.vertexStreamOffset = m * settings.numVertices * STRIDE;
+    mesh.indexStart = m * settings.numVertices;
+    mesh.numIndices = settings.numVertices;
+    main.meshes.emplace_back(mesh);
+  }
+
+  std::stringstream str;
+  SaveMODX99(main, str);
+  std::string retVal = std::move(str).str();
+
+  if (settings.version == MODVersion::X19C) {
+    const uint16 version = 0x19C;
+    memcpy(retVal.data() + 4, &version, sizeof(version));
+  }
+
+  return retVal;
+}
+
+static std::string MakeMODXC5(const MODSettings &settings) {
+  // 0xa7d7d035: P3f_R32_U2h
+  static constexpr size_t STRIDE = 20;
+  MODInner<MODTraitsXC5> main;
+  FillMODCommon(main, settings, STRIDE);
+
+  for (size_t m = 0; m < settings.numMeshes; m++) {
+    MODMeshXC5 mesh{};
+    mesh.unk = 1;
+    mesh.numVertices = settings.numVertices;
+    mesh.data0.Set<MODMeshXC5::GroupID>(m % 16);
+    mesh.data0.Set<MODMeshXC5::MaterialIndex>(0);
+    mesh.data0.Set<MODMeshXC5::VisibleLOD>(7);
+    mesh.data1.Set<MODMeshXC5::Visible>(1);
+    mesh.data1.Set<MODMeshXC5::VertexBufferStride>(STRIDE);
+    mesh.data1.Set<MODMeshXC5::PrimitiveType>(
+        uint8(MODMeshXC5::PrimitiveType_e::Strips));
+    mesh.vertexStreamOffset = m * settings.numVertices * STRIDE;
+    mesh.vertexFormat = 0xa7d7d035;
+    mesh.indexStart = m * settings.numVertices;
+    mesh.numIndices = settings.numVertices;
+    mesh.meshIndex = m;
+    main.meshes.emplace_back(mesh);
+  }
+
+  std::stringstream str;
+  SaveMODXC5(main, str);
+
+  return std::move(str).str();
+}
+
+std::string MakeMOD(const MODSettings &settings) {
+  if (settings.numVertices > 0x10000) {
+    throw es::RuntimeError("Too many vertices per mesh: " +
+                           std::to_string(settings.numVertices));
+  }
+
+  switch (settings.version) {
+  case MODVersion::X99:
+  case MODVersion::X19C:
+    return MakeMODX99(settings);
+  case MODVersion::XC5:
+    return MakeMODXC5(settings);
+  default:
+    throw es::InvalidVersionError(settings.version);
+  }
+}
+
+// XFS V1, root class holding array of item classes
+std::string MakeXFS(const XFSSettings &settings) {
+  struct Member {
+    std::string_view name;
+    uint8 type;
+    uint16 size;
+  };
+
+  // Values are XFSType
+  static const std::vector<Member> LAYOUTS[]{
+      {{"items", 1, 4}},
+      {{"id", 6, 4}, {"name", 14, 4}, {"position", 35, 12}, {"weight", 12, 4}},
+  };
+
+  const bool bigEndian = revil::IsPlatformBigEndian(settings.platform);
+  // Member padding is 4 pointers wide
+  const size_t paddingSize = bigEndian ? 32 : 16;
+  const size_t memberSize = 8 + paddingSize;
+  std::stringstream str;
+  BinWritterRef_e wr(str);
+  wr.SwapEndian(bigEndian);
+  wr.Write(CompileFourCC("XFS"));
+  wr.Write<uint16>(8);
+  wr.Write<uint16>(0);
+  wr.Write<uint32>(std::size(LAYOUTS));
+  wr.Write<uint32>(0); // dataStart
+  // Offsets are relative to end of header
+  static constexpr size_t ORIGIN = 16;
+  const size_t layoutsBegin = std::size(LAYOUTS) * 4;
+  size_t layoutOffset = layoutsBegin;
+
+  for (auto &l : LAYOUTS) {
+    wr.Write<uint32>(layoutOffset);
+    layoutOffset += 8 + l.size() * memberSize;
+  }
+
+  size_t nameOffset = layoutOffset;
+
+  for (uint32 l = 0; l < std::size(LAYOUTS); l++) {
+    wr.Write<uint32>(revil::MTHashV1("rSynthLayout" + std::to_string(l)) &
+                     0x7fffffff);
+    wr.Write<uint32>(LAYOUTS[l].size());
+
+    for (auto &m : LAYOUTS[l]) {
+      wr.Write<uint32>(nameOffset);
+      wr.Write(m.type);
+      wr.Write<uint8>(0);
+      wr.Write(m.size);
+      wr.Skip(paddingSize);
+      nameOffset += m.name.size() + 1;
+    }
+  }
+
+  for (auto &l : LAYOUTS) {
+    for (auto &m : l) {
+      wr.WriteBuffer(m.name.data(), m.name.size());
+      wr.Write<uint8>(0);
+    }
+  }
+
+  wr.ApplyPadding(4);
+  const size_t dataStart = wr.Tell() - ORIGIN;
+
+  // meta: active, layoutIndex, chunkSize counted from its own position
+  auto BeginClass = [&](uint32 layoutIndex) {
+    wr.Write<uint32>(1 | (layoutIndex << 1));
+    const size_t chunkBegin = wr.Tell();
+    wr.Write<uint32>(0);
+    return chunkBegin;
+  };
+
+  auto EndClass = [&](size_t chunkBegin) {
+    const size_t chunkEnd = wr.Tell();
+    wr.Seek(chunkBegin);
+    wr.Write<uint32>(chunkEnd - chunkBegin);
+    wr.Seek(chunkEnd);
+  };
+
+  Random rng{0x5846530000000000 ^ settings.seed ^ settings.numItems};
+  const size_t root = BeginClass(0);
+  wr.Write<uint32>(settings.numItems);
+
+  for (size_t i = 0; i < settings.numItems; i++) {
+    const size_t item = BeginClass(1);
+    wr.Write<uint32>(1);
+    wr.Write<uint32>(i);
+    wr.Write<uint32>(1);
+    const std::string name = "item_" + std::to_string(i);
+    wr.WriteBuffer(name.data(), name.size() + 1);
+    wr.Write<uint32>(1);
+    for (size_t c = 0; c < 3; c++) {
+      wr.Write(rng.NextFloat());
+    }
+    wr.Write<uint32>(1);
+    wr.Write(rng.NextFloat());
+    EndClass(item);
+  }
+
+  EndClass(root);
+  wr.Seek(12);
+  wr.Write<uint32>(dataStart);
+
+  return std::move(str).str();
+}
+
+// Built through SDLFromXML, which always writes x64 layout
+std::string MakeSDL(const SDLSettings &settings) {
+  static constexpr uint32 FRAME_STEP = 4;
+  Random rng{0x53444C0000000000 ^ settings.seed ^ settings.numNodes};
+  pugi::xml_document doc;
+  auto classNode = doc.append_child("class");
+  classNode.append_attribute("type").set_value("rScheduler");
+  auto maxFrame = classNode.append_child("maxFrame");
+  maxFrame.append_attribute("frame").set_value(
+      uint32(settings.numFrames * FRAME_STEP));
+  maxFrame.append_attribute("frameFlags").set_value(0);
+  auto entries = classNode.append_child("entries");
+  auto rootNode = entries.append_child("RootNode");
+  rootNode.append_attribute("name").set_value("root");
+  rootNode.append_attribute("type").set_value(0);
+
+  static const char *TRACK_TYPES[]{"Float", "Int32", "Vector4", "String"};
+
+  for (size_t n = 0; n < settings.numNodes; n++) {
+    auto node = rootNode.append_child("ClassNode");
+    node.append_attribute("name").set_value(
+        ("node_" + std::to_string(n)).c_str());
+    node.append_attribute("type").set_value(0);
+    node.append_attribute("entrySlot").set_value(uint32(n));
+    node.append_attribute("resourceHash").set_value("0");
+
+    for (size_t t = 0; t < settings.numTracks; t++) {
+      const size_t typeIndex = (n + t) % std::size(TRACK_TYPES);
+      auto track = node.append_child(TRACK_TYPES[typeIndex]);
+      track.append_attribute("name").set_value(
+          ("track_" + std::to_string(t)).c_str());
+      track.append_attribute("type").set_value(1);
+      track.append_attribute("arrayIndex").set_value(0);
+
+      for (size_t f = 0; f < settings.numFrames; f++) {
+        auto frame = track.append_child("frame");
+        frame.append_attribute("frame").set_value(uint32(f * FRAME_STEP));
+        frame.append_attribute("frameFlags").set_value(0);
+
+        switch (typeIndex) {
+        case 0:
+          frame.append_attribute("value").set_value(rng.NextFloat());
+          break;
+        case 1:
+          frame.append_attribute("value").set_value(int32(rng.Next() >> 8));
+          break;
+        case 2:
+          for (auto c : {"x", "y", "z", "w"}) {
+            frame.append_attribute(c).set_value(rng.NextFloat());
+          }
+          break;
+        default:
+          frame.append_attribute("value").set_value(
+              ("value_" + std::to_string(rng.Next() % 64)).c_str());
+          break;
+        }
+      }
+    }
+  }
+
+  std::stringstream str;
+  revil::SDLFromXML(str, doc);
+  std::string retVal = std::move(str).str();
+
+  if (revil::IsPlatformX64(settings.platform) &&
+      !revil::IsPlatformBigEndian(settings.platform)) {
+    return retVal;
+  }
+
+  std::stringstream inStr(retVal);
+  revil::SDL sdl;
+  sdl.Load(inStr);
+  std::stringstream outStr;
+  sdl.Save(outStr, settings.platform);
+
+  return std::move(outStr).str();
+}
+
+std::string MakeREMotionList(const LMTSettings &settings) {
+  std::stringstream lmtStr(MakeLMT(settings));
+  revil::LMT lmt;
+  lmt.Load(lmtStr);
+  uni::MotionsConst motions = lmt;
+  std::vector<std::decay_t<decltype(*motions->begin())>> holders;
+  std::vector<const uni::Motion *> items;
+
+  for (auto m : *motions) {
+    m->FrameRate(30);
+    items.emplace_back(m.get());
+    holders.emplace_back(std::move(m));
+  }
+
+  std::stringstream str;
+  revil::SaveREMotionList(str, items, "synth");
+
+  return std::move(str).str();
+}
+} // namespace synth
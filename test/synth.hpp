@@ -0,0 +1,116 @@
+#pragma once
+#include "revil/mod.hpp"
+#include "revil/platform.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Deterministic generators of synthetic, loadable assets
+// Same settings always produce identical output across runs and platforms
+namespace synth {
+using revil::MODVersion;
+using revil::Platform;
+
+struct Random {
+  uint64 state;
+
+  uint32 Next() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return uint32(state >> 16);
+  }
+
+  float NextFloat() { return float(Next() & 0xffffff) / float(0x1000000); }
+};
+
+// Compressible payload, short literal runs mixed with repeats
+std::string MakePayload(Random &rng, size_t size);
+std::vector<std::string> MakePaths(size_t numPaths);
+// LZX stream made of single uncompressed block, framed by 0x8000 chunks
+std::string MakeStoredLZX(std::string_view data);
+
+enum class ARCCompression { Zlib, LZX, ARCC };
+
+struct ARCSettings {
+  std::string_view title = "re5";
+  // Big endian platforms produce CRA archives
+  Platform platform = Platform::Win32;
+  ARCCompression compression = ARCCompression::Zlib;
+  size_t numFiles = 256;
+  size_t minFileSize = 0x100;
+  size_t maxFileSize = 0x2100;
+  uint64 seed = 0;
+};
+
+std::string MakeARC(const ARCSettings &settings);
+
+struct TEXSettings {
+  uint16 version = 0x9D;
+  Platform platform = Platform::Win32;
+  // Square BC1 texture with full mip chain
+  uint32 size = 256;
+  uint64 seed = 0;
+};
+
+std::string MakeTEX(const TEXSettings &settings);
+
+enum class LMTCodecs {
+  // LinearRotationQuat4_14bit, LinearVector3, SingleVector3
+  Linear,
+  // BiLinearRotationQuat4_7bit, BiLinearVector3_16bit, BiLinearVector3_8bit
+  BiLinear,
+  // Alternates between above per bone
+  Mixed,
+};
+
+struct LMTSettings {
+  // Supported versions: 66, 67, 68
+  uint16 version = 67;
+  // Pointer width and endianness are taken from platform
+  Platform platform = Platform::Win64;
+  LMTCodecs codecs = LMTCodecs::Linear;
+  size_t numAnimations = 16;
+  // Every bone has rotation, position and scale track
+  size_t numBones = 32;
+  size_t numKeys = 30;
+  uint64 seed = 0;
+};
+
+std::string MakeLMT(const LMTSettings &settings);
+
+struct MODSettings {
+  // Supported versions: X99, X19C, XC5
+  MODVersion version = MODVersion::X99;
+  size_t numMeshes = 16;
+  // Indices are mesh local, must fit into uint16
+  size_t numVertices = 1024;
+  uint64 seed = 0;
+};
+
+std::string MakeMOD(const MODSettings &settings);
+
+struct XFSSettings {
+  // V1 layout, big endian platforms use 64bit member padding
+  Platform platform = Platform::Win32;
+  size_t numItems = 256;
+  uint64 seed = 0;
+};
+
+std::string MakeXFS(const XFSSettings &settings);
+
+struct SDLSettings {
+  // Version 0x16 scheduler, converted into platform's layout
+  Platform platform = Platform::Win64;
+  size_t numNodes = 64;
+  // Mix of Float, Int32, Vector4 and String tracks
+  size_t numTracks = 8;
+  size_t numFrames = 16;
+  uint64 seed = 0;
+};
+
+std::string MakeSDL(const SDLSettings &settings);
+
+// motlist.99, motions are converted from synthetic LMT
+std::string MakeREMotionList(const LMTSettings &settings);
+} // namespace synth
@@ -0,0 +1,398 @@
+#pragma once
+#include "revil/arc.hpp"
+#include "revil/lmt.hpp"
+#include "revil/mod.hpp"
+#include "revil/re_asset.hpp"
+#include "revil/sdl.hpp"
+#include "revil/tex.hpp"
+#include "revil/xfs.hpp"
+#include "spike/io/binreader_stream.hpp"
+#include "pugixml.hpp"
+#include "spike/util/unit_testing.hpp"
+#include "synth.hpp"
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+
+int test_synth_arc() {
+  struct CountContext : revil::ArcExtractContext {
+    size_t numFiles = 0;
+    size_t dataSize = 0;
+
+    void NewFile(const std::string &) override { numFiles++; }
+    void SendData(std::string_view data) override { dataSize += data.size(); }
+  };
+
+  for (auto compression :
+       {synth::ARCCompression::Zlib, synth::ARCCompression::LZX,
+        synth::ARCCompression::ARCC}) {
+    synth::ARCSettings settings{.compression = compression, .numFiles = 300};
+    settings.title = compression == synth::ARCCompression::LZX    ? "dmc4"
+                     : compression == synth::ARCCompression::ARCC ? "ddon"
+                                                                   : "re5";
+    std::stringstream str(synth::MakeARC(settings));
+    CountContext ctx;
+    revil::EnumerateArchive(
+        str, revil::Platform::Win32, settings.title, [&] { return &ctx; },
+        {});
+
+    TEST_EQUAL(ctx.numFiles, settings.numFiles);
+    TEST_EQUAL(ctx.dataSize > 0, true);
+  }
+
+  return 0;
+}
+
+// Entries sharing payload must all receive it
+int test_synth_arc_shared() {
+  struct CollectContext : revil::ArcExtractContext {
+    std::vector<std::string> files;
+
+    void NewFile(const std::string &) override {}
+    void SendData(std::string_view data) override { files.emplace_back(data); }
+  };
+
+  synth::ARCSettings settings{.numFiles = 8};
+  std::string arc = synth::MakeARC(settings);
+  const size_t tableBegin = arc.find(synth::MakePaths(settings.numFiles)[0]);
+  TEST_EQUAL(tableBegin != arc.npos, true);
+
+  // Point second and last entry at payload of first one
+  const size_t entrySize = 0x50;
+  const size_t sizesBegin = 0x44;
+  char *firstEntry = arc.data() + tableBegin;
+
+  for (size_t f : {size_t(1), settings.numFiles - 1}) {
+    memcpy(firstEntry + f * entrySize + sizesBegin, firstEntry + sizesBegin,
+           entrySize - sizesBegin);
+  }
+
+  std::stringstream str(arc);
+  CollectContext ctx;
+  revil::EnumerateArchive(
+      str, revil::Platform::Win32, settings.title, [&] { return &ctx; }, {});
+
+  // Entries are extracted by offset, shared ones come first
+  TEST_EQUAL(ctx.files.size(), settings.numFiles);
+  TEST_EQUAL(ctx.files[1] == ctx.files[0], true);
+  TEST_EQUAL(ctx.files[2] == ctx.files[0], true);
+  TEST_EQUAL(ctx.files[3] == ctx.files[0], false);
+
+  return 0;
+}
+
+int test_synth_lmt() {
+  for (uint16 version : {66, 67, 68}) {
+    for (auto platform : {revil::Platform::Win32, revil::Platform::Win64,
+                          revil::Platform::PS3}) {
+      for (auto codecs : {synth::LMTCodecs::Linear, synth::LMTCodecs::BiLinear,
+                          synth::LMTCodecs::Mixed}) {
+        synth::LMTSettings settings{.version = version,
+                                    .platform = platform,
+                                    .codecs = codecs,
+                                    .numAnimations = 3,
+                                    .numBones = 5,
+                                    .numKeys = 4};
+        std::stringstream str(synth::MakeLMT(settings));
+        revil::LMT lmt;
+        lmt.Load(str);
+
+        TEST_EQUAL(uint16(lmt.Version()), version);
+        const bool x64 = lmt.Architecture() == revil::LMTArchType::X64;
+        TEST_EQUAL(x64, revil::IsPlatformX64(platform));
+
+        uni::MotionsConst motions = lmt;
+        TEST_EQUAL(motions->Size(), settings.numAnimations);
+
+        for (auto m : *motions) {
+          TEST_EQUAL(m->Tracks()->Size(), settings.numBones * 3);
+          m->FrameRate(60);
+
+          for (auto t : *m) {
+            Vector4A16 value;
+            t->GetValue(value, m->Duration());
+          }
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+int test_synth_xfs() {
+  for (auto platform : {revil::Platform::Win32, revil::Platform::PS3}) {
+    const synth::XFSSettings settings{.platform = platform, .numItems = 100};
+    std::stringstream str(synth::MakeXFS(settings));
+    revil::XFS xfs;
+    xfs.Load(str);
+
+    pugi::xml_document doc;
+    xfs.ToXML(doc);
+    auto items = doc.child("class").child("array");
+    TEST_EQUAL(std::string_view(items.attribute("name").as_string()),
+               "items");
+    TEST_EQUAL(items.attribute("count").as_uint(), settings.numItems);
+
+    // Same sequence as generator
+    synth::Random rng{0x5846530000000000 ^ settings.seed ^ settings.numItems};
+    size_t numItems = 0;
+
+    for (auto item : items.children("class_")) {
+      auto Member = [&](const char *type, const char *name) {
+        return item.find_child_by_attribute(type, "name", name);
+      };
+
+      TEST_EQUAL(Member("u32_", "id").attribute("value").as_uint(), numItems);
+      const std::string name = "item_" + std::to_string(numItems);
+      TEST_EQUAL(Member("string_", "name").attribute("value").as_string(),
+                 name);
+
+      auto position = Member("vector3_", "position");
+
+      for (auto c : {"x", "y", "z"}) {
+        const float value = rng.NextFloat();
+        TEST_EQUAL(std::abs(position.attribute(c).as_float() - value) < 1e-6f,
+                   true);
+      }
+
+      const float weight = rng.NextFloat();
+      auto value = Member("f32_", "weight").attribute("value");
+      TEST_EQUAL(std::abs(value.as_float() - weight) < 1e-6f, true);
+      numItems++;
+    }
+
+    TEST_EQUAL(numItems, settings.numItems);
+  }
+
+  return 0;
+}
+
+// Values follow generator's order: nodes, tracks, frames
+static int CheckSynthSDL(const revil::SDL &sdl,
+                         const synth::SDLSettings &settings) {
+  static constexpr uint32 FRAME_STEP = 4;
+  static const char *TRACK_TYPES[]{"Float", "Int32", "Vector4", "String"};
+  pugi::xml_document doc;
+  sdl.ToXML(doc);
+  TEST_EQUAL(doc.child("maxFrame").attribute("frame").as_uint(),
+             settings.numFrames * FRAME_STEP);
+
+  auto rootNode = doc.child("entries").child("RootNode");
+  TEST_EQUAL(std::string_view(rootNode.attribute("name").as_string()), "root");
+  synth::Random rng{0x53444C0000000000 ^ settings.seed ^ settings.numNodes};
+  auto classNodes = rootNode.children("ClassNode");
+  TEST_EQUAL(size_t(std::distance(classNodes.begin(), classNodes.end())),
+             settings.numNodes);
+
+  auto CloseTo = [](pugi::xml_attribute attr, float value) {
+    return std::abs(attr.as_float() - value) < 1e-6f;
+  };
+
+  for (size_t n = 0; n < settings.numNodes; n++) {
+    const std::string nodeName = "node_" + std::to_string(n);
+    auto node =
+        rootNode.find_child_by_attribute("ClassNode", "name", nodeName.c_str());
+    TEST_EQUAL(node.empty(), false);
+    TEST_EQUAL(node.attribute("entrySlot").as_uint(), n);
+
+    for (size_t t = 0; t < settings.numTracks; t++) {
+      const size_t typeIndex = (n + t) % std::size(TRACK_TYPES);
+      const std::string trackName = "track_" + std::to_string(t);
+      auto track = node.find_child_by_attribute(TRACK_TYPES[typeIndex], "name",
+                                                trackName.c_str());
+      TEST_EQUAL(track.empty(), false);
+      size_t f = 0;
+
+      for (auto frame : track.children("frame")) {
+        TEST_EQUAL(frame.attribute("frame").as_uint(), f * FRAME_STEP);
+
+        switch (typeIndex) {
+        case 0: {
+          const float value = rng.NextFloat();
+          TEST_EQUAL(CloseTo(frame.attribute("value"), value), true);
+          break;
+        }
+        case 1: {
+          const int32 value = rng.Next() >> 8;
+          TEST_EQUAL(frame.attribute("value").as_int(), value);
+          break;
+        }
+        case 2:
+          for (auto c : {"x", "y", "z", "w"}) {
+            const float value = rng.NextFloat();
+            TEST_EQUAL(CloseTo(frame.attribute(c), value), true);
+          }
+          break;
+        default: {
+          const std::string value = "value_" + std::to_string(rng.Next() % 64);
+          TEST_EQUAL(frame.attribute("value").as_string(), value);
+          break;
+        }
+        }
+
+        f++;
+      }
+
+      TEST_EQUAL(f, settings.numFrames);
+    }
+  }
+
+  return 0;
+}
+
+int test_synth_sdl() {
+  for (auto platform : {revil::Platform::Win64, revil::Platform::Win32,
+                        revil::Platform::PS3}) {
+    const synth::SDLSettings settings{
+        .platform = platform, .numNodes = 10, .numTracks = 5};
+    const std::string data = synth::MakeSDL(settings);
+    std::stringstream str(data);
+    revil::SDL sdl;
+    sdl.Load(str);
+    TEST_EQUAL(CheckSynthSDL(sdl, settings), 0);
+
+    if (!revil::IsPlatformBigEndian(platform)) {
+      revil::SDL view;
+      view.LoadView(data);
+      TEST_EQUAL(CheckSynthSDL(view, settings), 0);
+    }
+  }
+
+  return 0;
+}
+
+// Layout conversion must not change scheduler contents
+int test_synth_sdl_convert() {
+  auto ToXML = [](const revil::SDL &sdl) {
+    pugi::xml_document doc;
+    sdl.ToXML(doc);
+    std::stringstream str;
+    doc.save(str);
+    return std::move(str).str();
+  };
+
+  std::stringstream str(synth::MakeSDL(
+      {.platform = revil::Platform::PS3, .numNodes = 10, .numTracks = 5}));
+  revil::SDL sdl;
+  sdl.Load(str);
+  const std::string xml = ToXML(sdl);
+
+  std::stringstream converted;
+  sdl.Save(converted, revil::Platform::Win64);
+  revil::SDL sdlX64;
+  sdlX64.Load(converted);
+  const std::string xmlX64 = ToXML(sdlX64);
+
+  TEST_EQUAL(xml.empty(), false);
+  TEST_EQUAL(xml == xmlX64, true);
+
+  return 0;
+}
+
+// Corrupted offsets and truncated files must be rejected, not dereferenced
+int test_synth_checked() {
+  auto Rejected = [](auto &&load, const std::string &data) {
+    std::stringstream str(data);
+
+    try {
+      load(str);
+    } catch (const std::exception &) {
+      return true;
+    }
+
+    return false;
+  };
+
+  auto LoadLMT = [](auto &str) {
+    revil::LMT lmt;
+    lmt.Load(str);
+  };
+
+  const std::string lmt = synth::MakeLMT(
+      {.platform = revil::Platform::Win32, .numAnimations = 2, .numBones = 2});
+  TEST_EQUAL(Rejected(LoadLMT, lmt), false);
+
+  // First entry of animation lookup table
+  std::string badTable = lmt;
+  const uint32 badOffset = 0x7fffffff;
+  memcpy(badTable.data() + 8, &badOffset, sizeof(badOffset));
+  TEST_EQUAL(Rejected(LoadLMT, badTable), true);
+
+  // Tracks pointer of first animation
+  std::string badPointer = lmt;
+  uint32 animOffset;
+  memcpy(&animOffset, lmt.data() + 8, sizeof(animOffset));
+  const uint32 pastEnd = lmt.size() + 0x10;
+  memcpy(badPointer.data() + animOffset, &pastEnd, sizeof(pastEnd));
+  TEST_EQUAL(Rejected(LoadLMT, badPointer), true);
+
+  auto LoadRE = [](auto &str) {
+    revil::REAsset asset;
+    asset.Load(str);
+  };
+
+  const std::string motlist =
+      synth::MakeREMotionList({.numAnimations = 2, .numBones = 2});
+  TEST_EQUAL(Rejected(LoadRE, motlist), false);
+  TEST_EQUAL(Rejected(LoadRE, motlist.substr(0, motlist.size() / 2)), true);
+
+  struct NullContext : revil::ArcExtractContext {
+    void NewFile(const std::string &) override {}
+    void SendData(std::string_view) override {}
+  };
+
+  auto LoadARC = [](auto &str) {
+    NullContext ctx;
+    revil::EnumerateArchive(
+        str, revil::Platform::Win32, "re5", [&] { return &ctx; }, {});
+  };
+
+  // compressedSize of first entry
+  const std::string arc = synth::MakeARC({.numFiles = 4});
+  TEST_EQUAL(Rejected(LoadARC, arc), false);
+  const size_t tableBegin = arc.find(synth::MakePaths(4)[0]);
+  std::string badEntry = arc;
+  memcpy(badEntry.data() + tableBegin + 0x44, &badOffset, sizeof(badOffset));
+  TEST_EQUAL(Rejected(LoadARC, badEntry), true);
+
+  auto LoadMOD = [](auto &str) {
+    revil::MOD mod;
+    mod.Load(str);
+  };
+
+  const std::string mod = synth::MakeMOD({.numMeshes = 2, .numVertices = 16});
+  TEST_EQUAL(Rejected(LoadMOD, mod), false);
+
+  // numIndices, vertexBufferSize
+  for (size_t offset : {0x10, 0x18}) {
+    std::string badCount = mod;
+    memcpy(badCount.data() + offset, &badOffset, sizeof(badOffset));
+    TEST_EQUAL(Rejected(LoadMOD, badCount), true);
+  }
+
+  auto LoadTEX = [](auto &str) {
+    revil::TEX tex;
+    tex.Load(str);
+  };
+
+  // Header without full offset table
+  const std::string tex = synth::MakeTEX({.size = 64});
+  TEST_EQUAL(Rejected(LoadTEX, tex), false);
+  TEST_EQUAL(Rejected(LoadTEX, tex.substr(0, 20)), true);
+
+  auto LoadXFS = [](auto &str) {
+    revil::XFS xfs;
+    xfs.Load(str);
+  };
+
+  // numLayouts
+  const std::string xfs = synth::MakeXFS({.numItems = 4});
+  TEST_EQUAL(Rejected(LoadXFS, xfs), false);
+  std::string badLayouts = xfs;
+  memcpy(badLayouts.data() + 8, &badOffset, sizeof(badOffset));
+  TEST_EQUAL(Rejected(LoadXFS, badLayouts), true);
+
+  return 0;
+}
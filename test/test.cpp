@@ -1,5 +1,13 @@
 
+#include "arc_update.inl"
+#include "container.inl"
+#include "fixup.inl"
+#include "hash.inl"
 #include "lmt_codecs.inl"
+#include "re_motion.inl"
+#include "sngw.inl"
+#include "synth.inl"
+#include "tex.inl"
 
 int main() {
   es::print::AddPrinterFunction(es::Print);
@@ -10,7 +18,21 @@ int main() {
              TEST_FUNC(test_lmt_codec05), TEST_FUNC(test_lmt_codec06),
              TEST_FUNC(test_lmt_codec07), TEST_FUNC(test_lmt_codec08),
              TEST_FUNC(test_lmt_codec09), TEST_FUNC(test_lmt_codec10),
-             TEST_FUNC(test_lmt_codec11), TEST_FUNC(test_lmt_codec12));
+             TEST_FUNC(test_lmt_codec11), TEST_FUNC(test_lmt_codec12),
+             TEST_FUNC(test_hash_v1), TEST_FUNC(test_hash_v2),
+             TEST_FUNC(test_hash_batch), TEST_FUNC(test_fixup_tracker),
+             TEST_FUNC(test_fixup_tracker_extent),
+             TEST_FUNC(test_fixup_tracker_shared),
+             TEST_FUNC(test_sngw), TEST_FUNC(test_synth_arc),
+             TEST_FUNC(test_synth_arc_shared), TEST_FUNC(test_arc_update),
+             TEST_FUNC(test_container_extract),
+             TEST_FUNC(test_synth_lmt), TEST_FUNC(test_synth_xfs),
+             TEST_FUNC(test_synth_sdl), TEST_FUNC(test_synth_sdl_convert),
+             TEST_FUNC(test_synth_checked),
+             TEST_FUNC(test_tex_read_mip),
+             TEST_FUNC(test_tex_save_roundtrip), TEST_FUNC(test_re_codec_decode),
+             TEST_FUNC(test_re_motion_roundtrip),
+             TEST_FUNC(test_re_motlist_overlap));
 
   return testResult;
 }
@@ -0,0 +1,235 @@
+#pragma once
+#include "revil/tex.hpp"
+#include "spike/util/unit_testing.hpp"
+#include "synth.hpp"
+#include "tex.hpp"
+#include <cstring>
+#include <sstream>
+
+// Header followed by mipmaps, each filled with its index
+template <class Header>
+std::string MakeMipFile(const Header &hdr, const std::vector<size_t> &sizes) {
+  std::string file(sizeof(hdr), 0);
+  memcpy(file.data(), &hdr, sizeof(hdr));
+
+  for (size_t m = 0; m < sizes.size(); m++) {
+    file.append(sizes[m], char(m));
+  }
+
+  return file;
+}
+
+int CheckMips(const std::string &file, const std::vector<size_t> &sizes) {
+  std::stringstream str(file);
+  revil::TEX tex;
+  tex.LoadHeader(str);
+  TEST_EQUAL(tex.buffer.empty(), true);
+
+  for (uint32 m = 0; m < sizes.size(); m++) {
+    TEST_EQUAL(tex.MipSize(0, m), sizes[m]);
+    std::string mip(sizes[m], 0);
+    tex.ReadMip(str, 0, m, mip);
+    TEST_EQUAL(mip == std::string(sizes[m], char(m)), true);
+    TEST_EQUAL(tex.MipView(file, 0, m) == mip, true);
+  }
+
+  return 0;
+}
+
+int test_tex_read_mip() {
+  {
+    const std::string file = synth::MakeTEX({.size = 64});
+    std::stringstream str(file);
+    revil::TEX full;
+    full.Load(str);
+    revil::TEX tex;
+    str.clear();
+    str.seekg(0);
+    tex.LoadHeader(str);
+    TEST_EQUAL(tex.offsets == full.offsets, true);
+
+    for (uint32 m = 0; m < full.ctx.numMipmaps; m++) {
+      std::string mip(tex.MipSize(0, m), 0);
+      tex.ReadMip(str, 0, m, mip);
+      TEST_EQUAL(full.buffer.compare(full.offsets[m], mip.size(), mip), 0);
+    }
+  }
+
+  // No offset table, packed BC1 mips
+  {
+    revil::TEXx56 hdr{};
+    hdr.id = revil::TEXID;
+    hdr.version = 0x56;
+    hdr.type = revil::TextureType::General;
+    hdr.layout = revil::TEXx56::TextureLayout::General;
+    hdr.numMips = 4;
+    hdr.width = 32;
+    hdr.height = 32;
+    hdr.arraySize = 1;
+    hdr.fourcc = revil::TEXFormat::DXT1;
+    const std::vector<size_t> sizes{512, 128, 32, 8};
+    TEST_EQUAL(CheckMips(MakeMipFile(hdr, sizes), sizes), 0);
+  }
+
+  // 3DS, mips are padded to 8x8 tiles
+  {
+    using t = revil::TEXx9D;
+    t hdr{};
+    hdr.id = revil::TEXID;
+    hdr.tier0.Set<t::Version>(0xA4);
+    hdr.tier0.Set<t::TextureType>(uint32(revil::TextureTypeV2::General));
+    hdr.tier1.Set<t::NumMips>(4);
+    hdr.tier1.Set<t::Width>(32);
+    hdr.tier1.Set<t::Height>(32);
+    hdr.numFaces = 1;
+    hdr.format = revil::TEXFormatV2(revil::TEXFormat3DS::RGBA8);
+    hdr.depth = 1;
+    const std::vector<size_t> sizes{4096, 1024, 256, 256};
+    TEST_EQUAL(CheckMips(MakeMipFile(hdr, sizes), sizes), 0);
+  }
+
+  return 0;
+}
+
+// Byte offset of RGBA8 texel within stored mipmap, only for square textures
+size_t TiledTexelOffset(uint32 x, uint32 y, uint32 width, TexelTile tile) {
+  auto Interleave = [](uint32 x, uint32 y, uint32 size) {
+    uint32 index = 0;
+
+    for (uint32 b = 0; (1U << b) < size; b++) {
+      index |= ((x >> b) & 1) << (b * 2);
+      index |= ((y >> b) & 1) << (b * 2 + 1);
+    }
+
+    return index;
+  };
+
+  switch (tile) {
+  case TexelTile::Morton:
+    return Interleave(x, y, width) * 4;
+  case TexelTile::PS4:
+  case TexelTile::N3DS: {
+    const size_t tileIndex = (y / 8) * ((width + 7) / 8) + x / 8;
+    return (tileIndex * 64 + Interleave(x % 8, y % 8, 8)) * 4;
+  }
+  case TexelTile::NX: {
+    // Blocks of 64 bytes x (8 * blockHeight) rows made of 512 byte GOBs
+    uint32 blockHeight = 16;
+
+    while (blockHeight > 1 && width <= blockHeight * 4) {
+      blockHeight /= 2;
+    }
+
+    const size_t xb = x * 4;
+    const size_t blockRows = 8 * blockHeight;
+    const size_t blockSize = 512 * blockHeight;
+    const size_t blocksPerRow = (width * 4 + 63) / 64;
+    const size_t gobOffset = ((xb % 64) / 32) * 256 + ((y % 8) / 2) * 64 +
+                             ((xb % 32) / 16) * 32 + (y % 2) * 16 + xb % 16;
+
+    return (y / blockRows) * blocksPerRow * blockSize +
+           (xb / 64) * blockSize + ((y % blockRows) / 8) * 512 + gobOffset;
+  }
+  default:
+    return (size_t(y) * width + x) * 4;
+  }
+}
+
+int test_tex_save_roundtrip() {
+  const uint16 versions[]{0x97, 0x98, 0x99, 0x9A, 0x9D,
+                          0xA0, 0xA3, 0xA5, 0xA6};
+  const uint32 size = 16;
+
+  for (int8 numFaces : {1, 6}) {
+    revil::TEX source{};
+    source.ctx.width = size;
+    source.ctx.height = size;
+    source.ctx.depth = 1;
+    source.ctx.numFaces = numFaces;
+    source.ctx.numMipmaps = 1;
+    source.ctx.baseFormat.type = TexelInputFormatType::RGBA8;
+    source.buffer.resize(size * size * 4 * numFaces);
+
+    for (size_t i = 0; i < source.buffer.size(); i++) {
+      source.buffer[i] = char(i * 31 + (i >> 7));
+    }
+
+    for (size_t h = 0; h < 27; h++) {
+      source.harmonics[h] = float(h) * 0.25f;
+    }
+
+    source.GenerateMipmaps();
+    const uint32 numMips = source.ctx.numMipmaps;
+    TEST_EQUAL(numMips, 5U);
+
+    // Box filtered from top level
+    const uint8 *top = reinterpret_cast<const uint8 *>(source.buffer.data());
+    const uint32 average =
+        (top[0] + top[4] + top[size * 4] + top[size * 4 + 4] + 2) / 4;
+    TEST_EQUAL(uint32(uint8(source.buffer[source.offsets[1]])), average);
+
+    for (revil::Platform platform :
+         {revil::Platform::Win32, revil::Platform::PS3,
+          revil::Platform::PS4, revil::Platform::NSW}) {
+      for (uint16 version : versions) {
+        std::stringstream str;
+        source.Save(str, version, platform);
+        str.seekg(0);
+        revil::TEX tex;
+        tex.Load(str, platform);
+
+        const bool is3DS = version == 0xA5 || version == 0xA6;
+        TexelTile tile = TexelInputFormat{}.tile;
+
+        if (is3DS) {
+          tile = TexelTile::N3DS;
+        } else if (platform == revil::Platform::PS3) {
+          tile = TexelTile::Morton;
+        } else if (platform == revil::Platform::PS4) {
+          tile = TexelTile::PS4;
+        } else if (platform == revil::Platform::NSW) {
+          tile = TexelTile::NX;
+        }
+
+        TEST_EQUAL(tex.ctx.width, source.ctx.width);
+        TEST_EQUAL(tex.ctx.height, source.ctx.height);
+        TEST_EQUAL(uint32(tex.ctx.numMipmaps), numMips);
+        TEST_EQUAL(int(std::max(int8(1), tex.ctx.numFaces)), int(numFaces));
+        TEST_EQUAL(tex.ctx.baseFormat.type == TexelInputFormatType::RGBA8,
+                   true);
+        TEST_EQUAL(tex.ctx.baseFormat.tile == tile, true);
+        TEST_EQUAL(tex.offsets.size(), size_t(numFaces) * numMips);
+
+        if (numFaces == 6) {
+          TEST_EQUAL(memcmp(tex.harmonics, source.harmonics,
+                            sizeof(source.harmonics)),
+                     0);
+        }
+
+        for (uint32 f = 0; f < uint32(numFaces); f++) {
+          for (uint32 m = 0; m < numMips; m++) {
+            const uint32 index = f * numMips + m;
+            const uint32 mipSize = std::max(1U, size >> m);
+            const char *src = source.buffer.data() + source.offsets[index];
+            const char *mip = tex.buffer.data() + tex.offsets[index];
+
+            for (uint32 y = 0; y < mipSize; y++) {
+              for (uint32 x = 0; x < mipSize; x++) {
+                const char *expected = src + (size_t(y) * mipSize + x) * 4;
+                const char *texel =
+                    mip + TiledTexelOffset(x, y, mipSize, tile);
+
+                // 3DS stores RGBA8 as ABGR
+                for (uint32 c = 0; c < 4; c++) {
+                  TEST_EQUAL(texel[c], expected[is3DS ? 3 - c : c]);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return 0;
+}
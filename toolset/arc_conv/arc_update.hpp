@@ -0,0 +1,181 @@
+/*  ARCConvert
+    Copyright(C) 2021-2022 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "arc.hpp"
+#include "spike/io/binwritter_stream.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+
+// Archive table entry used by archive updates
+// uSize keeps flag bits, entries of updated archive are written back with
+// their original flags
+struct ARCTableEntry {
+  std::string path; // '/' separated, without extension
+  size_t offset;
+  uint32 hash;
+  ARCFileSize uSize;
+  uint32 cSize;
+  // Replaced entry of updated archive
+  size_t baseIndex = -1;
+};
+
+// Table of little endian, unencrypted archive
+inline std::vector<ARCTableEntry> ReadARCEntries(BinReaderRef_e rd,
+                                                 bool extendedPath) {
+  std::vector<ARCTableEntry> entries;
+
+  auto AddEntries = [&](auto &hdr, auto &files) {
+    if (hdr.IsLZX()) {
+      throw es::RuntimeError("LZX archives cannot be updated.");
+    }
+
+    for (auto &f : files) {
+      ARCTableEntry entry;
+      entry.path.assign(f.fileName, strnlen(f.fileName, sizeof(f.fileName)));
+      std::replace(entry.path.begin(), entry.path.end(), '\\', '/');
+      entry.offset = f.offset;
+      entry.hash = f.typeHash;
+      entry.uSize = f.uncompressedSize;
+      entry.cSize = f.compressedSize;
+      entries.emplace_back(std::move(entry));
+    }
+  };
+
+  if (extendedPath) {
+    auto [hdr, files] = ReadExtendedARC(rd);
+    AddEntries(hdr, files);
+  } else {
+    auto [hdr, files] = ReadARC(rd);
+    AddEntries(hdr, files);
+  }
+
+  return entries;
+}
+
+// Contiguous range of data copied from updated archive
+struct ARCRun {
+  size_t begin;
+  size_t end;
+  size_t newBegin;
+};
+
+// Moves kept entries into runs starting at dataBegin, gaps between entries
+// are dropped, returns end of last run
+template <class Entry>
+size_t PackARCRuns(std::vector<Entry *> kept, size_t dataBegin,
+                   std::vector<ARCRun> &runs) {
+  std::sort(kept.begin(), kept.end(),
+            [](auto *a, auto *b) { return a->offset < b->offset; });
+
+  size_t curOffset = dataBegin;
+
+  for (auto *f : kept) {
+    if (runs.empty() || f->offset > runs.back().end) {
+      if (!runs.empty()) {
+        curOffset += runs.back().end - runs.back().begin;
+      }
+
+      runs.push_back({f->offset, f->offset, curOffset});
+    }
+
+    auto &run = runs.back();
+    run.end = std::max(run.end, f->offset + f->cSize);
+    f->offset = run.newBegin + (f->offset - run.begin);
+  }
+
+  if (!runs.empty()) {
+    curOffset += runs.back().end - runs.back().begin;
+  }
+
+  return curOffset;
+}
+
+template <class Entry>
+void WriteARCEntry(BinWritterRef wr, const Entry &f, bool extendedPath,
+                   bool backslashes) {
+  auto Write = [&](auto cFile) {
+    cFile.offset = f.offset;
+    cFile.typeHash = f.hash;
+    memcpy(cFile.fileName, f.path.data(), f.path.size());
+    cFile.uncompressedSize = f.uSize;
+    cFile.compressedSize = f.cSize;
+
+    if (backslashes) {
+      std::replace(std::begin(cFile.fileName), std::end(cFile.fileName), '/',
+                   '\\');
+    }
+
+    wr.Write(cFile);
+  };
+
+  if (extendedPath) {
+    Write(ARCExtendedFile{});
+  } else {
+    Write(ARCFile{});
+  }
+}
+
+// Merges new entries into table of updated archive, entries with baseIndex
+// replace base entries, others are appended
+// Offsets of new entries are relative to new data, which is moved behind
+// runs of kept entries, returns runs to copy from updated archive
+template <class Entry>
+std::vector<ARCRun> MergeARCTable(std::vector<Entry> &table,
+                                  std::vector<Entry> &&files,
+                                  size_t headerSize, size_t entrySize) {
+  std::vector<bool> replaced(table.size());
+
+  for (auto &f : files) {
+    if (f.baseIndex < replaced.size()) {
+      replaced[f.baseIndex] = true;
+    }
+  }
+
+  const size_t numEntries = table.size() + files.size() -
+                            std::count(replaced.begin(), replaced.end(), true);
+
+  if (numEntries > std::numeric_limits<decltype(ARC::numFiles)>::max()) {
+    throw es::RuntimeError("Filecount exceeded archive limit.");
+  }
+
+  std::vector<Entry *> kept;
+
+  for (size_t i = 0; i < table.size(); i++) {
+    if (!replaced[i]) {
+      kept.push_back(&table[i]);
+    }
+  }
+
+  std::vector<ARCRun> runs;
+  const size_t newDataBegin =
+      PackARCRuns(kept, headerSize + numEntries * entrySize, runs);
+
+  for (auto &f : files) {
+    f.offset += newDataBegin;
+
+    if (f.baseIndex < table.size()) {
+      table[f.baseIndex] = std::move(f);
+    } else {
+      table.emplace_back(std::move(f));
+    }
+  }
+
+  return runs;
+}
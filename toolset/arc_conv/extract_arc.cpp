@@ -19,6 +19,7 @@
 #include "hfs.hpp"
 #include "project.h"
 #include "revil/arc.hpp"
+#include "revil/trace.hpp"
 
 static struct ARCExtract : ReflectorBase<ARCExtract> {
   std::string title;
@@ -72,6 +73,7 @@ bool AppInitContext(const std::string &) {
 }
 
 void AppProcessFile(AppContext *ctx) {
+  revil::TraceZone zone("app.extract_arc");
   revil::EnumerateArchive(
       ctx->GetStream(), settings.platform, settings.title,
       [ctx] { return ctx->ExtractContext(); }, settings.classWhitelist_);
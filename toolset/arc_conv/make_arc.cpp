@@ -16,6 +16,7 @@
 */
 
 #include "arc_conv.hpp"
+#include "arc_update.hpp"
 #include "project.h"
 #include "revil/arc.hpp"
 #include "spike/io/binreader.hpp"
@@ -24,13 +25,25 @@
 #include "spike/master_printer.hpp"
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
 #include <mutex>
+#include <optional>
+#include <set>
 #include <thread>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 static struct ARCMake : ReflectorBase<ARCMake> {
   std::string title;
   Platform platform = Platform::Auto;
   bool forceZLIBHeader = false;
+  std::string update;
+  uint32 memoryBudget = 1024;
 } settings;
 
 REFLECT(CLASS(ARCMake),
@@ -39,7 +52,14 @@ REFLECT(CLASS(ARCMake),
                ReflDesc{"Set platform for correct archive handling."}),
         MEMBERNAME(forceZLIBHeader, "force-zlib-header", "z",
                    ReflDesc{"Force ZLIB header for files that won't be "
-                            "compressed. (Some platforms only)"}));
+                            "compressed. (Some platforms only)"}),
+        MEMBER(update, "u",
+               ReflDesc{"Update existing archive. Input folder contains only "
+                        "changed or added files, unchanged entries are copied "
+                        "without recompression."}),
+        MEMBERNAME(memoryBudget, "memory-budget",
+                   ReflDesc{"Memory limit (MB) for files being compressed at "
+                            "once across all threads."}));
 
 static AppInfo_s appInfo{
     .header = ARCConvert_DESC " v" ARCConvert_VERSION ", " ARCConvert_COPYRIGHT
@@ -49,12 +69,299 @@ static AppInfo_s appInfo{
 
 AppInfo_s *AppInitModule() { return &appInfo; }
 
-struct AFile {
-  std::string path;
-  size_t offset;
-  uint32 hash;
-  uint32 uSize;
-  uint32 cSize;
+struct Hash128 {
+  uint64 h1;
+  uint64 h2;
+
+  auto operator<=>(const Hash128 &) const = default;
+};
+
+// MurmurHash3 x64 128
+static Hash128 HashContent(std::string_view data) {
+  static constexpr uint64 c1 = 0x87c37b91114253d5ULL;
+  static constexpr uint64 c2 = 0x4cf5ad432745937fULL;
+  auto Rotl = [](uint64 x, int r) { return (x << r) | (x >> (64 - r)); };
+  auto FMix = [](uint64 k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+  };
+  auto MixK1 = [&](uint64 k1) { return Rotl(k1 * c1, 31) * c2; };
+  auto MixK2 = [&](uint64 k2) { return Rotl(k2 * c2, 33) * c1; };
+
+  const size_t numBlocks = data.size() / 16;
+  uint64 h1 = 0;
+  uint64 h2 = 0;
+
+  for (size_t b = 0; b < numBlocks; b++) {
+    uint64 k[2];
+    memcpy(k, data.data() + b * 16, sizeof(k));
+    h1 ^= MixK1(k[0]);
+    h1 = (Rotl(h1, 27) + h2) * 5 + 0x52dce729;
+    h2 ^= MixK2(k[1]);
+    h2 = (Rotl(h2, 31) + h1) * 5 + 0x38495ab5;
+  }
+
+  auto tail = reinterpret_cast<const uint8 *>(data.data()) + numBlocks * 16;
+  const size_t restBytes = data.size() % 16;
+  uint64 k1 = 0;
+  uint64 k2 = 0;
+
+  for (size_t i = restBytes; i > 8; i--) {
+    k2 ^= uint64(tail[i - 1]) << ((i - 9) * 8);
+  }
+
+  for (size_t i = std::min(restBytes, size_t(8)); i > 0; i--) {
+    k1 ^= uint64(tail[i - 1]) << ((i - 1) * 8);
+  }
+
+  if (restBytes > 8) {
+    h2 ^= MixK2(k2);
+  }
+
+  if (restBytes) {
+    h1 ^= MixK1(k1);
+  }
+
+  h1 ^= data.size();
+  h2 ^= data.size();
+  h1 += h2;
+  h2 += h1;
+  h1 = FMix(h1);
+  h2 = FMix(h2);
+  h1 += h2;
+  h2 += h1;
+
+  return {h1, h2};
+}
+
+// Limits memory held by files in flight across worker threads
+// Single file over budget is still let through when nothing else is in flight
+static struct MemoryBudget {
+  std::mutex mtx;
+  std::condition_variable cv;
+  size_t used = 0;
+
+  void Acquire(size_t size) {
+    const size_t limit = size_t(settings.memoryBudget) << 20;
+    std::unique_lock<std::mutex> lk(mtx);
+    cv.wait(lk, [&] { return !used || used + size <= limit; });
+    used += size;
+  }
+
+  void Release(size_t size) {
+    {
+      std::lock_guard<std::mutex> lg(mtx);
+      used -= size;
+    }
+
+    cv.notify_all();
+  }
+} memoryBudget;
+
+struct BudgetReservation {
+  size_t size;
+
+  BudgetReservation(size_t size_) : size(size_) { memoryBudget.Acquire(size); }
+  ~BudgetReservation() { memoryBudget.Release(size); }
+};
+
+enum class Packing { Stored, Fast, Max };
+
+// Decides how to pack file without compressing all of it
+// Samples spread over file are compressed with fast and max level:
+//   Stored: max level sample ratio is clearly over threshold
+//   Fast: fast level output is within 1% of max level
+//   Max: otherwise
+// Decisions are learned per class, once all files of class end up with same
+// packing, it's used directly and only every 16th file is sampled again
+// Only sampled decisions are learned, small files are always packed with max
+// level and learned packing is not fed back
+static struct PackingPolicies {
+  static constexpr size_t sampleSize = 0x4000;
+  static constexpr size_t numSamples = 4;
+  static constexpr size_t minLearnedFiles = 8;
+  static constexpr size_t resampleInterval = 16;
+  // Stored decision needs sample ratio this much over threshold
+  static constexpr size_t storedMargin = 5;
+
+  struct ClassPolicy {
+    // Sampled files and their packing
+    size_t numFiles = 0;
+    size_t counts[3]{};
+    // Files that used learned packing
+    size_t numLearned = 0;
+  };
+
+  struct Choice {
+    Packing packing;
+    bool sampled = false;
+  };
+
+  std::mutex mtx;
+  std::map<uint32, ClassPolicy> classes;
+
+  std::optional<Packing> Learned(uint32 classHash) {
+    std::lock_guard<std::mutex> lg(mtx);
+    auto &policy = classes[classHash];
+
+    if (policy.numFiles < minLearnedFiles) {
+      return std::nullopt;
+    }
+
+    for (size_t p = 0; p < 3; p++) {
+      if (policy.counts[p] == policy.numFiles) {
+        if (++policy.numLearned % resampleInterval == 0) {
+          return std::nullopt;
+        }
+
+        return Packing(p);
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  void Learn(uint32 classHash, Packing packing) {
+    std::lock_guard<std::mutex> lg(mtx);
+    auto &policy = classes[classHash];
+    policy.numFiles++;
+    policy.counts[size_t(packing)]++;
+  }
+
+  Choice Choose(uint32 classHash, std::string_view data, int windowSize,
+                size_t ratioThreshold) {
+    // Trial would cost as much as compressing the whole file
+    if (data.size() <= sampleSize * numSamples * 2) {
+      return {Packing::Max};
+    }
+
+    if (auto learned = Learned(classHash)) {
+      return {*learned};
+    }
+
+    std::string sample;
+    sample.reserve(sampleSize * numSamples);
+    const size_t stride = (data.size() - sampleSize) / (numSamples - 1);
+
+    for (size_t s = 0; s < numSamples; s++) {
+      sample.append(data.substr(s * stride, sampleSize));
+    }
+
+    std::string outBuffer(sample.size() + 0x8000, 0);
+    const size_t maxSize =
+        revil::CompressZlib(sample, outBuffer, windowSize, 9);
+
+    if (maxSize * 100 > sample.size() * (ratioThreshold + storedMargin)) {
+      return {Packing::Stored, true};
+    }
+
+    const size_t fastSize =
+        revil::CompressZlib(sample, outBuffer, windowSize, 1);
+
+    return {fastSize * 100 <= maxSize * 101 ? Packing::Fast : Packing::Max,
+            true};
+  }
+} packingPolicies;
+
+struct AFile : ARCTableEntry {
+  Hash128 contentHash;
+  // Payload is stored by other entry with same contentHash
+  bool duplicate = false;
+};
+
+// Appends byte ranges of other files at the end of output file
+// Linux uses copy_file_range, data doesn't pass through userspace and
+// filesystems with reflink support can share extents instead of copying
+class RangeAppender {
+  std::string outPath;
+  // Copy buffer of fallback paths, too large for worker thread stacks
+  std::vector<char> buffer;
+#if defined(__linux__)
+  int outFd;
+
+public:
+  RangeAppender(const std::string &path)
+      : outPath(path), outFd(open(path.c_str(), O_WRONLY)) {
+    if (outFd < 0) {
+      throw es::FileInvalidAccessError(path);
+    }
+
+    lseek(outFd, 0, SEEK_END);
+  }
+
+  ~RangeAppender() { close(outFd); }
+
+  void Append(const std::string &path, size_t offset, size_t size) {
+    const int inFd = open(path.c_str(), O_RDONLY);
+
+    if (inFd < 0) {
+      throw es::FileInvalidAccessError(path);
+    }
+
+    off_t inOffset = offset;
+
+    while (size) {
+      const ssize_t copied =
+          copy_file_range(inFd, &inOffset, outFd, nullptr, size, 0);
+
+      if (copied <= 0) {
+        break; // cross device, unsupported filesystem, fallback
+      }
+
+      size -= copied;
+    }
+
+    buffer.resize(0x80000);
+
+    while (size) {
+      const ssize_t numRead =
+          pread(inFd, buffer.data(), std::min(size, buffer.size()), inOffset);
+
+      if (numRead <= 0 || write(outFd, buffer.data(), numRead) != numRead) {
+        close(inFd);
+        throw es::RuntimeError("Failed to copy data from " + path);
+      }
+
+      inOffset += numRead;
+      size -= numRead;
+    }
+
+    close(inFd);
+  }
+#else
+public:
+  RangeAppender(const std::string &path) : outPath(path) {}
+
+  void Append(const std::string &path, size_t offset, size_t size) {
+    std::ifstream in(path, std::ios::binary);
+    std::ofstream out(outPath, std::ios::binary | std::ios::app);
+
+    if (in.fail()) {
+      throw es::FileInvalidAccessError(path);
+    }
+
+    if (out.fail()) {
+      throw es::FileInvalidAccessError(outPath);
+    }
+
+    in.seekg(offset);
+    buffer.resize(0x80000);
+
+    while (size) {
+      const size_t chunk = std::min(size, buffer.size());
+
+      if (!in.read(buffer.data(), chunk) || !out.write(buffer.data(), chunk)) {
+        throw es::RuntimeError("Failed to copy data from " + path);
+      }
+
+      size -= chunk;
+    }
+  }
+#endif
 };
 
 struct Stream {
@@ -69,8 +376,80 @@ struct Stream {
 struct ArcMakeContext : AppPackContext {
   std::string outArc;
   std::map<std::thread::id, Stream> streams;
+  revil::TitleHandle title;
   const TitleSupport *ts;
   static inline std::atomic_uint32_t numFiles; // fugly
+  // Entries of updated archive, path is without extension, '/' separated
+  std::vector<AFile> baseFiles;
+  std::map<std::pair<std::string_view, uint32>, size_t> baseLookup;
+  // Payloads claimed by first entry that stores them
+  std::set<Hash128> payloads;
+
+  bool ClaimPayload(const Hash128 &contentHash) {
+    static std::mutex payloadsMutex;
+    std::lock_guard<std::mutex> lg(payloadsMutex);
+    return payloads.emplace(contentHash).second;
+  }
+
+  void LoadBase() {
+    if (settings.update == outArc) {
+      throw es::RuntimeError("Updated archive cannot be output archive.");
+    }
+
+    BinReader rd(settings.update);
+    uint32 id;
+    rd.Push();
+    rd.Read(id);
+    rd.Pop();
+
+    // Keep in sync with what Finish can write
+    if (id != ARCID) {
+      throw es::RuntimeError("Only little endian, unencrypted archives can be "
+                             "updated.");
+    }
+
+    for (auto &entry :
+         ReadARCEntries(rd, ts->arc.flags & revil::DbArc_ExtendedPath)) {
+      baseFiles.emplace_back(AFile{std::move(entry)});
+    }
+
+    for (size_t i = 0; i < baseFiles.size(); i++) {
+      baseLookup.emplace(std::make_pair(std::string_view(baseFiles[i].path),
+                                        baseFiles[i].hash),
+                         i);
+    }
+  }
+
+  // Compares input with decompressed data of updated archive entry
+  bool IsUnchanged(std::istream &stream, size_t streamSize,
+                   const AFile &base) {
+    if (base.uSize != streamSize) {
+      return false;
+    }
+
+    std::string input(streamSize, 0);
+    stream.read(input.data(), streamSize);
+    stream.seekg(0);
+
+    BinReader_t<BinCoreOpenMode::NoBuffer> rd(settings.update);
+    std::string stored(base.cSize, 0);
+    rd.Seek(base.offset);
+    rd.ReadBuffer(stored.data(), base.cSize);
+
+    if (base.cSize == base.uSize) {
+      return stored == input;
+    }
+
+    std::string original(std::max(size_t(base.uSize), size_t(0x8000)), 0);
+
+    try {
+      const size_t uSize = revil::DecompressZlib(stored, original);
+      return uSize == streamSize &&
+             !memcmp(original.data(), input.data(), streamSize);
+    } catch (const std::exception &) {
+      return false;
+    }
+  }
 
   Stream &NewStream() {
     static std::mutex streamsMutex;
@@ -88,7 +467,12 @@ struct ArcMakeContext : AppPackContext {
   ArcMakeContext() = default;
   ArcMakeContext(const std::string &path)
       : outArc(path),
-        ts(revil::GetTitleSupport(settings.title, settings.platform)) {}
+        title(revil::ResolveTitle(settings.title, settings.platform)),
+        ts(revil::GetTitleSupport(settings.title, settings.platform)) {
+    if (!settings.update.empty()) {
+      LoadBase();
+    }
+  }
   ArcMakeContext &operator=(ArcMakeContext &&) = default;
 
   void SendFile(std::string_view path, std::istream &stream) override {
@@ -100,7 +484,7 @@ struct ArcMakeContext : AppPackContext {
     }
 
     auto extension = path.substr(extPos + 1);
-    auto hashes = GetHash(extension, settings.title, settings.platform);
+    auto hashes = GetHash(extension, title);
 
     if (hashes.empty()) {
       printwarning("Skipped (invalid format): " << path);
@@ -111,8 +495,7 @@ struct ArcMakeContext : AppPackContext {
 
     if (hashes.size() > 1) {
       for (auto &h : hashes) {
-        if (revil::GetExtension(h, settings.title, settings.platform) ==
-            extension) {
+        if (revil::GetExtension(h, title) == extension) {
           if (hash) {
             printwarning("Skipped (multiple classes from extension): " << path);
             return;
@@ -134,21 +517,42 @@ struct ArcMakeContext : AppPackContext {
       return;
     }
 
+    stream.seekg(0, std::ios::end);
+    const size_t streamSize = stream.tellg();
+    stream.seekg(0);
+    const size_t verbosityLevel = appInfo.internalSettings->verbosity;
+    // Input, output and decompressed original for updates
+    BudgetReservation reservation(streamSize * 3 + 0x10000);
+    size_t baseIndex = -1;
+
+    if (!baseFiles.empty()) {
+      auto found = baseLookup.find(std::make_pair(noExt, hash));
+
+      if (!es::IsEnd(baseLookup, found)) {
+        baseIndex = found->second;
+
+        if (IsUnchanged(stream, streamSize, baseFiles[baseIndex])) {
+          if (verbosityLevel) {
+            printline("Unchanged: " << path);
+          }
+
+          return;
+        }
+      }
+    }
+
     numFiles++;
 
     if (numFiles > std::numeric_limits<decltype(ARC::numFiles)>::max()) {
       throw es::RuntimeError("Filecount exceeded archive limit.");
     }
 
-    stream.seekg(0, std::ios::end);
-    const size_t streamSize = stream.tellg();
-    stream.seekg(0);
-
     std::string buffer;
     std::string outBuffer;
 
     auto CompressData = [&](auto &&buffer, int cType) {
-      outBuffer.resize(std::max(buffer.size() + 0x10, size_t(0x8000)));
+      outBuffer.resize(
+          std::max(buffer.size() + buffer.size() / 100 + 0x40, size_t(0x8000)));
       return revil::CompressZlib(buffer, outBuffer, ts->arc.windowSize, cType);
     };
 
@@ -167,6 +571,7 @@ struct ArcMakeContext : AppPackContext {
     curFile.hash = hash;
     curFile.uSize = streamSize;
     curFile.path = noExt;
+    curFile.baseIndex = baseIndex;
 
     bool processed = false;
     size_t compressedSize = streamSize;
@@ -174,7 +579,6 @@ struct ArcMakeContext : AppPackContext {
         appInfo.internalSettings->compressSettings.minFileSize;
     const size_t ratioThreshold =
         appInfo.internalSettings->compressSettings.ratioThreshold;
-    const size_t verbosityLevel = appInfo.internalSettings->verbosity;
 
     if (streamSize > minFileSize || settings.forceZLIBHeader) {
       buffer.resize(streamSize);
@@ -185,13 +589,40 @@ struct ArcMakeContext : AppPackContext {
       processed = true;
     }
 
+    curFile.contentHash =
+        HashContent(processed ? std::string_view(outBuffer) : buffer);
+
+    if (!ClaimPayload(curFile.contentHash)) {
+      if (verbosityLevel) {
+        printline("Duplicate: " << path);
+      }
+
+      curFile.duplicate = true;
+      tStream->files.emplace_back(std::move(curFile));
+      return;
+    }
+
     if (!processed && streamSize > minFileSize) {
-      compressedSize = CompressData(buffer, 9);
+      const auto choice = packingPolicies.Choose(
+          hash, buffer, ts->arc.windowSize, ratioThreshold);
+      const Packing packing = choice.packing;
 
-      uint32 ratio = ((float)compressedSize / (float)streamSize) * 100;
+      if (packing == Packing::Stored) {
+        if (verbosityLevel) {
+          printline("Sampled ratio fail for " << path);
+        }
+      } else {
+        compressedSize = CompressData(buffer, packing == Packing::Max ? 9 : 1);
 
-      if (ratio <= ratioThreshold) {
-        processed = true;
+        uint32 ratio = ((float)compressedSize / (float)streamSize) * 100;
+
+        if (ratio <= ratioThreshold) {
+          processed = true;
+        }
+      }
+
+      if (choice.sampled) {
+        packingPolicies.Learn(hash, processed ? packing : Packing::Stored);
       }
     }
 
@@ -220,79 +651,77 @@ struct ArcMakeContext : AppPackContext {
   }
 
   void Finish() override {
-    BinWritter wr(outArc);
-    ARCBase arc;
-    arc.numFiles = numFiles;
-    arc.version = ts->arc.version;
-
-    if (arc.version < 10 || (ts->arc.flags & revil::DbArc_XMemCompress)) {
-      wr.Write(arc);
-    } else {
-      ARC arcEx{arc};
-      wr.Write(arcEx);
-    }
-
-    const size_t dataOffset =
-        wr.Tell() + arc.numFiles * ((ts->arc.flags & revil::DbArc_ExtendedPath)
-                                        ? sizeof(ARCExtendedFile)
-                                        : sizeof(ARCFile));
-
     std::vector<AFile> files;
-    size_t curOffset = dataOffset;
+    size_t streamsSize = 0;
 
     for (auto &[_, stream] : streams) {
-      auto &tFiles = stream.files;
-      std::transform(tFiles.begin(), tFiles.end(), std::back_inserter(files),
-                     [&](auto &&item) {
-                       item.offset += curOffset;
+      const size_t streamSize = stream.streamStore.Tell();
+      es::Dispose(stream.streamStore);
+      std::transform(stream.files.begin(), stream.files.end(),
+                     std::back_inserter(files), [&](auto &&item) {
+                       item.offset += streamsSize;
                        return std::move(item);
                      });
-      curOffset = tFiles.back().cSize + tFiles.back().offset;
+      streamsSize += streamSize;
     }
 
-    auto WriteFile = [&](auto cFile, auto &f) {
-      cFile.offset = f.offset;
-      cFile.typeHash = f.hash;
-      memcpy(cFile.fileName, f.path.data(), f.path.size());
-      cFile.uncompressedSize = f.uSize;
-      cFile.compressedSize = f.cSize;
+    // Offsets are relative to streams until merged into table
+    std::map<Hash128, const AFile *> storedPayloads;
 
-      if (settings.platform == Platform::Win32) {
-        std::replace(std::begin(cFile.fileName), std::end(cFile.fileName), '/',
-                     '\\');
+    for (auto &f : files) {
+      if (!f.duplicate) {
+        storedPayloads.emplace(f.contentHash, &f);
       }
+    }
 
-      wr.Write(cFile);
-    };
-
-    if (ts->arc.flags & revil::DbArc_ExtendedPath) {
-      for (auto &f : files) {
-        WriteFile(ARCExtendedFile{}, f);
-      }
-    } else {
-      for (auto &f : files) {
-        WriteFile(ARCFile{}, f);
+    for (auto &f : files) {
+      if (f.duplicate) {
+        const AFile *stored = storedPayloads.at(f.contentHash);
+        f.offset = stored->offset;
+        f.cSize = stored->cSize;
       }
     }
 
-    for (auto &[_, stream] : streams) {
-      es::Dispose(stream.streamStore);
-      BinReader_t<BinCoreOpenMode::NoBuffer> rd(stream.streamPath);
-      const size_t fSize = rd.GetSize();
-      char buffer[0x80000];
-      const size_t numBlocks = fSize / sizeof(buffer);
-      const size_t restBytes = fSize % sizeof(buffer);
-
-      for (size_t b = 0; b < numBlocks; b++) {
-        rd.Read(buffer);
-        wr.Write(buffer);
+    ARCBase arc;
+    arc.version = ts->arc.version;
+    const bool extendedPath = ts->arc.flags & revil::DbArc_ExtendedPath;
+    const bool arcBase =
+        arc.version < 10 || (ts->arc.flags & revil::DbArc_XMemCompress);
+
+    // Unchanged entries of updated archive, their data is copied in
+    // contiguous runs, gaps between entries are dropped
+    std::vector<AFile> table(baseFiles);
+    const std::vector<ARCRun> runs = MergeARCTable(
+        table, std::move(files), arcBase ? sizeof(ARCBase) : sizeof(ARC),
+        extendedPath ? sizeof(ARCExtendedFile) : sizeof(ARCFile));
+    arc.numFiles = table.size();
+
+    {
+      BinWritter wr(outArc);
+
+      if (arcBase) {
+        wr.Write(arc);
+      } else {
+        ARC arcEx{arc};
+        wr.Write(arcEx);
       }
 
-      if (restBytes) {
-        rd.ReadBuffer(buffer, restBytes);
-        wr.WriteBuffer(buffer, restBytes);
+      for (auto &f : table) {
+        WriteARCEntry(wr, f, extendedPath,
+                      settings.platform == Platform::Win32);
       }
+    }
 
+    RangeAppender appender(outArc);
+
+    for (auto &r : runs) {
+      appender.Append(settings.update, r.begin, r.end - r.begin);
+    }
+
+    for (auto &[_, stream] : streams) {
+      BinReader_t<BinCoreOpenMode::NoBuffer> rd(stream.streamPath);
+      appender.Append(stream.streamPath, 0, rd.GetSize());
+      es::Dispose(rd);
       es::RemoveFile(stream.streamPath);
     }
   }
@@ -16,13 +16,13 @@
 */
 
 #include "project.h"
+#include "revil/container.hpp"
+#include "revil/sngw.hpp"
+#include "revil/trace.hpp"
 #include "spike/app_context.hpp"
 #include "spike/except.hpp"
-#include "spike/io/binreader_stream.hpp"
 #include "spike/io/binwritter_stream.hpp"
 #include "spike/reflect/reflector.hpp"
-#include "spike/type/vectors_simd.hpp"
-#include <vector>
 
 std::string_view filters[]{
     ".sngw$",
@@ -46,66 +46,25 @@ static AppInfo_s appInfo{
 
 AppInfo_s *AppInitModule() { return &appInfo; }
 
-constexpr uint32 SNGWID = CompileFourCC("OggS");
-const UIVector4A16 KEY = 0x64958637;
-const UIVector4A16 LMASK = 0x0f0f0f0f;
-const UIVector4A16 RMASK = ~LMASK;
-
-UIVector4A16 Decrypt(UIVector4A16 input) {
-  const auto ldata = _mm_slli_epi64(_mm_and_si128(input._data, LMASK._data), 4);
-  const auto rdata = _mm_srli_epi64(_mm_and_si128(input._data, RMASK._data), 4);
-
-  return _mm_xor_si128(_mm_or_si128(ldata, rdata), KEY._data);
-}
-
-UIVector4A16 Encrypt(UIVector4A16 input) {
-  input._data = _mm_xor_si128(input._data, KEY._data);
-  const auto ldata = _mm_slli_epi64(_mm_and_si128(input._data, LMASK._data), 4);
-  const auto rdata = _mm_srli_epi64(_mm_and_si128(input._data, RMASK._data), 4);
-
-  return _mm_or_si128(ldata, rdata);
-}
-
 void AppProcessFile(AppContext *ctx) {
-  BinReaderRef rd(ctx->GetStream());
-  uint32 id;
-  rd.Read(id);
-  const size_t fileSize = rd.GetSize();
-  const size_t numChunks = fileSize / sizeof(UIVector4A16);
-  const size_t numRest = fileSize % sizeof(UIVector4A16);
-  const size_t numItems = numChunks + (numRest ? 1 : 0);
-  std::vector<UIVector4A16> store;
+  revil::TraceZone zone("app.ddon_sngw");
+  revil::ContainerSource source(ctx);
 
-  if (id == SNGWID && settings.encrypt) {
-    rd.ReadContainer(store, numItems);
-    memset(reinterpret_cast<void *>(store.data()), 0, sizeof(SNGWID));
-
-    for (size_t i = 0; i < numItems; i++) {
-      store[i] = Encrypt(store[i]);
-    }
-
-    BinWritterRef wr(
-        ctx->NewFile(ctx->workingFile.ChangeExtension(".enc")).str);
-    wr.WriteBuffer(reinterpret_cast<const char *>(store.data()), fileSize);
-  } else if (!settings.encrypt) {
-    UIVector4A16 sample;
-    rd.Read(sample);
-    rd.Seek(0);
-    sample = Decrypt(sample);
-
-    if (sample.X) {
-      throw es::RuntimeError("Decryption error!");
+  if (!revil::IsSNGWFile(source.data, !settings.encrypt)) {
+    if (settings.encrypt) {
+      return;
     }
 
-    rd.ReadContainer(store, numItems);
+    throw es::RuntimeError("Decryption error!");
+  }
 
-    for (size_t i = 0; i < numItems; i++) {
-      store[i] = Decrypt(store[i]);
-    }
+  const char *extension = settings.encrypt ? ".enc" : ".dec";
+  BinWritterRef wr(
+      ctx->NewFile(ctx->workingFile.ChangeExtension(extension)).str);
 
-    memcpy(reinterpret_cast<void *>(store.data()), &SNGWID, sizeof(SNGWID));
-    BinWritterRef wr(
-        ctx->NewFile(ctx->workingFile.ChangeExtension(".dec")).str);
-    wr.WriteBuffer(reinterpret_cast<const char *>(store.data()), fileSize);
+  if (settings.encrypt) {
+    revil::EncryptSNGWFile(source.data, wr);
+  } else {
+    revil::DecryptSNGWFile(source.data, wr);
   }
 }
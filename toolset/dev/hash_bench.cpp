@@ -0,0 +1,145 @@
+/*  HashBench
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "arc.hpp"
+#include "project.h"
+#include "re_common.hpp"
+#include "revil/hashreg.hpp"
+#include "spike/master_printer.hpp"
+#include <chrono>
+#include <cstring>
+#include <mutex>
+
+static struct HashBench : ReflectorBase<HashBench> {
+  bool extendedPath = false;
+  uint32 numRounds = 20;
+} settings;
+
+REFLECT(CLASS(HashBench),
+        MEMBER(extendedPath, "e",
+               ReflDesc{"Archives use extended (128 chars) file paths."}),
+        MEMBER(numRounds, "r",
+               ReflDesc{"Number of hashing rounds over collected paths."}));
+
+std::string_view filters[]{
+    ".arc$",
+};
+
+static AppInfo_s appInfo{
+    .filteredLoad = true,
+    .header = HashBench_DESC " v" HashBench_VERSION ", " HashBench_COPYRIGHT
+                             "Lukas Cone",
+    .settings = reinterpret_cast<ReflectorFriend *>(&settings),
+    .filters = filters,
+};
+
+AppInfo_s *AppInitModule() { return &appInfo; }
+
+static std::vector<std::string> PATHS;
+static std::mutex pathsMutex;
+
+void AppProcessFile(AppContext *ctx) {
+  uint32 id;
+  ctx->GetType(id);
+
+  if (id == ARCCID) {
+    printwarning("Skipped encrypted archive: "
+                 << ctx->workingFile.GetFullPath());
+    return;
+  }
+
+  BinReaderRef_e rd(ctx->GetStream());
+  std::vector<std::string> paths;
+
+  auto AddPaths = [&](const auto &files) {
+    for (auto &f : files) {
+      paths.emplace_back(f.fileName, strnlen(f.fileName, sizeof(f.fileName)));
+    }
+  };
+
+  if (settings.extendedPath) {
+    AddPaths(std::get<1>(ReadExtendedARC(rd)));
+  } else {
+    AddPaths(std::get<1>(ReadARC(rd)));
+  }
+
+  std::lock_guard<std::mutex> lg(pathsMutex);
+  std::move(paths.begin(), paths.end(), std::back_inserter(PATHS));
+}
+
+void AppFinishContext() {
+  if (PATHS.empty()) {
+    printwarning("No paths collected.");
+    return;
+  }
+
+  std::vector<std::string_view> views(PATHS.begin(), PATHS.end());
+  std::vector<uint32> hashes(views.size());
+  size_t totalSize = 0;
+  size_t histogram[9]{};
+
+  for (auto v : views) {
+    totalSize += v.size();
+    histogram[std::min<size_t>(v.size() / 16, 8)]++;
+  }
+
+  printline("Collected " << views.size() << " paths, "
+                         << totalSize / views.size() << " chars on average");
+
+  for (size_t i = 0; i < 8; i++) {
+    printline("  " << i * 16 << "-" << i * 16 + 15 << ": " << histogram[i]);
+  }
+
+  printline("  128+: " << histogram[8]);
+
+  uint32 sink = 0;
+
+  auto Measure = [&](std::string_view name, auto &&fn) {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32 r = 0; r < settings.numRounds; r++) {
+      fn();
+      sink ^= hashes.front();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    const double numItems = double(views.size()) * settings.numRounds;
+    const double numBytes = double(totalSize) * settings.numRounds;
+
+    printline(name << ": " << elapsed.count() / numItems << " ns/path, "
+                   << numBytes / elapsed.count() * 1000 << " MB/s");
+  };
+
+  Measure("MTHashV1", [&] {
+    for (size_t i = 0; i < views.size(); i++) {
+      hashes[i] = revil::MTHashV1(views[i]);
+    }
+  });
+
+  Measure("MTHashV1 batch", [&] { revil::MTHashV1(views, hashes); });
+
+  Measure("MTHashV2", [&] {
+    for (size_t i = 0; i < views.size(); i++) {
+      hashes[i] = revil::MTHashV2(views[i]);
+    }
+  });
+
+  Measure("MTHashV2 batch", [&] { revil::MTHashV2(views, hashes); });
+
+  printline("Checksum: " << std::hex << sink);
+}
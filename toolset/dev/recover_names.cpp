@@ -0,0 +1,383 @@
+/*  RecoverNames
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "parallel.hpp"
+#include "project.h"
+#include "re_common.hpp"
+#include "revil/hashreg.hpp"
+#include "spike/crypto/crc32.hpp"
+#include "spike/except.hpp"
+#include "spike/io/binwritter.hpp"
+#include "spike/master_printer.hpp"
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+
+MAKE_ENUM(ENUMSCOPE(class HashType : uint8, HashType), EMEMBER(MTHashV1),
+          EMEMBER(MTHashV2), EMEMBER(CRC32));
+
+static struct RecoverNames : ReflectorBase<RecoverNames> {
+  std::string targets;
+  std::string templates;
+  HashType hashType = HashType::MTHashV2;
+  std::string output = "recovered.files";
+} settings;
+
+REFLECT(CLASS(RecoverNames),
+        MEMBER(targets, "t",
+               ReflDesc{"File with target hashes. First hexadecimal token of "
+                        "every line is used (validate_arcs output works)."}),
+        MEMBER(templates, "p",
+               ReflDesc{"Semicolon separated name templates. %w expands to "
+                        "every word from input wordlists, %0Nd to every N "
+                        "digit number, %% is literal %."}),
+        MEMBERNAME(hashType, "hash-type", "H",
+                   ReflDesc{"MTHashV1/MTHashV2 for ARC classes, CRC32 for OBB "
+                            "file names."}),
+        MEMBER(output, "o",
+               ReflDesc{"Output dictionary, one recovered name per line."}));
+
+std::string_view filters[]{
+    ".txt$",
+};
+
+static AppInfo_s appInfo{
+    .filteredLoad = true,
+    .header = RecoverNames_DESC " v" RecoverNames_VERSION
+                                ", " RecoverNames_COPYRIGHT "Lukas Cone",
+    .settings = reinterpret_cast<ReflectorFriend *>(&settings),
+    .filters = filters,
+};
+
+AppInfo_s *AppInitModule() { return &appInfo; }
+
+static std::vector<std::string> WORDS;
+static std::mutex wordsMutex;
+
+// Input files are wordlists, one word per line
+void AppProcessFile(AppContext *ctx) {
+  std::istream &str = ctx->GetStream();
+  std::vector<std::string> words;
+  std::string line;
+
+  while (std::getline(str, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+
+    if (!line.empty()) {
+      words.emplace_back(std::move(line));
+    }
+  }
+
+  std::lock_guard<std::mutex> lg(wordsMutex);
+  std::move(words.begin(), words.end(), std::back_inserter(WORDS));
+}
+
+// Sorted hashes behind a bloom filter, most candidates miss
+struct TargetSet {
+  std::vector<uint32> hashes;
+  std::vector<uint64> bloom;
+  uint32 bloomShift = 32;
+
+  void Build() {
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+    // ~16 bits per target, 2 probes
+    uint32 numBits = 1 << 10;
+    bloomShift = 22;
+
+    while (numBits < hashes.size() * 16 && bloomShift > 6) {
+      numBits <<= 1;
+      bloomShift--;
+    }
+
+    bloom.assign(numBits / 64, 0);
+
+    for (uint32 h : hashes) {
+      for (uint32 b : Probes(h)) {
+        bloom[b / 64] |= uint64(1) << (b % 64);
+      }
+    }
+  }
+
+  std::array<uint32, 2> Probes(uint32 hash) const {
+    return {(hash * 0x9E3779B1) >> bloomShift,
+            (hash * 0x85EBCA77) >> bloomShift};
+  }
+
+  bool Contains(uint32 hash) const {
+    for (uint32 b : Probes(hash)) {
+      if (!(bloom[b / 64] & (uint64(1) << (b % 64)))) {
+        return false;
+      }
+    }
+
+    return std::binary_search(hashes.begin(), hashes.end(), hash);
+  }
+};
+
+struct TemplateSlot {
+  std::string prefix;
+  // zero for word slot
+  uint32 width;
+};
+
+struct NameTemplate {
+  std::vector<TemplateSlot> slots;
+  std::string suffix;
+  std::vector<uint64> radices;
+  uint64 numNames = 1;
+};
+
+NameTemplate ParseTemplate(std::string_view pattern, size_t numWords) {
+  NameTemplate retVal;
+  std::string literal;
+
+  for (size_t i = 0; i < pattern.size(); i++) {
+    if (pattern[i] != '%') {
+      literal.push_back(pattern[i]);
+      continue;
+    }
+
+    if (++i == pattern.size()) {
+      throw es::RuntimeError("Unterminated % in template: " +
+                             std::string(pattern));
+    }
+
+    uint64 radix = numWords;
+    uint32 width = 0;
+
+    if (pattern[i] == '%') {
+      literal.push_back('%');
+      continue;
+    } else if (pattern[i] != 'w') {
+      auto [next, ec] =
+          std::from_chars(pattern.data() + i, pattern.data() + pattern.size(),
+                          width);
+
+      if (ec != std::errc{} || next == pattern.data() + pattern.size() ||
+          *next != 'd' || width == 0 || width > 9) {
+        throw es::RuntimeError("Invalid template slot: " +
+                               std::string(pattern));
+      }
+
+      i = next - pattern.data();
+      radix = 1;
+
+      for (uint32 w = 0; w < width; w++) {
+        radix *= 10;
+      }
+    }
+
+    if (radix && retVal.numNames > (uint64(1) << 48) / radix) {
+      throw es::RuntimeError("Template expands to too many names: " +
+                             std::string(pattern));
+    }
+
+    retVal.slots.emplace_back(TemplateSlot{std::move(literal), width});
+    retVal.radices.emplace_back(radix);
+    retVal.numNames *= radix;
+    literal.clear();
+  }
+
+  retVal.suffix = std::move(literal);
+
+  return retVal;
+}
+
+void AppendNumber(std::string &out, uint64 value, uint32 width) {
+  char buffer[0x20];
+  auto [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+  const size_t numDigits = end - buffer;
+
+  if (numDigits < width) {
+    out.append(width - numDigits, '0');
+  }
+
+  out.append(buffer, numDigits);
+}
+
+void AppFinishContext() {
+  TargetSet targets;
+  // CRC32 is matched by MTHashV2 batches (masked CRC), then verified
+  std::vector<uint32> fullTargets;
+
+  {
+    std::ifstream str(settings.targets);
+
+    if (str.fail()) {
+      printerror("Cannot open targets file: " << settings.targets);
+      return;
+    }
+
+    std::string line;
+
+    while (std::getline(str, line)) {
+      std::string_view sv(es::TrimWhitespace(std::string_view(line)));
+
+      if (sv.starts_with("0x") || sv.starts_with("0X")) {
+        sv.remove_prefix(2);
+      }
+
+      uint32 hash;
+      auto [next, ec] =
+          std::from_chars(sv.data(), sv.data() + sv.size(), hash, 16);
+
+      if (ec == std::errc{}) {
+        fullTargets.emplace_back(hash);
+        targets.hashes.emplace_back(hash & 0x7FFFFFFF);
+      }
+    }
+  }
+
+  if (targets.hashes.empty()) {
+    printerror("No target hashes loaded.");
+    return;
+  }
+
+  targets.Build();
+  std::sort(fullTargets.begin(), fullTargets.end());
+  printline("Loaded " << targets.hashes.size() << " targets, "
+                      << WORDS.size() << " words");
+
+  std::map<uint32, std::set<std::string>> results;
+  std::mutex resultsMutex;
+  std::string_view templates(settings.templates);
+
+  while (!templates.empty()) {
+    const size_t found = templates.find(';');
+    std::string_view pattern(es::TrimWhitespace(templates.substr(0, found)));
+    templates.remove_prefix(found == templates.npos ? templates.size()
+                                                    : found + 1);
+
+    if (pattern.empty()) {
+      continue;
+    }
+
+    NameTemplate tmpl;
+
+    try {
+      tmpl = ParseTemplate(pattern, WORDS.size());
+    } catch (const std::exception &e) {
+      printerror(e.what());
+      continue;
+    }
+
+    printline("Template " << pattern << ": " << tmpl.numNames << " names");
+
+    static constexpr size_t BATCH_SIZE = 0x1000;
+    const size_t numBatches = (tmpl.numNames + BATCH_SIZE - 1) / BATCH_SIZE;
+
+    revil::ParallelFor(numBatches, [&](size_t batch) {
+      thread_local std::vector<std::string> names;
+      thread_local std::vector<std::string_view> views;
+      thread_local std::vector<uint32> hashes;
+      const uint64 begin = batch * BATCH_SIZE;
+      const size_t numNames =
+          std::min<uint64>(BATCH_SIZE, tmpl.numNames - begin);
+      const size_t numSlots = tmpl.slots.size();
+
+      names.resize(numNames);
+      views.resize(numNames);
+      hashes.resize(numNames);
+
+      // Mixed radix counter, last slot changes fastest
+      std::vector<uint64> digits(numSlots);
+      uint64 index = begin;
+
+      for (size_t s = numSlots; s-- > 0;) {
+        digits[s] = index % tmpl.radices[s];
+        index /= tmpl.radices[s];
+      }
+
+      for (size_t n = 0; n < numNames; n++) {
+        std::string &name = names[n];
+        name.clear();
+
+        for (size_t s = 0; s < numSlots; s++) {
+          auto &slot = tmpl.slots[s];
+          name.append(slot.prefix);
+
+          if (slot.width) {
+            AppendNumber(name, digits[s], slot.width);
+          } else {
+            name.append(WORDS[digits[s]]);
+          }
+        }
+
+        name.append(tmpl.suffix);
+        views[n] = name;
+
+        for (size_t s = numSlots; s-- > 0;) {
+          if (++digits[s] < tmpl.radices[s]) {
+            break;
+          }
+
+          digits[s] = 0;
+        }
+      }
+
+      if (settings.hashType == HashType::MTHashV1) {
+        revil::MTHashV1(views, hashes);
+      } else {
+        revil::MTHashV2(views, hashes);
+      }
+
+      for (size_t n = 0; n < numNames; n++) {
+        uint32 hash = hashes[n];
+
+        if (!targets.Contains(hash)) {
+          continue;
+        }
+
+        if (settings.hashType == HashType::CRC32) {
+          hash = ~crc32b(0, views[n].data(), views[n].size());
+
+          if (!std::binary_search(fullTargets.begin(), fullTargets.end(),
+                                  hash)) {
+            continue;
+          }
+        }
+
+        std::lock_guard<std::mutex> lg(resultsMutex);
+        results[hash].emplace(views[n]);
+      }
+    });
+  }
+
+  BinWritter wr(settings.output);
+  auto &str = wr.BaseStream();
+  size_t numCollisions = 0;
+
+  for (auto &[hash, names] : results) {
+    numCollisions += names.size() > 1;
+
+    for (auto &name : names) {
+      printline("0x" << std::hex << std::uppercase << hash << " " << name);
+      str << name << '\n';
+    }
+  }
+
+  printline("Recovered " << std::dec << results.size() << " of "
+                         << targets.hashes.size() << " hashes, "
+                         << numCollisions << " with multiple names");
+}
@@ -93,17 +93,19 @@ void AppProcessFile(AppContext *ctx) {
   std::map<uint32, std::string> missingHashes;
   std::set<uint32> usedHashes;
 
+  const revil::TitleHandle title =
+      revil::ResolveTitle(settings.title, settings.platform);
+
   auto WriteFiles = [&](auto &files) {
     for (auto &f : files) {
-      auto ext =
-          revil::GetExtension(f.typeHash, settings.title, settings.platform);
+      auto ext = revil::GetExtension(f.typeHash, title);
 
       if (ext.empty()) {
         if (!newHashes.count(f.typeHash) && !::newHashes.count(f.typeHash)) {
           newHashes[f.typeHash] = f.fileName;
         }
       } else {
-        auto retHash = revil::GetHash(ext, settings.title, settings.platform);
+        auto retHash = revil::GetHash(ext, title);
 
         if (retHash.empty()) {
           if (!missingHashes.count(f.typeHash) &&
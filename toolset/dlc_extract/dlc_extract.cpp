@@ -17,6 +17,8 @@
 
 #include "hfs.hpp"
 #include "project.h"
+#include "revil/container.hpp"
+#include "revil/trace.hpp"
 #include "spike/app_context.hpp"
 #include "spike/except.hpp"
 #include "spike/io/binreader_stream.hpp"
@@ -36,13 +38,15 @@ static AppInfo_s appInfo{
 AppInfo_s *AppInitModule() { return &appInfo; }
 
 void AppProcessFile(AppContext *ctx) {
+  revil::TraceZone zone("app.dlc_extract");
   std::stringstream backup;
   BinReaderRef_e rd(ctx->GetStream());
   uint32 id;
   rd.Push();
   rd.Read(id);
+  const bool isHFS = id == SFHID;
 
-  if (id == SFHID) {
+  if (isHFS) {
     rd.Pop();
     backup = ProcessHFS(rd);
     rd = BinReaderRef_e(backup);
@@ -80,28 +84,21 @@ void AppProcessFile(AppContext *ctx) {
     rd.Read(file.offset);
   });
 
-  auto ectx = ctx->ExtractContext();
-
-  if (ectx->RequiresFolders()) {
-    for (auto &f : files) {
-      AFileInfo finf(f.path);
-      ectx->AddFolderPath(std::string(finf.GetFolder()));
-    }
-
-    ectx->GenerateFolders();
-  }
-
-  std::string buffer;
-  const size_t arSize = rd.GetSize();
+  revil::ContainerSource source =
+      isHFS ? revil::ContainerSource(std::move(backup).str())
+            : revil::ContainerSource(ctx);
+  std::vector<revil::ContainerEntry> entries;
+  const size_t arSize = source.data.size();
 
   for (size_t curFile = 1; auto &f : files) {
-    rd.Seek(f.offset);
     const size_t fileEnd =
         curFile >= files.size() ? arSize : files.at(curFile).offset;
-    const size_t fileSize = fileEnd - f.offset;
-    rd.ReadContainer(buffer, fileSize);
-    ectx->NewFile(f.path);
-    ectx->SendData(buffer);
+    revil::ContainerEntry &entry = entries.emplace_back();
+    entry.path = std::move(f.path);
+    entry.offset = f.offset;
+    entry.size = fileEnd - f.offset;
     curFile++;
   }
+
+  revil::ExtractContainer(source.data, entries, ctx->ExtractContext());
 }
@@ -16,6 +16,8 @@
 */
 
 #include "project.h"
+#include "revil/container.hpp"
+#include "revil/trace.hpp"
 #include "spike/app_context.hpp"
 #include "spike/except.hpp"
 #include "spike/io/binreader_stream.hpp"
@@ -51,6 +53,7 @@ struct FPKFile {
 };
 
 void AppProcessFile(AppContext *ctx) {
+  revil::TraceZone zone("app.fpk_extract");
   BinReaderRef rd(ctx->GetStream());
   FPKHeader hdr;
   rd.Read(hdr);
@@ -66,33 +69,20 @@ void AppProcessFile(AppContext *ctx) {
   std::vector<FPKFile> files;
   rd.ReadContainer(files, hdr.numFiles);
 
-  auto ectx = ctx->ExtractContext();
-
-  if (ectx->RequiresFolders()) {
-    for (auto &f : files) {
-      const char *fileName = f.path;
-      while (*fileName == '/') {
-        fileName++;
-      }
-
-      AFileInfo finf(fileName);
-
-      ectx->AddFolderPath(std::string(finf.GetFolder()));
-    }
-
-    ectx->GenerateFolders();
-  }
-
-  std::string buffer;
+  revil::ContainerSource source(ctx);
+  std::vector<revil::ContainerEntry> entries;
 
   for (auto &f : files) {
-    rd.Seek(f.offset);
-    rd.ReadContainer(buffer, f.size0);
     const char *fileName = f.path;
     while (*fileName == '/') {
       fileName++;
     }
-    ectx->NewFile(fileName);
-    ectx->SendData(buffer);
+
+    revil::ContainerEntry &entry = entries.emplace_back();
+    entry.path = fileName;
+    entry.offset = f.offset;
+    entry.size = f.size0;
   }
+
+  revil::ExtractContainer(source.data, entries, ctx->ExtractContext());
 }
@@ -17,6 +17,7 @@
 
 #pragma once
 #include "revil/platform.hpp"
+#include "revil/trace.hpp"
 #include "spike/app_context.hpp"
 #include "spike/reflect/reflector.hpp"
 
@@ -533,6 +533,7 @@ void DoLmt(LMTGLTF &main, LMT &lmt, std::string name, ReportType &report) {
 }
 
 void AppProcessFile(AppContext *ctx) {
+  TraceZone zone("app.lmt_to_gltf");
   LMTGLTF main(gltf::LoadFromBinary(ctx->GetStream(), ""));
 
   auto &lmts = ctx->SupplementalFiles();
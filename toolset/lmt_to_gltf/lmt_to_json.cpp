@@ -37,6 +37,7 @@ static AppInfo_s appInfo{
 AppInfo_s *AppInitModule() { return &appInfo; }
 
 void AppProcessFile(AppContext *ctx) {
+  TraceZone zone("app.lmt_to_json");
   LMT lmt;
   lmt.Load(ctx->GetStream());
   uni::MotionsConst motion = lmt;
@@ -340,6 +340,7 @@ void MODGLTF::Pipeline(const revil::MOD &model) {
 }
 
 void AppProcessFile(AppContext *ctx) {
+  TraceZone zone("app.mod_to_gltf");
   revil::MOD mod;
   mod.Load(ctx->GetStream());
   MODGLTF main;
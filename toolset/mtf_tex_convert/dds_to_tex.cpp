@@ -0,0 +1,220 @@
+/*  MTFTEXConvert
+    Copyright(C) 2025 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "project.h"
+#include "re_common.hpp"
+#include "revil/hashreg.hpp"
+#include "revil/tex.hpp"
+#include "spike/except.hpp"
+#include "spike/format/DDS.hpp"
+#include "spike/io/binreader_stream.hpp"
+#include "spike/io/binwritter_stream.hpp"
+#include "spike/master_printer.hpp"
+
+std::string_view filters[]{
+    ".dds$",
+};
+
+struct DDSToTEX : ReflectorBase<DDSToTEX> {
+  std::string title;
+  Platform platform = Platform::Auto;
+  uint32 version = 0;
+  bool generateMipmaps = false;
+} settings;
+
+REFLECT(CLASS(DDSToTEX),
+        MEMBER(title, "t", ReflDesc{"Set title for correct texture version."}),
+        MEMBER(platform, "p",
+               ReflDesc{"Set platform for correct texture handling."}),
+        MEMBER(version, "v",
+               ReflDesc{"Override texture version (0 = from title)."}),
+        MEMBERNAME(generateMipmaps, "generate-mipmaps", "m",
+                   ReflDesc{"Generate full mipmap chain for uncompressed "
+                            "textures without mipmaps."}));
+
+static AppInfo_s appInfo{
+    .filteredLoad = true,
+    .header = MTFTEXConvert_DESC " v" MTFTEXConvert_VERSION
+                                 ", " MTFTEXConvert_COPYRIGHT "Lukas Cone",
+    .settings = reinterpret_cast<ReflectorFriend *>(&settings),
+    .filters = filters,
+};
+
+AppInfo_s *AppInitModule() { return &appInfo; }
+
+TexelInputFormat FromDXGI(uint32 format) {
+  TexelInputFormat retVal;
+
+  switch (format) {
+  case DXGI_FORMAT_BC1_UNORM:
+  case DXGI_FORMAT_BC1_UNORM_SRGB:
+    retVal.type = TexelInputFormatType::BC1;
+    break;
+  case DXGI_FORMAT_BC2_UNORM:
+  case DXGI_FORMAT_BC2_UNORM_SRGB:
+    retVal.type = TexelInputFormatType::BC2;
+    break;
+  case DXGI_FORMAT_BC3_UNORM:
+  case DXGI_FORMAT_BC3_UNORM_SRGB:
+    retVal.type = TexelInputFormatType::BC3;
+    break;
+  case DXGI_FORMAT_BC4_UNORM:
+    retVal.type = TexelInputFormatType::BC4;
+    break;
+  case DXGI_FORMAT_BC5_UNORM:
+    retVal.type = TexelInputFormatType::BC5;
+    break;
+  case DXGI_FORMAT_BC7_UNORM:
+  case DXGI_FORMAT_BC7_UNORM_SRGB:
+    retVal.type = TexelInputFormatType::BC7;
+    break;
+  case DXGI_FORMAT_R8G8B8A8_UNORM:
+  case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    retVal.type = TexelInputFormatType::RGBA8;
+    break;
+  case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    retVal.type = TexelInputFormatType::RGBA16;
+    break;
+  case DXGI_FORMAT_R10G10B10A2_UNORM:
+    retVal.type = TexelInputFormatType::RGB10A2;
+    break;
+  case DXGI_FORMAT_R8G8_UNORM:
+    retVal.type = TexelInputFormatType::RG8;
+    break;
+  case DXGI_FORMAT_R8_UNORM:
+    retVal.type = TexelInputFormatType::R8;
+    break;
+  default:
+    throw es::RuntimeError("Unsupported DXGI format: " +
+                           std::to_string(format));
+  }
+
+  return retVal;
+}
+
+TexelInputFormat FromLegacy(const DDS_PixelFormat &pf) {
+  TexelInputFormat retVal;
+
+  switch (pf.fourCC) {
+  case CompileFourCC("DXT1"):
+    retVal.type = TexelInputFormatType::BC1;
+    return retVal;
+  case CompileFourCC("DXT2"):
+    retVal.premultAlpha = true;
+    [[fallthrough]];
+  case CompileFourCC("DXT3"):
+    retVal.type = TexelInputFormatType::BC2;
+    return retVal;
+  case CompileFourCC("DXT4"):
+    retVal.premultAlpha = true;
+    [[fallthrough]];
+  case CompileFourCC("DXT5"):
+    retVal.type = TexelInputFormatType::BC3;
+    return retVal;
+  case CompileFourCC("ATI1"):
+  case CompileFourCC("BC4U"):
+    retVal.type = TexelInputFormatType::BC4;
+    return retVal;
+  case CompileFourCC("ATI2"):
+  case CompileFourCC("BC5U"):
+    retVal.type = TexelInputFormatType::BC5;
+    return retVal;
+  case 0:
+    break;
+  default:
+    throw es::RuntimeError("Unsupported DDS fourcc.");
+  }
+
+  if (pf.bpp == 32 && pf.RBitMask == 0xff && pf.GBitMask == 0xff00 &&
+      pf.BBitMask == 0xff0000) {
+    retVal.type = TexelInputFormatType::RGBA8;
+  } else if (pf.bpp == 8) {
+    retVal.type = TexelInputFormatType::R8;
+  } else if (pf.bpp == 16 && pf.RBitMask == 0xff && pf.GBitMask == 0xff00) {
+    retVal.type = TexelInputFormatType::RG8;
+  } else {
+    throw es::RuntimeError("Unsupported DDS pixel format.");
+  }
+
+  return retVal;
+}
+
+void AppProcessFile(AppContext *ctx) {
+  TraceZone zone("app.dds_to_tex");
+  BinReaderRef rd(ctx->GetStream());
+  DDS_Header hdr;
+  DDS_PixelFormat pf;
+  DDS_HeaderEnd hdrEnd;
+  rd.Read(hdr);
+
+  if (hdr.id != DDS_Header::ID) {
+    throw es::InvalidHeaderError(hdr.id);
+  }
+
+  rd.Read(pf);
+  rd.Read(hdrEnd);
+  const bool isCubemap = hdrEnd.caps01[DDS_HeaderEnd::Caps01Flags_CubeMap];
+
+  TEX tex{};
+  tex.ctx.width = hdr.width;
+  tex.ctx.height = hdr.height;
+  tex.ctx.depth = std::max(1U, hdr.depth);
+  tex.ctx.numMipmaps = std::max(1U, hdr.mipMapCount);
+
+  if (pf.fourCC == CompileFourCC("DX10")) {
+    DDS_HeaderDX10 hdr10;
+    rd.Read(hdr10);
+    tex.ctx.baseFormat = FromDXGI(hdr10.dxgiFormat);
+
+    if (hdr10.arraySize > 1 && !isCubemap) {
+      throw es::RuntimeError("Texture arrays are not supported.");
+    }
+  } else {
+    tex.ctx.baseFormat = FromLegacy(pf);
+  }
+
+  if (isCubemap) {
+    tex.ctx.numFaces = 6;
+  }
+
+  rd.ReadContainer(tex.buffer, rd.GetSize() - rd.Tell());
+
+  if (settings.generateMipmaps && tex.ctx.numMipmaps == 1) {
+    tex.GenerateMipmaps();
+  }
+
+  if (tex.ctx.numFaces == 6) {
+    if (tex.ctx.baseFormat.type == TexelInputFormatType::RGBA8) {
+      tex.ComputeHarmonics();
+    } else {
+      printwarning("Cubemap harmonics can be computed only from RGBA8 data.");
+    }
+  }
+
+  uint32 version = settings.version;
+
+  if (!version) {
+    if (settings.title.empty()) {
+      throw es::RuntimeError("Title or version must be set.");
+    }
+
+    version = GetTitleSupport(settings.title, settings.platform)->texVersion;
+  }
+
+  auto &str = ctx->NewFile(ctx->workingFile.ChangeExtension(".tex")).str;
+  tex.Save(str, version, settings.platform);
+}
@@ -43,6 +43,7 @@ static AppInfo_s appInfo{
 AppInfo_s *AppInitModule() { return &appInfo; }
 
 void AppProcessFile(AppContext *ctx) {
+  TraceZone zone("app.tex_to_dds");
   TEX tex;
   tex.Load(ctx->GetStream(), settings.platformOverride);
 
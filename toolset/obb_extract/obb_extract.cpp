@@ -16,61 +16,173 @@
 */
 
 #include "project.h"
+#include "revil/container.hpp"
+#include "revil/hashreg.hpp"
+#include "revil/trace.hpp"
 #include "spike/app_context.hpp"
-#include "spike/crypto/crc32.hpp"
 #include "spike/except.hpp"
 #include "spike/io/binreader_stream.hpp"
+#include "spike/io/binwritter.hpp"
 #include "spike/io/stat.hpp"
 #include "spike/master_printer.hpp"
 #include "spike/reflect/reflector.hpp"
+#include <algorithm>
 #include <charconv>
-#include <sstream>
 
 std::string_view filters[]{
     ".obb$",
 };
 
+static struct OBBExtract : ReflectorBase<OBBExtract> {
+  bool verifyCrc = false;
+} settings;
+
+REFLECT(CLASS(OBBExtract),
+        MEMBERNAME(verifyCrc, "verify-crc", "c",
+                   ReflDesc{"Verify CRC of file table and extracted files. "
+                            "CRC variant is not confirmed by game files, "
+                            "mismatches may be false positives."}));
+
 static AppInfo_s appInfo{
     .filteredLoad = true,
     .header = OBBExtract_DESC " v" OBBExtract_VERSION ", " OBBExtract_COPYRIGHT
                               "Lukas Cone",
+    .settings = reinterpret_cast<ReflectorFriend *>(&settings),
     .filters = filters,
 };
 
 AppInfo_s *AppInitModule() { return &appInfo; }
 
-static std::map<uint32, std::string_view> FILES;
+// Name list is precompiled into sorted hash index (mhs.files.idx), index
+// items point into mapped name list
+struct NameIndexHeader {
+  static constexpr uint32 ID = CompileFourCC("NIDX");
+  static constexpr uint32 VERSION = 2;
+  uint32 id = ID;
+  uint32 version = VERSION;
+  // Index is rebuilt when name list size or contents change
+  uint64 sourceSize;
+  uint32 numItems;
+  uint32 sourceCrc;
+};
+
+struct NameIndexItem {
+  uint32 hash;
+  uint32 offset;
+  uint32 size;
+};
+
 static es::MappedFile mappedFile;
+static es::MappedFile mappedIndex;
+static std::vector<NameIndexItem> builtIndex;
+static std::string_view NAMES;
+static std::span<const NameIndexItem> NAME_INDEX;
 
-bool AppInitContext(const std::string &dataFolder) {
-  mappedFile = es::MappedFile(dataFolder + "mhs.files");
-  std::string_view totalMap(static_cast<const char *>(mappedFile.data),
-                            mappedFile.fileSize);
+std::vector<NameIndexItem> BuildNameIndex(std::string_view names) {
+  std::vector<NameIndexItem> retVal;
 
-  while (!totalMap.empty()) {
-    size_t found = totalMap.find_first_of("\r\n");
+  for (size_t offset = 0; offset < names.size();) {
+    size_t found = names.find_first_of("\r\n", offset);
 
-    if (found != totalMap.npos) {
-      auto sub = totalMap.substr(0, found);
-      uint32 crc = ~crc32b(0, sub.data(), sub.size());
+    if (found == names.npos) {
+      found = names.size();
+    }
 
-      if (FILES.contains(crc) && FILES.at(crc) != sub) {
-        printerror("File colision: " << FILES.at(crc) << " vs: " << sub);
-      } else {
-        FILES.emplace(crc, sub);
-      }
+    if (found > offset) {
+      auto sub = names.substr(offset, found - offset);
+      retVal.emplace_back(NameIndexItem{
+          revil::CRC32Update(0xFFFFFFFF, sub), uint32(offset),
+          uint32(sub.size())});
+    }
+
+    offset = found + 1;
+  }
+
+  std::stable_sort(
+      retVal.begin(), retVal.end(),
+      [](auto &item0, auto &item1) { return item0.hash < item1.hash; });
+
+  // Keep first occurence of every hash
+  auto Name = [&](const NameIndexItem &item) {
+    return names.substr(item.offset, item.size);
+  };
 
-      totalMap.remove_prefix(found + 1);
+  auto newEnd = std::unique(
+      retVal.begin(), retVal.end(), [&](auto &item0, auto &item1) {
+        if (item0.hash != item1.hash) {
+          return false;
+        }
 
-      if (totalMap.front() == '\n') {
-        totalMap.remove_prefix(1);
-      }
+        if (Name(item0) != Name(item1)) {
+          printerror("File colision: " << Name(item0) << " vs: "
+                                       << Name(item1));
+        }
+
+        return true;
+      });
+
+  retVal.erase(newEnd, retVal.end());
+
+  return retVal;
+}
+
+bool AppInitContext(const std::string &dataFolder) {
+  const std::string namesPath = dataFolder + "mhs.files";
+  const std::string indexPath = namesPath + ".idx";
+  mappedFile = es::MappedFile(namesPath);
+  NAMES = {static_cast<const char *>(mappedFile.data), mappedFile.fileSize};
+  // Edits of same size don't change list size, checksum catches them
+  const uint32 namesCrc = revil::CRC32Update(0xFFFFFFFF, NAMES);
+
+  try {
+    mappedIndex = es::MappedFile(indexPath);
+    auto hdr = static_cast<const NameIndexHeader *>(mappedIndex.data);
+
+    if (mappedIndex.fileSize >= sizeof(NameIndexHeader) &&
+        hdr->id == NameIndexHeader::ID &&
+        hdr->version == NameIndexHeader::VERSION &&
+        hdr->sourceSize == NAMES.size() && hdr->sourceCrc == namesCrc &&
+        mappedIndex.fileSize == sizeof(NameIndexHeader) +
+                                    sizeof(NameIndexItem) * hdr->numItems) {
+      NAME_INDEX = {reinterpret_cast<const NameIndexItem *>(hdr + 1),
+                    hdr->numItems};
+      return true;
     }
+  } catch (const std::exception &) {
+  }
+
+  mappedIndex = es::MappedFile();
+  builtIndex = BuildNameIndex(NAMES);
+  NAME_INDEX = builtIndex;
+
+  try {
+    NameIndexHeader hdr;
+    hdr.sourceSize = NAMES.size();
+    hdr.sourceCrc = namesCrc;
+    hdr.numItems = builtIndex.size();
+    BinWritter wr(indexPath);
+    wr.Write(hdr);
+    wr.WriteBuffer(reinterpret_cast<const char *>(builtIndex.data()),
+                   builtIndex.size() * sizeof(NameIndexItem));
+  } catch (const std::exception &) {
+    printwarning("Cannot write name index: " << indexPath);
   }
 
   return true;
 }
 
+std::string_view FindName(uint32 hash) {
+  auto found = std::lower_bound(
+      NAME_INDEX.begin(), NAME_INDEX.end(), hash,
+      [](const NameIndexItem &item, uint32 hash) { return item.hash < hash; });
+
+  if (found == NAME_INDEX.end() || found->hash != hash) {
+    return {};
+  }
+
+  return NAMES.substr(found->offset, found->size);
+}
+
 struct OBBFile {
   uint32 nameHash;
   uint32 offset;
@@ -86,6 +198,7 @@ struct OBBHeader {
 };
 
 void AppProcessFile(AppContext *ctx) {
+  revil::TraceZone zone("app.obb_extract");
   BinReaderRef rd(ctx->GetStream());
   OBBHeader id;
   rd.Read(id);
@@ -101,68 +214,80 @@ void AppProcessFile(AppContext *ctx) {
   std::vector<OBBFile> files;
   rd.ReadContainer(files, id.numFiles);
 
-  auto ectx = ctx->ExtractContext();
+  if (settings.verifyCrc) {
+    std::string_view table(reinterpret_cast<const char *>(files.data()),
+                           files.size() * sizeof(OBBFile));
 
-  if (ectx->RequiresFolders()) {
-    for (auto &f : files) {
-      auto filePath = FILES.at(f.nameHash);
-      ectx->AddFolderPath(std::string(filePath));
+    if (revil::CRC32Update(0xFFFFFFFF, table) != id.tocCrc) {
+      printwarning("File table CRC mismatch");
     }
-
-    ectx->GenerateFolders();
   }
 
-  std::string buffer;
+  revil::ContainerSource source(ctx);
+  std::vector<revil::ContainerEntry> entries;
 
   for (auto &f : files) {
-    rd.Seek(f.offset);
-    rd.ReadContainer(buffer, f.size);
-
-    if (FILES.contains(f.nameHash)) {
-      auto filePath = FILES.at(f.nameHash);
-      ectx->NewFile(std::string(filePath));
-    } else {
-      char hexbuffer[0x10]{};
-      std::to_chars(std::begin(hexbuffer), std::end(hexbuffer), f.nameHash,
-                    0x10);
-      std::string fileBuffer = hexbuffer;
-
-      if (buffer.starts_with("TEX")) {
-        fileBuffer.append(".tex");
-      } else if (buffer.starts_with("MOD")) {
-        fileBuffer.append(".mod");
-      } else if (buffer.starts_with("LMT")) {
-        fileBuffer.append(".lmt");
-      } else if (buffer.starts_with("MRL")) {
-        fileBuffer.append(".mrl");
-      } else if (buffer.starts_with("XFS")) {
-        fileBuffer.append(".xfs");
-      } else if (buffer.starts_with("FWSE")) {
-        fileBuffer.append(".sew");
-      } else if (buffer.starts_with("SBKR")) {
-        fileBuffer.append(".sbkr");
-      } else if (buffer.starts_with("OggS")) {
-        fileBuffer.append(".sngw");
-      } else if (buffer.starts_with("SPTL")) {
-        fileBuffer.append(".sptl");
-      } else if (buffer.starts_with("REVR")) {
-        fileBuffer.append(".revr_and");
-      } else if (buffer.starts_with("SRQR")) {
-        fileBuffer.append(".srqr");
-      } else if (buffer.starts_with("ARC")) {
-        fileBuffer.append(".arc");
-      } else if (buffer.starts_with("lyt")) {
-        fileBuffer.append(".lyt");
-      } else if (buffer.starts_with("lan")) {
-        fileBuffer.append(".lan");
-      } else if (buffer.starts_with("lmd")) {
-        fileBuffer.append(".lmd");
-      }
-
-      ectx->NewFile(fileBuffer);
+    revil::ContainerEntry &entry = entries.emplace_back();
+    entry.offset = f.offset;
+    entry.size = f.size;
+    entry.verifyCrc = settings.verifyCrc;
+    entry.crc = f.crc;
+
+    if (auto name = FindName(f.nameHash); !name.empty()) {
+      entry.path = name;
+      continue;
+    }
+
+    char hexbuffer[0x10]{};
+    std::to_chars(std::begin(hexbuffer), std::end(hexbuffer), f.nameHash,
+                  0x10);
+    entry.path = hexbuffer;
+
+    // Guess extension from magic
+    std::string_view buffer;
+
+    if (f.offset < source.data.size()) {
+      buffer = source.data.substr(f.offset, std::min<size_t>(f.size, 4));
     }
 
-    ectx->SendData(buffer);
+    if (buffer.starts_with("TEX")) {
+      entry.path.append(".tex");
+    } else if (buffer.starts_with("MOD")) {
+      entry.path.append(".mod");
+    } else if (buffer.starts_with("LMT")) {
+      entry.path.append(".lmt");
+    } else if (buffer.starts_with("MRL")) {
+      entry.path.append(".mrl");
+    } else if (buffer.starts_with("XFS")) {
+      entry.path.append(".xfs");
+    } else if (buffer.starts_with("FWSE")) {
+      entry.path.append(".sew");
+    } else if (buffer.starts_with("SBKR")) {
+      entry.path.append(".sbkr");
+    } else if (buffer.starts_with("OggS")) {
+      entry.path.append(".sngw");
+    } else if (buffer.starts_with("SPTL")) {
+      entry.path.append(".sptl");
+    } else if (buffer.starts_with("REVR")) {
+      entry.path.append(".revr_and");
+    } else if (buffer.starts_with("SRQR")) {
+      entry.path.append(".srqr");
+    } else if (buffer.starts_with("ARC")) {
+      entry.path.append(".arc");
+    } else if (buffer.starts_with("lyt")) {
+      entry.path.append(".lyt");
+    } else if (buffer.starts_with("lan")) {
+      entry.path.append(".lan");
+    } else if (buffer.starts_with("lmd")) {
+      entry.path.append(".lmd");
+    }
+  }
+
+  const size_t numFailed =
+      revil::ExtractContainer(source.data, entries, ctx->ExtractContext());
+
+  if (numFailed) {
+    printwarning(numFailed << " files failed CRC check");
   }
 }
 
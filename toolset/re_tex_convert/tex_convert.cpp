@@ -16,6 +16,7 @@
 */
 
 #include "project.h"
+#include "revil/container.hpp"
 #include "spike/app_context.hpp"
 #include "spike/except.hpp"
 #include "spike/format/DDS.hpp"
@@ -33,6 +34,9 @@ struct TEXConvert : ReflectorBase<TEXConvert> {
   bool legacyDDS = true;
   bool forceLegacyDDS = false;
   bool largestMipmap = true;
+  uint32 firstMipmap = 0;
+  uint32 firstSlice = 0;
+  uint32 numSlices = 0;
 } settings;
 
 REFLECT(CLASS(TEXConvert),
@@ -46,7 +50,16 @@ REFLECT(CLASS(TEXConvert),
                        "to DX9, for example: RG88 to AL88.",
                        ""}),
         MEMBERNAME(largestMipmap, "largest-mipmap-only", "m",
-                   ReflDesc{"Will try to extract only highest mipmap.", ""}), );
+                   ReflDesc{"Will try to extract only highest mipmap.", ""}),
+        MEMBERNAME(firstMipmap, "first-mipmap", "M",
+                   ReflDesc{"Skips given number of largest mipmaps.", ""}),
+        MEMBERNAME(firstSlice, "first-slice", "s",
+                   ReflDesc{"First array slice (or cubemap face) to extract.",
+                            ""}),
+        MEMBERNAME(numSlices, "num-slices", "n",
+                   ReflDesc{"Number of array slices to extract, 0 for all. "
+                            "Partial cubemaps are saved as texture arrays.",
+                            ""}), );
 
 AppInfo_s appInfo{
     .filteredLoad = true,
@@ -59,7 +72,7 @@ AppInfo_s appInfo{
 AppInfo_s *AppInitModule() { return &appInfo; }
 
 struct RETEXMip {
-  char *offset;
+  uint64 offset;
   uint32 pad;
   uint32 unk;
   uint32 size;
@@ -80,16 +93,11 @@ struct RETEX {
   const RETEXMip *Mips() const {
     return reinterpret_cast<const RETEXMip *>(this + 1);
   }
+};
 
-  void Fixup() {
-    char *root = reinterpret_cast<char *>(this);
-    RETEXMip *mips = reinterpret_cast<RETEXMip *>(this + 1);
-    uint32 numTotalMips = numMips * numArrays;
-
-    for (uint32 t = 0; t < numTotalMips; t++) {
-      mips[t].offset = root + reinterpret_cast<uintptr_t>(mips[t].offset);
-    }
-  }
+struct MipRange {
+  size_t offset;
+  size_t size;
 };
 
 void AppProcessFile(AppContext *ctx) {
@@ -100,24 +108,73 @@ void AppProcessFile(AppContext *ctx) {
     throw es::InvalidHeaderError(id);
   }
 
-  std::string buffer = ctx->GetBuffer();
-  RETEX *tex = reinterpret_cast<RETEX *>(&buffer[0]);
-  tex->Fixup();
+  // Header is never patched, texels are streamed from mapped input
+  revil::ContainerSource file(ctx);
+
+  if (file.data.size() < sizeof(RETEX)) {
+    throw es::RuntimeError("Truncated TEX header");
+  }
+
+  const RETEX *tex = reinterpret_cast<const RETEX *>(file.data.data());
+
+  if (!tex->numMips || !tex->numArrays) {
+    throw es::RuntimeError("TEX has no mipmaps or array slices");
+  }
+
+  const uint32 numTotalMips = tex->numMips * tex->numArrays;
+
+  if (sizeof(RETEX) + sizeof(RETEXMip) * numTotalMips > file.data.size()) {
+    throw es::RuntimeError("Truncated TEX mip table");
+  }
+
+  const uint32 firstMip = std::min<uint32>(
+      settings.firstMipmap, std::max<uint32>(tex->numMips, 1) - 1);
+  const uint32 numMips =
+      settings.largestMipmap ? 1 : std::max<uint32>(tex->numMips - firstMip, 1);
+  const uint32 firstSlice = std::min<uint32>(
+      settings.firstSlice, std::max<uint32>(tex->numArrays, 1) - 1);
+  const uint32 numSlices =
+      std::min<uint32>(settings.numSlices ? settings.numSlices : tex->numArrays,
+                       tex->numArrays - firstSlice);
+  const bool isCubemap = tex->unk == 4 && numSlices == tex->numArrays;
+
+  // Collect requested ranges, adjacent ones are merged into single write
+  std::vector<MipRange> ranges;
+  const RETEXMip *mips = tex->Mips();
+
+  for (uint32 a = firstSlice; a < firstSlice + numSlices; a++) {
+    for (uint32 m = firstMip; m < firstMip + numMips; m++) {
+      const RETEXMip &cMip = mips[m + tex->numMips * a];
+      const size_t size = size_t(cMip.size) * std::max<uint16>(tex->depth, 1);
+
+      if (cMip.offset > file.data.size() ||
+          size > file.data.size() - cMip.offset) {
+        throw es::RuntimeError("TEX mipmap is out of file bounds");
+      }
+
+      if (!ranges.empty() &&
+          ranges.back().offset + ranges.back().size == cMip.offset) {
+        ranges.back().size += size;
+      } else {
+        ranges.emplace_back(MipRange{cMip.offset, size});
+      }
+    }
+  }
 
   BinWritterRef wr(ctx->NewFile(ctx->workingFile.ChangeExtension(".dds")).str);
 
   DDS ddtex = {};
   ddtex = DDSFormat_DX10;
   ddtex.dxgiFormat = tex->format;
-  ddtex.width = tex->width;
-  ddtex.height = tex->height;
+  ddtex.width = std::max(tex->width >> firstMip, 1);
+  ddtex.height = std::max(tex->height >> firstMip, 1);
 
   if (tex->depth > 1) {
     ddtex.depth = tex->depth;
     ddtex.flags += DDS::Flags_Depth;
     ddtex.caps01 += DDS_HeaderEnd::Caps01Flags_Volume;
-  } else if (tex->unk != 4) {
-    ddtex.arraySize = tex->numArrays;
+  } else if (!isCubemap) {
+    ddtex.arraySize = numSlices;
   } else {
     ddtex.caps01 = decltype(ddtex.caps01)(
         DDS::Caps01Flags_CubeMap, DDS::Caps01Flags_CubeMap_NegativeX,
@@ -126,7 +183,7 @@ void AppProcessFile(AppContext *ctx) {
         DDS::Caps01Flags_CubeMap_PositiveZ);
   }
 
-  ddtex.NumMipmaps(settings.largestMipmap ? 1 : tex->numMips);
+  ddtex.NumMipmaps(numMips);
 
   const uint32 sizetoWrite = !settings.legacyDDS || ddtex.arraySize > 1 ||
                                      ddtex.ToLegacy(settings.forceLegacyDDS)
@@ -139,13 +196,8 @@ void AppProcessFile(AppContext *ctx) {
 
   wr.WriteBuffer(reinterpret_cast<const char *>(&ddtex), sizetoWrite);
 
-  const RETEXMip *mips = tex->Mips();
-  const uint32 mipPerArray = tex->numMips;
-
-  for (uint32 a = 0; a < tex->numArrays; a++) {
-    for (uint32 m = 0; m < ddtex.mipMapCount; m++) {
-      const RETEXMip &cMip = mips[m + mipPerArray * a];
-      wr.WriteBuffer(cMip.offset, cMip.size * tex->depth);
-    }
+  // Texel data are streamed straight from input file
+  for (auto &r : ranges) {
+    wr.WriteBuffer(file.data.data() + r.offset, r.size);
   }
 }
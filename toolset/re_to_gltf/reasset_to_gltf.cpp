@@ -268,6 +268,7 @@ bool MOTGLTF::Pipeline(const revil::REAsset &asset) {
 }
 
 void AppProcessFile(AppContext *ctx) {
+  TraceZone zone("app.reasset_to_gltf");
   revil::REAsset asset;
   asset.Load(ctx->GetStream());
   MOTGLTF main;
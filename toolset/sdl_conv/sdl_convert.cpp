@@ -0,0 +1,52 @@
+/*  SDLConvert
+    Copyright(C) 2023 Lukas Cone
+
+    This program is free software : you can redistribute it and / or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "project.h"
+#include "re_common.hpp"
+#include "revil/sdl.hpp"
+#include "spike/io/binreader_stream.hpp"
+#include "spike/io/binwritter_stream.hpp"
+
+std::string_view filters[]{
+    ".sdl$",
+};
+
+static struct SDLPlatformConvert : ReflectorBase<SDLPlatformConvert> {
+  Platform platform = Platform::Win64;
+} settings;
+
+REFLECT(CLASS(SDLPlatformConvert),
+        MEMBER(platform, "p", ReflDesc{"Set target platform layout."}));
+
+static AppInfo_s appInfo{
+    .filteredLoad = true,
+    .header = SDLConvert_DESC " v" SDLConvert_VERSION ", " SDLConvert_COPYRIGHT
+                              "Lukas Cone",
+    .settings = reinterpret_cast<ReflectorFriend *>(&settings),
+    .filters = filters,
+};
+
+AppInfo_s *AppInitModule() { return &appInfo; }
+
+void AppProcessFile(AppContext *ctx) {
+  TraceZone zone("app.sdl_convert");
+  SDL sdl;
+  sdl.Load(ctx->GetStream());
+
+  auto &str = ctx->NewFile(ctx->workingFile.ChangeExtension(".conv.sdl")).str;
+  sdl.Save(str, settings.platform);
+}
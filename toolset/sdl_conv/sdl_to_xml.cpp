@@ -151,6 +151,7 @@ std::string findShortestSuperstring(std::string arr[], int len) {
 #include "spike/master_printer.hpp"
 
 void AppProcessFile(AppContext *ctx) {
+  TraceZone zone("app.sdl_to_xml");
   std::vector<std::string> strs{"settings", "array",   "node_data",
                                 "raycast",  "dataset", "castnode"};
 
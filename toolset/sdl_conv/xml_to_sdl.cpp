@@ -35,6 +35,7 @@ static AppInfo_s appInfo{
 AppInfo_s *AppInitModule() { return &appInfo; }
 
 void AppProcessFile(AppContext *ctx) {
+  TraceZone zone("app.xml_to_sdl");
   pugi::xml_document doc;
 
   if (auto result = doc.load(ctx->GetStream()); !result) {
@@ -15,7 +15,9 @@
     along with this program.If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "parallel.hpp"
 #include "project.h"
+#include "revil/trace.hpp"
 #include "spike/app_context.hpp"
 #include "spike/except.hpp"
 #include "spike/format/FWSE.hpp"
@@ -28,6 +30,7 @@
 #include "spike/reflect/reflector.hpp"
 #include "spike/util/endian.hpp"
 #include <memory>
+#include <mutex>
 #include <sstream>
 
 #ifdef USE_VGM
@@ -47,10 +50,7 @@ REFLECT(
         ReflDesc{
             "Convert ADPCM WAV files into PCM WAV if SPAC contains then."}));
 
-class VGMMemoryFile;
-
-static thread_local std::unique_ptr<VGMMemoryFile> currentFile;
-
+// Every worker owns its file, reopening returns the same instance
 class VGMMemoryFile {
   STREAMFILE sf; // must be always first, to fool free(), reinterpret_casts, etc
   offv_t bufferOffset = 0;
@@ -94,34 +94,24 @@ private:
     buffer[length - 1] = '\0';
   }
 
-  static void Destroy(STREAMFILE *fl) {
-    // VGMMemoryFile *self = reinterpret_cast<VGMMemoryFile *>(fl);
-
-    // currentFile = nullptr;
-    // delete self;
+  static void Destroy(STREAMFILE *) {
+    // Owned by worker
   }
 
-  static STREAMFILE *Create(STREAMFILE *, const char *fileName, size_t) {
-    if (fileName)
-      return reinterpret_cast<STREAMFILE *>(currentFile.get());
-
-    currentFile = std::make_unique<VGMMemoryFile>();
-
-    currentFile->sf.read = Read;
-    currentFile->sf.get_size = GetSize;
-    currentFile->sf.get_offset = GetOffset;
-    currentFile->sf.get_name = GetName;
-    currentFile->sf.open = Create;
-    currentFile->sf.close = Destroy;
-
-    return reinterpret_cast<STREAMFILE *>(currentFile.get());
-  }
+  static STREAMFILE *Open(STREAMFILE *fl, const char *, size_t) { return fl; }
 
 public:
-  static VGMMemoryFile *Create() {
-    return reinterpret_cast<VGMMemoryFile *>(Create(nullptr, nullptr, 0));
+  VGMMemoryFile() {
+    sf.read = Read;
+    sf.get_size = GetSize;
+    sf.get_offset = GetOffset;
+    sf.get_name = GetName;
+    sf.open = Open;
+    sf.close = Destroy;
   }
 
+  VGMMemoryFile(const VGMMemoryFile &) = delete;
+
   operator STREAMFILE *() { return reinterpret_cast<STREAMFILE *>(this); }
 };
 
@@ -216,6 +206,7 @@ template <> void FByteswapper(WAVE_smpl &item, bool) {
 
 
 void AppProcessFile(AppContext *ctx) {
+  revil::TraceZone zone("app.spac_conv");
   BinReaderRef_e rd(ctx->GetStream());
 
   SPACHeader hdr;
@@ -378,74 +369,132 @@ void AppProcessFile(AppContext *ctx) {
     }
   }
 
-  size_t currentFile = 0;
-
 #ifdef USE_VGM
-  VGMMemoryFile *nmFile =
-      !settings.convertWAV ? nullptr : VGMMemoryFile::Create();
+  // Files of extract context cannot interleave, worker holding output
+  // streams rendered blocks directly, others keep their blocks until output
+  // is free
+  std::mutex outputMutex;
+  auto ectx = ctx->ExtractContext();
+
+  // Sample frames rendered at once
+  static constexpr size_t BLOCK_FRAMES = 0x8000;
+  // Rendered blocks buffered while another worker holds output
+  static constexpr size_t MAX_PENDING_BLOCKS = 4;
+
+  struct OutputFile {
+    std::unique_lock<std::mutex> lock;
+    AppExtractContext *ectx;
+    std::string fileName;
+    std::string pending;
+    size_t maxPending = 0;
+
+    void Acquire() {
+      ectx->NewFile(fileName);
+
+      if (!pending.empty()) {
+        ectx->SendData(pending);
+        pending = {};
+      }
+    }
 
-  for (auto &e : msBuffer.entries) {
+    void Send(std::string_view data) {
+      if (!lock.owns_lock()) {
+        // Renderer waits for output once buffer is full
+        if (pending.size() + data.size() > maxPending) {
+          lock.lock();
+          Acquire();
+        } else if (lock.try_lock()) {
+          Acquire();
+        }
+      }
+
+      if (lock.owns_lock()) {
+        ectx->SendData(data);
+      } else {
+        pending.append(data);
+      }
+    }
+
+    void Finish() {
+      if (!lock.owns_lock()) {
+        lock.lock();
+        Acquire();
+      }
+
+      lock.unlock();
+    }
+  };
+
+  revil::ParallelFor(msBuffer.entries.size(), [&](size_t currentFile) {
+    auto &e = msBuffer.entries[currentFile];
     AFileInfo &finf = ctx->workingFile;
     auto extension = GetReflectedEnum<SPACFileType>()
                          ->names[static_cast<size_t>(e.fileType)];
     std::string nakedName = (std::to_string(currentFile) + '.') + extension;
-    auto ectx = ctx->ExtractContext();
 
     if (settings.convertWAV &&
         (settings.forceWAV || e.fileType != SPACFileType::WAV)) {
-      nmFile->buffer = e.start;
-      nmFile->bufferSize = e.size;
-      nmFile->fileName = nakedName.data();
+      OutputFile output{
+          std::unique_lock<std::mutex>(outputMutex, std::defer_lock), ectx};
+      VGMMemoryFile nmFile;
+      nmFile.buffer = e.start;
+      nmFile.bufferSize = e.size;
+      nmFile.fileName = nakedName.data();
 
-      VGMSTREAM *cVGMStream = init_vgmstream_from_STREAMFILE(*nmFile);
+      VGMSTREAM *cVGMStream = init_vgmstream_from_STREAMFILE(nmFile);
 
       if (!cVGMStream) {
         printerror("VGMStream Error!");
-        continue;
+        return;
       }
 
       vgmstream_info vgmInfo;
       describe_vgmstream_info(cVGMStream, &vgmInfo);
 
-      const size_t samplerSize = vgmInfo.num_samples * sizeof(sample_t);
-      std::string samples;
-      samples.resize(samplerSize);
-      sample_t *sampleBuffer = reinterpret_cast<sample_t *>(&samples[0]);
-
-      render_vgmstream(sampleBuffer, vgmInfo.num_samples, cVGMStream);
-
+      // Sizes are known from sample count, header is sent first
+      const size_t frameSize = vgmInfo.channels * sizeof(sample_t);
+      const size_t samplerSize = vgmInfo.num_samples * frameSize;
       RIFFHeader hdr(sizeof(RIFFHeader) + sizeof(WAVE_fmt) + sizeof(WAVE_data) +
                      samplerSize);
       WAVE_fmt fmt(WAVE_FORMAT::PCM);
+      fmt.channels = vgmInfo.channels;
       fmt.sampleRate = vgmInfo.sample_rate;
       fmt.CalcData();
       WAVE_data wData(samplerSize);
+      output.maxPending = MAX_PENDING_BLOCKS * BLOCK_FRAMES * frameSize;
 
-      close_vgmstream(cVGMStream);
-
-      auto filename = std::string(finf.GetFilename()) + '_' +
-                      std::to_string(currentFile) + ".wav";
-
-      ectx->NewFile(filename);
+      output.fileName = std::string(finf.GetFilename()) + '_' +
+                        std::to_string(currentFile) + ".wav";
       std::stringstream str;
       BinWritterRef wr(str);
       wr.Write(hdr);
       wr.Write(fmt);
       wr.Write(wData);
-      auto strBuff = std::move(str).str();
-      ectx->SendData(strBuff);
-      ectx->SendData({reinterpret_cast<char *>(sampleBuffer), samplerSize});
+      output.Send(std::move(str).str());
+
+      std::string samples;
+      samples.resize(BLOCK_FRAMES * frameSize);
+      sample_t *sampleBuffer = reinterpret_cast<sample_t *>(samples.data());
+
+      for (size_t f = 0; f < size_t(vgmInfo.num_samples); f += BLOCK_FRAMES) {
+        const size_t numFrames =
+            std::min(BLOCK_FRAMES, size_t(vgmInfo.num_samples) - f);
+        render_vgmstream(sampleBuffer, numFrames, cVGMStream);
+        output.Send({samples.data(), numFrames * frameSize});
+      }
+
+      close_vgmstream(cVGMStream);
+      output.Finish();
     } else {
       auto filename = std::string(finf.GetFilename()) + '_' + nakedName;
+      std::lock_guard<std::mutex> lg(outputMutex);
       ectx->NewFile(filename);
       ectx->SendData({e.start, e.size});
     }
-
-    currentFile++;
-  }
-
-  delete nmFile;
+  });
 #else
+  size_t currentFile = 0;
+
   for (auto &e : msBuffer.entries) {
     AFileInfo &finf = ctx->workingFile;
     auto extension = GetReflectedEnum<SPACFileType>()
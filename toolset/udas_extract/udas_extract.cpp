@@ -16,110 +16,18 @@
     along with this program.If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "fixup_tracker.hpp"
+#include "parallel.hpp"
 #include "project.h"
+#include "revil/container.hpp"
+#include "revil/lzx.hpp"
+#include "revil/trace.hpp"
 #include "spike/app_context.hpp"
 #include "spike/except.hpp"
-#include "spike/io/binreader_stream.hpp"
 #include "spike/reflect/reflector.hpp"
 #include "spike/type/pointer.hpp"
-#include <sstream>
-
-#include "lzx.h"
-#include "mspack.h"
-
-#pragma region XMemDecompress
-
-struct mspack_file {
-  uint8 *buffer;
-  uint32 bufferSize;
-  uint32 position;
-  uint32 rest;
-};
-
-// https://github.com/gildor2/UEViewer/blob/master/Unreal/UnCoreCompression.cpp#L90
-static int mspack_read(mspack_file *file, void *buffer, int bytes) {
-  if (!file->rest) {
-    // read block header
-    if (file->buffer[file->position] == 0xFF) {
-      // [0]   = FF
-      // [1,2] = uncompressed block size
-      // [3,4] = compressed block size
-      file->rest = (file->buffer[file->position + 3] << 8) |
-                   file->buffer[file->position + 4];
-      file->position += 5;
-    } else {
-      // [0,1] = compressed size
-      file->rest = (file->buffer[file->position + 0] << 8) |
-                   file->buffer[file->position + 1];
-      file->position += 2;
-    }
-
-    if (file->rest > file->bufferSize - file->position) {
-      file->rest = file->bufferSize - file->position;
-    }
-  }
-
-  if (bytes > file->rest) {
-    bytes = file->rest;
-  }
-
-  if (bytes <= 0) {
-    return 0;
-  }
-
-  memcpy(buffer, file->buffer + file->position, bytes);
-  file->position += bytes;
-  file->rest -= bytes;
-
-  return bytes;
-}
-
-static int mspack_write(mspack_file *file, void *buffer, int bytes) {
-  if (bytes <= 0) {
-    return 0;
-  }
-
-  memcpy(file->buffer + file->position, buffer, bytes);
-  file->position += bytes;
-  return bytes;
-}
-
-static mspack_system mspackSystem{
-    nullptr,                                                     // open
-    nullptr,                                                     // close
-    mspack_read,                                                 // read
-    mspack_write,                                                // write
-    nullptr,                                                     // seek
-    nullptr,                                                     // tell
-    nullptr,                                                     // message
-    [](mspack_system *, size_t bytes) { return malloc(bytes); }, // alloc
-    free,                                                        // free
-    [](void *src, void *dst, size_t bytes) { memcpy(dst, src, bytes); }, // copy
-};
-
-static void DecompressLZX(char *inBuffer, uint32 compressedSize,
-                          char *outBuffer, uint32 uncompressedSize) {
-  mspack_file inStream{};
-  mspack_file outStream{};
-  inStream.buffer = reinterpret_cast<uint8 *>(inBuffer);
-  inStream.bufferSize = compressedSize;
-  outStream.buffer = reinterpret_cast<uint8 *>(outBuffer);
-  outStream.bufferSize = uncompressedSize;
-
-  lzxd_stream *lzxd = lzxd_init(&mspackSystem, &inStream, &outStream, 17, 0,
-                                0x40000, uncompressedSize, false);
-
-  int retVal = lzxd_decompress(lzxd, uncompressedSize);
-
-  if (retVal != MSPACK_ERR_OK) {
-    throw std::runtime_error("LZX decompression error " +
-                             std::to_string(retVal));
-  }
-
-  lzxd_free(lzxd);
-}
-
-#pragma endregion
+#include <cstddef>
+#include <cstring>
 
 std::string_view filters[]{
     //".udas$",
@@ -182,27 +90,47 @@ struct DAT {
   }
 };
 
-void ProcessClass(DAT &item) {
+// Every pointer and table is validated against decompressed buffer
+void ProcessClass(DAT &item, revil::FixupTracker &ptrStore) {
+  ptrStore.CheckRange(&item, offsetof(DAT, data));
+  // File pointers are followed by file types
+  ptrStore.CheckArray(item.data, size_t(item.numFiles) * 2);
   char *root = reinterpret_cast<char *>(&item);
+
   for (size_t i = 0; i < item.numFiles; i++) {
-    item.data[i].Fixup(root);
+    ptrStore.Fixup(item.data[i], root);
   }
 }
 
-void ProcessClass(DASHeader &hdr);
+void ProcessClass(DASHeader &hdr, revil::FixupTracker &ptrStore);
+
+void ProcessClass(DASEntry &item, char *root, revil::FixupTracker &ptrStore) {
+  if (!ptrStore.Fixup(item.data, root)) {
+    return;
+  }
 
-void ProcessClass(DASEntry &item, char *root) {
-  item.data.Fixup(root);
   if (item.type == DASEntryType::Child) {
     DASHeader *child = reinterpret_cast<DASHeader *>(item.data.Get());
-    ProcessClass(*child);
-  } else if (item.type == DASEntryType::FileTable) {
-    DAT *dat = reinterpret_cast<DAT *>(item.data.Get());
-    ProcessClass(*dat);
+
+    // Shared or cyclic child would be extracted endlessly
+    if (!ptrStore.Insert(child)) {
+      throw es::RuntimeError("Cyclic DAS tree");
+    }
+
+    ProcessClass(*child, ptrStore);
+  } else {
+    ptrStore.CheckRange(item.data.Get(), item.size);
+
+    if (item.type == DASEntryType::FileTable) {
+      DAT *dat = reinterpret_cast<DAT *>(item.data.Get());
+      ProcessClass(*dat, ptrStore);
+    }
   }
 }
 
-void ProcessClass(DASHeader &hdr) {
+void ProcessClass(DASHeader &hdr, revil::FixupTracker &ptrStore) {
+  ptrStore.CheckRange(&hdr, offsetof(DASHeader, entries));
+
   if (hdr.id[0] != hdr.ID) {
     throw es::InvalidHeaderError(hdr.id[0]);
   }
@@ -211,102 +139,144 @@ void ProcessClass(DASHeader &hdr) {
 
   DASEntry *curEntry = hdr.entries;
 
-  while (curEntry->type != DASEntryType::End) {
-    ProcessClass(*curEntry, root);
-    curEntry++;
+  for (;; curEntry++) {
+    ptrStore.CheckArray(curEntry, 1);
+
+    if (curEntry->type == DASEntryType::End) {
+      break;
+    }
+
+    ProcessClass(*curEntry, root, ptrStore);
   }
 }
 
-void ExtractData(DAT &item, uint32 endPos, AppExtractContext *ectx,
-                 std::string curPath) {
+// Entries are collected first and extracted by revil::ExtractContainer
+struct ExtractTable {
+  const char *root;
+  std::vector<revil::ContainerEntry> entries;
 
+  void Add(std::string path, std::string_view data) {
+    revil::ContainerEntry &entry = entries.emplace_back();
+    entry.path = std::move(path);
+    entry.offset = data.data() - root;
+    entry.size = data.size();
+  }
+};
+
+void ExtractData(DAT &item, uint32 endPos, ExtractTable &table,
+                 std::string curPath) {
   auto FileName = [&](size_t id) {
     uint32 type = item.GetType(id);
-    std::string_view typeStr(reinterpret_cast<const char *>(&type));
-    if (typeStr.size() > 4) {
-      typeStr = typeStr.substr(0, 4);
-    }
-    ectx->NewFile(curPath + "_" + std::to_string(id) + "." +
-                  std::string(typeStr));
+    const char *typeData = reinterpret_cast<const char *>(&type);
+    std::string_view typeStr(typeData, strnlen(typeData, sizeof(type)));
+    return curPath + "_" + std::to_string(id) + "." + std::string(typeStr);
   };
 
-  for (size_t i = 0; i < item.numFiles - 1; i++) {
-    char *begin = item.data[i];
-    char *end = item.data[i + 1];
+  auto AddFile = [&](size_t id, char *begin, char *end) {
+    if (begin > end) {
+      throw es::RuntimeError("Invalid DAT file range");
+    }
+
     std::string_view fData{begin, end};
+
     if (!fData.empty()) {
-      FileName(i);
-      ectx->SendData(fData);
+      table.Add(FileName(id), fData);
     }
+  };
+
+  for (size_t i = 0; i + 1 < item.numFiles; i++) {
+    AddFile(i, item.data[i], item.data[i + 1]);
   }
 
-  char *begin = item.data[item.numFiles - 1];
-  char *end = reinterpret_cast<char *>(&item) + endPos;
-  std::string_view fData{begin, end};
-  if (!fData.empty()) {
-    FileName(item.numFiles - 1);
-    ectx->SendData(fData);
+  if (item.numFiles) {
+    AddFile(item.numFiles - 1, item.data[item.numFiles - 1],
+            reinterpret_cast<char *>(&item) + endPos);
   }
 }
 
-void ExtractData(DASHeader &hdr, AppExtractContext *ectx, std::string curPath);
+void ExtractData(DASHeader &hdr, ExtractTable &table, std::string curPath);
 
-void ExtractData(DASEntry &item, AppExtractContext *ectx, std::string curPath) {
+void ExtractData(DASEntry &item, ExtractTable &table, std::string curPath) {
   if (item.type == DASEntryType::Child) {
     DASHeader *child = reinterpret_cast<DASHeader *>(item.data.Get());
-    ExtractData(*child, ectx, curPath);
+    ExtractData(*child, table, curPath);
   } else if (item.type == DASEntryType::FileTable) {
     DAT *dat = reinterpret_cast<DAT *>(item.data.Get());
-    ExtractData(*dat, item.size, ectx, curPath);
+    ExtractData(*dat, item.size, table, curPath);
   } else if (item.size) {
-    ectx->NewFile(curPath);
-    ectx->SendData({item.data.Get(), item.size});
+    table.Add(curPath, {item.data.Get(), item.size});
   }
 }
 
-void ExtractData(DASHeader &hdr, AppExtractContext *ectx, std::string curPath) {
+void ExtractData(DASHeader &hdr, ExtractTable &table, std::string curPath) {
   DASEntry *curEntry = hdr.entries;
   size_t curItem = 0;
 
   while (curEntry->type != DASEntryType::End) {
-    ExtractData(*curEntry, ectx, curPath + "_" + std::to_string(curItem));
+    ExtractData(*curEntry, table, curPath + "_" + std::to_string(curItem));
     curEntry++;
     curItem++;
   }
 }
 
 void AppProcessFile(AppContext *ctx) {
+  revil::TraceZone zone("app.udas_extract");
   std::string buffer;
   uint32 id;
   ctx->GetType(id);
 
   if (id == LFSHeader::ID) {
-    BinReaderRef rd(ctx->GetStream());
-    LFSHeader hdr;
-    std::vector<LFSChunk> chunks;
-    rd.Read(hdr);
-    rd.ReadContainer(chunks);
-    char inBuffer[0x10000];
-    char outBuffer[0x10000];
-    std::stringstream backup;
-
-    for (auto &c : chunks) {
-      rd.Seek(c.offset + sizeof(hdr) + 3);
-      rd.ReadBuffer(inBuffer, c.compressedSize);
-      uint32 uncompressedSize =
-          c.uncompressedSize ? c.uncompressedSize : sizeof(outBuffer);
-      DecompressLZX(inBuffer, c.compressedSize, outBuffer, uncompressedSize);
-      backup.write(outBuffer, uncompressedSize);
+    const std::string input = ctx->GetBuffer();
+    std::string_view inView(input);
+
+    if (inView.size() < sizeof(LFSHeader) + sizeof(uint32)) {
+      throw es::RuntimeError("Truncated LFS header");
     }
 
-    buffer = std::move(backup).str();
+    const uint32 numChunks =
+        *reinterpret_cast<const uint32 *>(inView.data() + sizeof(LFSHeader));
+    const size_t chunksBegin = sizeof(LFSHeader) + sizeof(uint32);
+
+    if (numChunks > (inView.size() - chunksBegin) / sizeof(LFSChunk)) {
+      throw es::RuntimeError("Truncated LFS chunk table");
+    }
+
+    const LFSChunk *chunks =
+        reinterpret_cast<const LFSChunk *>(inView.data() + chunksBegin);
+    // Chunks are independent streams, decompress them in place of output
+    std::vector<size_t> outOffsets(numChunks + 1);
+
+    for (uint32 c = 0; c < numChunks; c++) {
+      const uint32 uncompressedSize =
+          chunks[c].uncompressedSize ? chunks[c].uncompressedSize : 0x10000;
+      outOffsets[c + 1] = outOffsets[c] + uncompressedSize;
+    }
+
+    buffer.resize(outOffsets.back());
+
+    revil::ParallelFor(numChunks, [&](size_t c) {
+      const size_t offset = chunks[c].offset + sizeof(LFSHeader) + 3;
+
+      if (offset > inView.size() ||
+          chunks[c].compressedSize > inView.size() - offset) {
+        throw es::RuntimeError("LFS chunk is out of file bounds");
+      }
+
+      revil::DecompressLZX(
+          inView.substr(offset, chunks[c].compressedSize),
+          {buffer.data() + outOffsets[c], outOffsets[c + 1] - outOffsets[c]});
+    });
+
     ctx->workingFile = ctx->workingFile.GetFullPathNoExt();
   } else {
     throw es::InvalidHeaderError(id);
   }
 
   DASHeader *hdr = reinterpret_cast<DASHeader *>(buffer.data());
-  ProcessClass(*hdr);
-  auto ectx = ctx->ExtractContext();
-  ExtractData(*hdr, ectx, std::string(ctx->workingFile.GetFilename()));
+  revil::FixupTracker ptrStore(buffer);
+  ptrStore.Insert(hdr);
+  ProcessClass(*hdr, ptrStore);
+  ExtractTable table{buffer.data()};
+  ExtractData(*hdr, table, std::string(ctx->workingFile.GetFilename()));
+  revil::ExtractContainer(buffer, table.entries, ctx->ExtractContext());
 }
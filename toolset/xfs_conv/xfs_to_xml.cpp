@@ -41,6 +41,7 @@ static AppInfo_s appInfo{
 AppInfo_s *AppInitModule() { return &appInfo; }
 
 void AppProcessFile(AppContext *ctx) {
+  TraceZone zone("app.xfs_to_xml");
   XFS xfs;
 
   try {